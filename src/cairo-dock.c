@@ -60,7 +60,11 @@
 #include "cairo-dock-module-manager.h"  // gldi_modules_new_from_directory
 #include "cairo-dock-module-instance-manager.h"  // GldiModuleInstance
 #include "cairo-dock-dock-manager.h"
-#include "cairo-dock-desklet-manager.h"
+#include "cairo-dock-backends-manager.h"  // cairo_dock_benchmark_renderers
+#include "cairo-dock-animations.h"  // cairo_dock_step_animation
+#include "cairo-dock-container.h"  // gldi_container_snapshot
+#include "cairo-dock-desklet-manager.h"  // gldi_desklets_check_picking
+#include "cairo-dock-user-icon-manager.h"  // gldi_user_icons_get_loading_stats
 #include "cairo-dock-themes-manager.h"
 #include "cairo-dock-dialog-factory.h"
 #include "cairo-dock-keyfile-utilities.h"
@@ -85,6 +89,7 @@
 #define CAIRO_DOCK_CURRENT_THEME_NAME "current_theme"
 // Nom du repertoire des themes extras.
 #define CAIRO_DOCK_EXTRAS_DIR "extras"
+#define CAIRO_DOCK_SNAPSHOT_MAX_STEPS 1000  // some animations never stop (clocks, etc), so don't step them forever.
 
 extern gchar *g_cCairoDockDataDir;
 extern gchar *g_cCurrentThemePath;
@@ -113,6 +118,8 @@ static gint s_iLastYear = 0;
 static gint s_iNbCrashes = 0;
 static gboolean s_bPingServer = TRUE;
 static gboolean s_bCDSessionLaunched = FALSE; // session CD already launched?
+static gint64 s_iLaunchTime = 0;  // to measure the time to the first frame.
+static gboolean s_bFirstFrameDrawn = FALSE;
 
 
 static void _on_got_server_answer (const gchar *data, G_GNUC_UNUSED gpointer user_data)
@@ -160,6 +167,63 @@ static gboolean _cairo_dock_successful_launch (gpointer data)
 	
 	return FALSE;
 }
+static gboolean _cairo_dock_run_benchmark (gpointer data)
+{
+	cairo_dock_benchmark_renderers (GPOINTER_TO_INT (data));
+	gtk_main_quit ();
+	return FALSE;
+}
+static gboolean _cairo_dock_run_search_benchmark (gpointer data)
+{
+	cairo_dock_benchmark_icon_searches (GPOINTER_TO_INT (data));
+	gtk_main_quit ();
+	return FALSE;
+}
+static gboolean _cairo_dock_quit (G_GNUC_UNUSED gpointer data)
+{
+	gtk_main_quit ();
+	return FALSE;
+}
+static gboolean _cairo_dock_on_first_frame (G_GNUC_UNUSED gpointer data, CairoDock *pDock, G_GNUC_UNUSED cairo_t *pCairoContext)
+{
+	if (pDock != g_pMainDock || s_bFirstFrameDrawn)
+		return GLDI_NOTIFICATION_LET_PASS;
+	s_bFirstFrameDrawn = TRUE;
+	
+	guint iNbLaunchers;
+	int iNbThreads;
+	double fLoadingTime;
+	gldi_user_icons_get_loading_stats (&iNbLaunchers, &iNbThreads, &fLoadingTime);
+	g_print ("{\"launchers\":%u,\"threads\":%d,\"launchers_ms\":%.1f,\"first_frame_ms\":%.1f}\n",
+		iNbLaunchers,
+		iNbThreads,
+		fLoadingTime,
+		(g_get_monotonic_time () - s_iLaunchTime) / 1e3);
+	g_idle_add (_cairo_dock_quit, NULL);  // not while the dock is being drawn.
+	return GLDI_NOTIFICATION_LET_PASS;
+}
+static gboolean _cairo_dock_check_picking (gint *iResult)
+{
+	*iResult = (gldi_desklets_check_picking () == 0 ? 0 : 1);
+	gtk_main_quit ();
+	return FALSE;
+}
+static gboolean _cairo_dock_take_snapshot (gchar *cSnapshotPath)
+{
+	// run the animations of the main dock until they end, without waiting between the steps, so that the image doesn't depend on the speed of the machine.
+	int i = 0;
+	while (i < CAIRO_DOCK_SNAPSHOT_MAX_STEPS && cairo_dock_step_animation (CAIRO_CONTAINER (g_pMainDock)))
+		i ++;
+	
+	cairo_surface_t *pSurface = gldi_container_snapshot (CAIRO_CONTAINER (g_pMainDock));
+	if (cairo_surface_write_to_png (pSurface, cSnapshotPath) != CAIRO_STATUS_SUCCESS)
+		cd_warning ("couldn't write the snapshot into '%s'", cSnapshotPath);
+	cairo_surface_destroy (pSurface);
+	
+	g_free (cSnapshotPath);
+	gtk_main_quit ();
+	return FALSE;
+}
 static gboolean _cairo_dock_first_launch_setup (G_GNUC_UNUSED gpointer data)
 {
 	cairo_dock_launch_command (CAIRO_DOCK_SHARE_DATA_DIR"/scripts/initial-setup.sh");
@@ -279,8 +343,11 @@ static void _cairo_dock_get_global_config (const gchar *cCairoDockDataDir)
 
 int main (int argc, char** argv)
 {
+	s_iLaunchTime = g_get_monotonic_time ();
+	
 	//\___________________ build the command line used to respawn, and check if we have been launched from another life.
 	s_pLaunchCommand = g_string_new (argv[0]);
+	gboolean bHeadless = FALSE;
 	int i;
 	for (i = 1; i < argc; i ++)
 	{
@@ -302,6 +369,8 @@ int main (int argc, char** argv)
 		}
 		else  // keep this option in the command line.
 		{
+			if (strcmp (argv[i], "--headless") == 0 || strcmp (argv[i], "-H") == 0)  // this option must be known before GTK is initialized.
+				bHeadless = TRUE;
 			g_string_append_printf (s_pLaunchCommand, " %s", argv[i]);
 		}
 	}
@@ -330,7 +399,22 @@ int main (int argc, char** argv)
 
 	dbus_g_thread_init (); // it's a wrapper: it will use dbus_threads_init_default ();
 	
-	gtk_init (&argc, &argv);
+	if (bHeadless)  // draw the windows into memory with the Broadway backend of GDK, instead of on a display.
+	{
+		#if GTK_CHECK_VERSION (3, 10, 0) && defined (GDK_WINDOWING_BROADWAY)
+		gdk_set_allowed_backends ("broadway");
+		if (! gtk_init_check (&argc, &argv))
+		{
+			g_print ("Couldn't connect to a Broadway server; launch one with 'broadwayd :<n>', and set BROADWAY_DISPLAY=:<n>\n");
+			return 1;
+		}
+		#else
+		g_print ("The headless mode needs GTK 3.10 or later, built with its Broadway backend\n");
+		return 1;
+		#endif
+	}
+	else
+		gtk_init (&argc, &argv);
 	
 	GError *erreur = NULL;
 	
@@ -340,9 +424,9 @@ int main (int argc, char** argv)
 	textdomain (CAIRO_DOCK_GETTEXT_PACKAGE);
 	
 	//\___________________ get app's options.
-	gboolean bSafeMode = FALSE, bMaintenance = FALSE, bNoSticky = FALSE, bCappuccino = FALSE, bPrintVersion = FALSE, bTesting = FALSE, bForceOpenGL = FALSE, bToggleIndirectRendering = FALSE, bKeepAbove = FALSE, bForceColors = FALSE, bAskBackend = FALSE, bMetacityWorkaround = FALSE;
-	gchar *cEnvironment = NULL, *cUserDefinedDataDir = NULL, *cVerbosity = 0, *cUserDefinedModuleDir = NULL, *cExcludeModule = NULL, *cThemeServerAdress = NULL;
-	int iDelay = 0;
+	gboolean bSafeMode = FALSE, bMaintenance = FALSE, bNoSticky = FALSE, bCappuccino = FALSE, bPrintVersion = FALSE, bTesting = FALSE, bForceOpenGL = FALSE, bToggleIndirectRendering = FALSE, bKeepAbove = FALSE, bForceColors = FALSE, bJsonLog = FALSE, bAskBackend = FALSE, bMetacityWorkaround = FALSE, bCheckPicking = FALSE;
+	gchar *cEnvironment = NULL, *cUserDefinedDataDir = NULL, *cVerbosity = 0, *cUserDefinedModuleDir = NULL, *cExcludeModule = NULL, *cThemeServerAdress = NULL, *cSnapshotPath = NULL;
+	int iDelay = 0, iBenchmarkNbIcons = 0, iBenchmarkSearchNbIcons = 0, iFirstFrameNbThreads = 0, iExitStatus = 0;
 	GOptionEntry pOptionsTable[] =
 	{
 		// GLDI options: cairo, opengl, indirect-opengl, env, keep-above, no-sticky
@@ -388,6 +472,9 @@ int main (int argc, char** argv)
 		{"colors", 'F', G_OPTION_FLAG_IN_MAIN, G_OPTION_ARG_NONE,
 			&bForceColors,
 			_("Force to display some output messages with colors."), NULL},
+		{"log-json", 'J', G_OPTION_FLAG_IN_MAIN, G_OPTION_ARG_NONE,
+			&bJsonLog,
+			_("Write log messages as JSON objects (one per line, with timestamps and thread IDs), for automatic analysis."), NULL},
 		{"version", 'v', G_OPTION_FLAG_IN_MAIN, G_OPTION_ARG_NONE,
 			&bPrintVersion,
 			_("Print version and quit."), NULL},
@@ -413,6 +500,24 @@ int main (int argc, char** argv)
 		{"easter-eggs", 'E', G_OPTION_FLAG_IN_MAIN, G_OPTION_ARG_NONE,
 			&g_bEasterEggs,
 			_("For debugging purpose only. Some hidden and still unstable options will be activated."), NULL},
+		{"headless", 'H', G_OPTION_FLAG_IN_MAIN, G_OPTION_ARG_NONE,
+			&bHeadless,
+			_("For debugging purpose only. Run without any display: the windows are drawn into memory by a Broadway server (broadwayd, from GTK), with Cairo. It's meant to take the measurements and the snapshots below on a machine without display nor GPU."), NULL},
+		{"benchmark-views", 'B', G_OPTION_FLAG_IN_MAIN, G_OPTION_ARG_INT,
+			&iBenchmarkNbIcons,
+			_("For debugging purpose only. Measure the performances of all the views on a dock with this number of icons, write the results as JSON objects (one per frame) and quit. Cairo is always measured, and OpenGL too with -o, side by side."), NULL},
+		{"benchmark-searches", 'I', G_OPTION_FLAG_IN_MAIN, G_OPTION_ARG_INT,
+			&iBenchmarkSearchNbIcons,
+			_("For debugging purpose only. Measure the searches of icons by name, URI and sub-dock in a dock with this number of icons (e.g. 500), with and without its index, write the results as JSON objects and quit."), NULL},
+		{"time-to-first-frame", 'L', G_OPTION_FLAG_IN_MAIN, G_OPTION_ARG_INT,
+			&iFirstFrameNbThreads,
+			_("For debugging purpose only. Load the launchers with at most this number of threads (1 to load them in the main thread only), measure the time from the launch to the first frame of the main dock, write it as a JSON object and quit."), NULL},
+		{"snapshot", 'P', G_OPTION_FLAG_IN_MAIN, G_OPTION_ARG_STRING,
+			&cSnapshotPath,
+			_("For debugging purpose only. Draw the main dock offscreen once it is loaded and its animations are over, save it into this PNG file and quit."), NULL},
+		{"check-picking", 'K', G_OPTION_FLAG_IN_MAIN, G_OPTION_ARG_NONE,
+			&bCheckPicking,
+			_("For debugging purpose only. Compare the picking of the icons of an OpenGL desklet with the GL_SELECT one, write the result as a JSON object and quit (the exit status is 1 if they disagree). Needs -o."), NULL},
 		{NULL, 0, 0, 0,
 			NULL,
 			NULL, NULL}
@@ -433,6 +538,17 @@ int main (int argc, char** argv)
 		return 0;
 	}
 	
+	if (iBenchmarkNbIcons > 0 || iBenchmarkSearchNbIcons > 0 || iFirstFrameNbThreads > 0 || cSnapshotPath != NULL || bCheckPicking)  // only take some measurements, don't relaunch the dock if it crashes.
+		bTesting = TRUE;
+	
+	if (bHeadless && bForceOpenGL)
+	{
+		cd_warning ("OpenGL is not available without a display, Cairo will be used.");
+		bForceOpenGL = FALSE;
+	}
+	if (bHeadless)
+		g_bForceCairo = TRUE;
+	
 	if (g_bLocked)
 		cd_warning ("Cairo-Dock will be locked.");
 	
@@ -445,6 +561,9 @@ int main (int argc, char** argv)
 	if (bForceColors)
 		cd_log_force_use_color ();
 	
+	if (bJsonLog)
+		cd_log_set_json_output (TRUE);
+	
 	CairoDockDesktopEnv iDesktopEnv = CAIRO_DOCK_UNKNOWN_ENV;
 	if (cEnvironment != NULL)
 	{
@@ -818,6 +937,14 @@ int main (int argc, char** argv)
 			G_TYPE_INVALID);
 		g_free (cConfFilePath);
 	}
+	if (iFirstFrameNbThreads > 0)
+	{
+		gldi_user_icons_set_max_loading_threads (iFirstFrameNbThreads);
+		gldi_object_register_notification (&myDockObjectMgr,
+			NOTIFICATION_RENDER,
+			(GldiNotificationFunc) _cairo_dock_on_first_frame,
+			GLDI_RUN_AFTER, NULL);
+	}
 	cairo_dock_load_current_theme ();
 	
 	//\___________________ lock mode.
@@ -915,6 +1042,15 @@ int main (int argc, char** argv)
 	
 	if (! bTesting)
 		g_timeout_add_seconds (5, _cairo_dock_successful_launch, GINT_TO_POINTER (bFirstLaunch));
+	
+	if (iBenchmarkNbIcons > 0)
+		g_idle_add (_cairo_dock_run_benchmark, GINT_TO_POINTER (iBenchmarkNbIcons));
+	else if (iBenchmarkSearchNbIcons > 0)
+		g_idle_add (_cairo_dock_run_search_benchmark, GINT_TO_POINTER (iBenchmarkSearchNbIcons));
+	else if (cSnapshotPath != NULL)
+		g_idle_add_full (G_PRIORITY_LOW, (GSourceFunc)_cairo_dock_take_snapshot, cSnapshotPath, NULL);  // low priority, so that the icons (loaded on idle) are ready.
+	else if (bCheckPicking)
+		g_idle_add ((GSourceFunc)_cairo_dock_check_picking, &iExitStatus);
 
 	// Start Mainloop
 	gtk_main ();
@@ -937,5 +1073,5 @@ int main (int argc, char** argv)
 	cd_message ("Bye bye !");
 	g_print ("\033[0m\n");
 
-	return 0;
+	return iExitStatus;
 }
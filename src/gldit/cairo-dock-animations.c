@@ -146,6 +146,18 @@ void cairo_dock_launch_animation (GldiContainer *pContainer)
 	}
 }
 
+gboolean cairo_dock_step_animation (GldiContainer *pContainer)
+{
+	guint iSidAnimation = pContainer->iSidGLAnimation;
+	if (iSidAnimation == 0)
+		return FALSE;
+	
+	gboolean bContinue = pContainer->iface.animation_loop (pContainer);
+	if (! bContinue && g_main_context_find_source_by_id (NULL, iSidAnimation) != NULL)  // the loop has stopped, but its timer is still there since it's not the timer that called it.
+		g_source_remove (iSidAnimation);
+	return bContinue;
+}
+
 void cairo_dock_start_shrinking (CairoDock *pDock)
 {
 	if (! pDock->bIsShrinkingDown)  // on lance l'animation.
@@ -187,6 +199,7 @@ void cairo_dock_start_hiding (CairoDock *pDock)
 		}
 		
 		// init the animation
+		pDock->bRedirectedImageIsValid = FALSE;  // the dock may have changed since the last transition.
 		if (g_pHidingBackend != NULL && g_pHidingBackend->init)
 			g_pHidingBackend->init (pDock);
 		
@@ -226,6 +239,7 @@ void cairo_dock_start_showing (CairoDock *pDock)
 		}
 		
 		// init the animation
+		pDock->bRedirectedImageIsValid = FALSE;  // the dock may have changed since the last transition.
 		if (g_pHidingBackend != NULL && g_pHidingBackend->init)
 			g_pHidingBackend->init (pDock);
 		
@@ -115,6 +115,12 @@ gfloat cairo_dock_calculate_magnitude (gint iMagnitudeIndex);
 */
 void cairo_dock_launch_animation (GldiContainer *pContainer);
 
+/** Run one step of the animation of a Container now, rather than when its timer expires. The steps only depend on the animation delta-t, not on the actual time, so running them in a row, without going back to the main loop, always gives the same frames (useful for benchmarks and snapshots).
+*@param pContainer the container to animate.
+*@return TRUE if the animation goes on, FALSE if it has stopped or wasn't running.
+*/
+gboolean cairo_dock_step_animation (GldiContainer *pContainer);
+
 void cairo_dock_start_shrinking (CairoDock *pDock);
 
 void cairo_dock_start_growing (CairoDock *pDock);
@@ -335,6 +335,7 @@ void cairo_dock_insert_icons_in_applet (GldiModuleInstance *pInstance, GList *pI
 			if (cairo_dock_check_unique_subdock_name (pIcon))
 				gldi_icon_set_name (pIcon, pIcon->cName);
 			pIcon->pSubDock = gldi_subdock_new (pIcon->cName, cDockRenderer, pInstance->pDock, pIconsList);
+			cairo_dock_reindex_icon (pIcon);
 			if (pIcon->pSubDock)
 				pIcon->pSubDock->bPreventDraggingIcons = TRUE;  // par defaut pour toutes les applets on empeche de pouvoir deplacer/supprimer les icones a la souris.
 		}
@@ -386,6 +387,7 @@ void cairo_dock_insert_icon_in_applet (GldiModuleInstance *pInstance, Icon *pOne
 			if (cairo_dock_check_unique_subdock_name (pIcon))
 				gldi_icon_set_name (pIcon, pIcon->cName);
 			pIcon->pSubDock = gldi_subdock_new (pIcon->cName, NULL, pInstance->pDock, NULL);
+			cairo_dock_reindex_icon (pIcon);
 			if (pIcon->pSubDock)
 				pIcon->pSubDock->bPreventDraggingIcons = TRUE;  // par defaut pour toutes les applets on empeche de pouvoir deplacer/supprimer les icones a la souris.
 		}
@@ -449,6 +451,7 @@ void cairo_dock_remove_all_icons_from_applet (GldiModuleInstance *pInstance)
 			cd_debug (" destroy sub-dock");
 			gldi_object_unref (GLDI_OBJECT(pIcon->pSubDock));
 			pIcon->pSubDock = NULL;
+			cairo_dock_reindex_icon (pIcon);
 		}
 	}
 }
@@ -223,6 +223,7 @@ static CairoDock *_get_parent_dock_for_appli (Icon *icon, CairoDock *pMainDock)
 							gldi_icon_set_name (pSameClassIcon, pSameClassIcon->cInitialName);  // on lui remet son nom de lanceur.
 						
 						pSameClassIcon->pSubDock = pParentDock;
+						cairo_dock_reindex_icon (pSameClassIcon);
 						
 						cairo_dock_redraw_icon (pSameClassIcon);  // on la redessine car elle prend l'indicateur de classe.
 					}
@@ -506,7 +506,9 @@ void cairo_dock_start_applications_manager (CairoDock *pDock)
 	cairo_dock_set_group_exceptions (myTaskbarParam.cGroupException);
 	
 	// create an appli-icon for each window.
+	cairo_dock_begin_resize_transaction ();
 	gldi_windows_foreach (FALSE, (GFunc)_create_appli_icon, pDock);  // ordered by creation date; this allows us to set the correct age to the icon, which is constant. On the next updates, the z-order (which is dynamic) will be set.
+	cairo_dock_commit_resize_transaction ();
 	
 	s_bAppliManagerIsRunning = TRUE;
 }
@@ -694,13 +696,14 @@ static void _load_appli (Icon *icon)
 	// in other cases (or if the preview couldn't be used)
 	if (icon->image.iTexture == 0 && icon->image.pSurface == NULL)
 	{
-		cairo_surface_t *pSurface = NULL;
-		// or use the class icon
-		if (myTaskbarParam.bOverWriteXIcons && ! cairo_dock_class_is_using_xicon (icon->cClass))
-			pSurface = cairo_dock_create_surface_from_class (icon->cClass, iWidth, iHeight);
+		// or use the class icon (its buffer is shared by the applis of the class)
+		if (myTaskbarParam.bOverWriteXIcons && icon->cClass != NULL && ! cairo_dock_class_is_using_xicon (icon->cClass))
+			cairo_dock_load_image_buffer_from_class (&icon->image, icon->cClass, iWidth, iHeight);
+	}
+	if (icon->image.iTexture == 0 && icon->image.pSurface == NULL)
+	{
 		// or use the X icon
-		if (pSurface == NULL)
-			pSurface = gldi_window_get_icon_surface (icon->pAppli, iWidth, iHeight);
+		cairo_surface_t *pSurface = gldi_window_get_icon_surface (icon->pAppli, iWidth, iHeight);
 		// or use a default image
 		if (pSurface == NULL)  // some applis like xterm don't define any icon, set the default one.
 		{
@@ -17,6 +17,7 @@
 * along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -24,6 +25,9 @@
 #include "cairo-dock-icon-factory.h"
 #include "cairo-dock-keyfile-utilities.h"
 #include "cairo-dock-dock-factory.h"
+#include "cairo-dock-dock-facility.h"  // cairo_dock_update_dock_size
+#include "cairo-dock-draw-opengl.h"
+#include "cairo-dock-opengl.h"
 #include "cairo-dock-log.h"
 #include "cairo-dock-animations.h"
 #include "cairo-dock-dialog-manager.h"
@@ -39,6 +43,7 @@ CairoBackendsParam myBackendsParam;
 
 // dependancies
 extern gboolean g_bUseOpenGL;
+extern CairoDock *g_pMainDock;
 
 // private
 static GHashTable *s_hRendererTable = NULL;  // table des rendus de dock.
@@ -474,6 +479,181 @@ void cairo_dock_foreach_animation (GHFunc pHFunction, gpointer data)
 }
 
 
+  /////////////////
+ /// BENCHMARK ///
+/////////////////
+
+#define CD_BENCHMARK_NB_FRAMES 100  // number of mouse positions swept along the dock, for each view.
+
+static void _list_renderer_name (const gchar *cRendererName, G_GNUC_UNUSED CairoDockRenderer *pRenderer, GList **pNames)
+{
+	*pNames = g_list_prepend (*pNames, (gpointer)cRendererName);
+}
+
+static gboolean _redirect_dock_to_fbo (CairoDock *pDock)
+{
+	if (pDock->iRedirectedTexture != 0)  // its size depends on the view.
+	{
+		_cairo_dock_delete_texture (pDock->iRedirectedTexture);
+		pDock->iRedirectedTexture = 0;
+	}
+	cairo_dock_create_redirect_texture_for_dock (pDock);
+	if (pDock->iFboId == 0 || pDock->iRedirectedTexture == 0)
+		return FALSE;
+	
+	glBindFramebufferEXT (GL_FRAMEBUFFER_EXT, pDock->iFboId);
+	glFramebufferTexture2DEXT (GL_FRAMEBUFFER_EXT,
+		GL_COLOR_ATTACHMENT0_EXT,
+		GL_TEXTURE_2D,
+		pDock->iRedirectedTexture,
+		0);
+	if (glCheckFramebufferStatusEXT (GL_FRAMEBUFFER_EXT) != GL_FRAMEBUFFER_COMPLETE_EXT)
+	{
+		glBindFramebufferEXT (GL_FRAMEBUFFER_EXT, 0);
+		return FALSE;
+	}
+	gldi_gl_container_set_ortho_view (CAIRO_CONTAINER (pDock));
+	return TRUE;
+}
+
+static void _benchmark_frame (CairoDock *pDock, cairo_t *pCairoContext, gint64 *iLayoutTime, gint64 *iDrawTime)  // in OpenGL if pCairoContext is NULL.
+{
+	if (pCairoContext)
+	{
+		cairo_save (pCairoContext);
+		cairo_set_operator (pCairoContext, CAIRO_OPERATOR_CLEAR);
+		cairo_paint (pCairoContext);
+		cairo_restore (pCairoContext);
+	}
+	else
+	{
+		glClear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		glFinish ();
+	}
+	
+	gint64 t0 = g_get_monotonic_time ();
+	pDock->pRenderer->calculate_icons (pDock);
+	gint64 t1 = g_get_monotonic_time ();
+	if (pCairoContext)
+	{
+		cairo_save (pCairoContext);
+		pDock->pRenderer->render (pCairoContext, pDock);
+		cairo_restore (pCairoContext);
+		cairo_surface_flush (cairo_get_target (pCairoContext));
+	}
+	else
+	{
+		glLoadIdentity ();
+		pDock->pRenderer->render_opengl (pDock);
+		glFinish ();  // wait for the GPU to be done, otherwise we'd only measure the time to queue the commands.
+	}
+	gint64 t2 = g_get_monotonic_time ();
+	*iLayoutTime = t1 - t0;
+	*iDrawTime = t2 - t1;
+}
+
+static void _benchmark_renderer (CairoDock *pDock, const gchar *cRendererName, int iNbIcons, gboolean bOpenGL)
+{
+	//\_______________ set the view and the size of the dock for it.
+	cairo_dock_set_renderer (pDock, cRendererName);
+	cairo_dock_update_dock_size (pDock);
+	pDock->container.iWidth = pDock->iMaxDockWidth;  // the window is never shown, so set its size directly.
+	pDock->container.iHeight = pDock->iMaxDockHeight;
+	pDock->container.bInside = TRUE;
+	pDock->iMagnitudeIndex = CAIRO_DOCK_NB_MAX_ITERATIONS;  // fully zoomed, as when the mouse is inside.
+	pDock->container.iMouseY = (pDock->container.bDirectionUp ? pDock->container.iHeight - pDock->iMinDockHeight / 2 : pDock->iMinDockHeight / 2);
+	int iWidth = (pDock->container.bIsHorizontal ? pDock->container.iWidth : pDock->container.iHeight);
+	int iHeight = (pDock->container.bIsHorizontal ? pDock->container.iHeight : pDock->container.iWidth);
+	
+	//\_______________ get an offscreen target for each backend; the icons keep their surfaces in OpenGL, so the cairo rendering is always possible.
+	cairo_surface_t *pSurface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, iWidth, iHeight);
+	cairo_t *pCairoContext = cairo_create (pSurface);
+	if (bOpenGL && (pDock->pRenderer->render_opengl == NULL || ! _redirect_dock_to_fbo (pDock)))
+	{
+		cd_warning ("can't benchmark the view '%s' in OpenGL", cRendererName);
+		bOpenGL = FALSE;
+	}
+	
+	//\_______________ sweep the mouse along the dock, and time the layout and the drawing of each frame with both backends.
+	gint64 iCairoLayoutTime, iCairoDrawTime, iGLLayoutTime = 0, iGLDrawTime = 0;
+	gchar *cOpenGLResult;
+	int i;
+	for (i = 0; i < CD_BENCHMARK_NB_FRAMES; i ++)
+	{
+		pDock->container.iMouseX = i * pDock->container.iWidth / (CD_BENCHMARK_NB_FRAMES - 1);
+		
+		_benchmark_frame (pDock, pCairoContext, &iCairoLayoutTime, &iCairoDrawTime);
+		if (bOpenGL)
+		{
+			_benchmark_frame (pDock, NULL, &iGLLayoutTime, &iGLDrawTime);
+			cOpenGLResult = g_strdup_printf ("{\"layout_us\":%" G_GINT64_FORMAT ",\"draw_us\":%" G_GINT64_FORMAT "}", iGLLayoutTime, iGLDrawTime);
+		}
+		else
+			cOpenGLResult = g_strdup ("null");
+		
+		fprintf (stdout, "{\"renderer\":\"%s\",\"icons\":%d,\"width\":%d,\"height\":%d,\"frame\":%d,\"mouse_x\":%d,\"cairo\":{\"layout_us\":%" G_GINT64_FORMAT ",\"draw_us\":%" G_GINT64_FORMAT "},\"opengl\":%s}\n",
+			cRendererName,
+			iNbIcons,
+			iWidth, iHeight,
+			i,
+			pDock->container.iMouseX,
+			iCairoLayoutTime,
+			iCairoDrawTime,
+			cOpenGLResult);
+		g_free (cOpenGLResult);
+	}
+	fflush (stdout);
+	
+	cairo_destroy (pCairoContext);
+	cairo_surface_destroy (pSurface);
+	if (bOpenGL)
+		glBindFramebufferEXT (GL_FRAMEBUFFER_EXT, 0);
+}
+
+void cairo_dock_benchmark_renderers (int iNbIcons)
+{
+	g_return_if_fail (iNbIcons > 0 && g_pMainDock != NULL);
+	
+	//\_______________ make a dock with some dummy icons; it's a sub-dock, so that it's never shown.
+	GList *pIconList = NULL;
+	int i;
+	for (i = 0; i < iNbIcons; i ++)
+	{
+		pIconList = g_list_prepend (pIconList, cairo_dock_create_dummy_launcher (g_strdup_printf ("icon %d", i), NULL, NULL, NULL, i));
+	}
+	pIconList = g_list_reverse (pIconList);
+	CairoDock *pDock = gldi_subdock_new (CD_BENCHMARK_DOCK_NAME, NULL, g_pMainDock, pIconList);
+	g_return_if_fail (pDock != NULL);
+	
+	GList *ic;
+	for (ic = pDock->icons; ic != NULL; ic = ic->next)
+	{
+		cairo_dock_load_icon_buffers (ic->data, CAIRO_CONTAINER (pDock));  // load them now rather than on idle.
+	}
+	
+	gboolean bOpenGL = FALSE;  // cairo is always measured, OpenGL only if it's available.
+	if (g_bUseOpenGL)
+	{
+		gtk_widget_realize (pDock->container.pWidget);  // we need an X window for the GL context, but we draw into the FBO.
+		bOpenGL = gldi_gl_container_make_current (CAIRO_CONTAINER (pDock));
+		if (! bOpenGL)
+			cd_warning ("couldn't get an OpenGL context to benchmark the views, only Cairo will be measured");
+	}
+	
+	//\_______________ run each view on it.
+	GList *pNames = NULL;
+	cairo_dock_foreach_dock_renderer ((GHFunc)_list_renderer_name, &pNames);
+	GList *n;
+	for (n = pNames; n != NULL; n = n->next)
+	{
+		_benchmark_renderer (pDock, n->data, iNbIcons, bOpenGL);
+	}
+	g_list_free (pNames);
+	
+	gldi_object_unref (GLDI_OBJECT (pDock));
+}
+
+
   //////////////////
  /// GET CONFIG ///
 //////////////////
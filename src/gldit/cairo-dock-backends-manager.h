@@ -118,6 +118,12 @@ void cairo_dock_foreach_desklet_decoration (GHFunc pFunction, gpointer data);
 void cairo_dock_foreach_dialog_decorator (GHFunc pFunction, gpointer data);
 void cairo_dock_foreach_animation (GHFunc pFunction, gpointer data);
 
+#define CD_BENCHMARK_DOCK_NAME "_Benchmark_"
+/** Measure the performances of all the views of the docks. Each view is run on a hidden dock with some dummy icons, while the mouse sweeps along it, and draws into an offscreen buffer with both backends: Cairo always, and OpenGL too if it's in use. For each frame, a JSON object is written on the standard output, with the time spent to compute the layout of the icons and to draw the dock for each backend side by side ("opengl" is null if it couldn't be measured).
+*@param iNbIcons number of icons in the dock.
+*/
+void cairo_dock_benchmark_renderers (int iNbIcons);
+
 
 void cairo_dock_update_renderer_list_for_gui (void);
 void cairo_dock_update_desklet_decorations_list_for_gui (void);
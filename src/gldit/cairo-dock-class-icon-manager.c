@@ -19,7 +19,7 @@
 
 #include "cairo-dock-surface-factory.h"
 #include "cairo-dock-log.h"
-#include "cairo-dock-class-manager.h"  // cairo_dock_create_surface_from_class
+#include "cairo-dock-class-manager.h"  // cairo_dock_load_image_buffer_from_class
 #include "cairo-dock-indicator-manager.h"  // myIndicatorsParam.bUseClassIndic
 #include "cairo-dock-class-icon-manager.h"
 
@@ -43,22 +43,22 @@ static void _load_image (Icon *icon)
 	else
 	{
 		cd_debug ("%s (%dx%d)", __func__, iWidth, iHeight);
-		pSurface = cairo_dock_create_surface_from_class (icon->cClass,
+		if (cairo_dock_load_image_buffer_from_class (&icon->image, icon->cClass,
 			iWidth,
-			iHeight);  /// could make a gldi_image_buffer_load_from_class...
-		if (pSurface == NULL)  // aucun inhibiteur ou aucune image correspondant a cette classe, on cherche a copier une des icones d'appli de cette classe.
+			iHeight))  // shared with the applis of the class.
+			return;
+		
+		// aucun inhibiteur ou aucune image correspondant a cette classe, on cherche a copier une des icones d'appli de cette classe.
+		const GList *pApplis = cairo_dock_list_existing_appli_with_class (icon->cClass);
+		if (pApplis != NULL)
 		{
-			const GList *pApplis = cairo_dock_list_existing_appli_with_class (icon->cClass);
-			if (pApplis != NULL)
-			{
-				Icon *pOneIcon = (Icon *) (g_list_last ((GList*)pApplis)->data);  // on prend le dernier car les applis sont inserees a l'envers, et on veut avoir celle qui etait deja present dans le dock (pour 2 raisons : continuite, et la nouvelle (en 1ere position) n'est pas forcement deja dans un dock, ce qui fausse le ratio).
-				cd_debug ("  load from %s (%dx%d)", pOneIcon->cName, iWidth, iHeight);
-				pSurface = cairo_dock_duplicate_surface (pOneIcon->image.pSurface,
-					pOneIcon->image.iWidth,
-					pOneIcon->image.iHeight,
-					iWidth,
-					iHeight);  /// could make a gldi_image_buffer_load_from_buffer (&pOneIcon->image, iWidth, iHeight) and duplicate the texture only...
-			}
+			Icon *pOneIcon = (Icon *) (g_list_last ((GList*)pApplis)->data);  // on prend le dernier car les applis sont inserees a l'envers, et on veut avoir celle qui etait deja present dans le dock (pour 2 raisons : continuite, et la nouvelle (en 1ere position) n'est pas forcement deja dans un dock, ce qui fausse le ratio).
+			cd_debug ("  load from %s (%dx%d)", pOneIcon->cName, iWidth, iHeight);
+			pSurface = cairo_dock_duplicate_surface (pOneIcon->image.pSurface,
+				pOneIcon->image.iWidth,
+				pOneIcon->image.iHeight,
+				iWidth,
+				iHeight);  /// could make a gldi_image_buffer_load_from_buffer (&pOneIcon->image, iWidth, iHeight) and duplicate the texture only...
 		}
 	}
 	
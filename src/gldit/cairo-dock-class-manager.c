@@ -21,8 +21,12 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <errno.h>
+#include <unistd.h>  // read
+#include <sys/stat.h>
 
 #include <cairo.h>
+#include <glib/gstdio.h>  // g_stat
 
 #include "cairo-dock-icon-factory.h"
 #include "cairo-dock-icon-facility.h"
@@ -53,6 +57,12 @@
 #include "cairo-dock-windows-manager.h"
 #include "cairo-dock-class-manager.h"
 
+#if defined(__linux__) && GLIB_CHECK_VERSION (2, 36, 0)
+#define CD_WATCH_APPLICATIONS_DIRS
+#include <sys/inotify.h>
+#include <glib-unix.h>  // g_unix_fd_add
+#endif
+
 extern CairoDock *g_pMainDock;
 extern CairoDockDesktopEnv g_iDesktopEnv;
 
@@ -147,6 +157,7 @@ static gboolean _cairo_dock_add_inhibitor_to_class (const gchar *cClass, Icon *p
 
 	g_return_val_if_fail (g_list_find (pClassAppli->pIconsOfClass, pIcon) == NULL, TRUE);
 	pClassAppli->pIconsOfClass = g_list_prepend (pClassAppli->pIconsOfClass, pIcon);
+	cairo_dock_invalidate_class_image_buffers (cClass);  // the applis will take its image from now on.
 
 	return TRUE;
 }
@@ -462,6 +473,7 @@ static void _cairo_dock_remove_icon_from_class (Icon *pInhibitorIcon)
 	{
 		pClassAppli->pIconsOfClass = g_list_remove (pClassAppli->pIconsOfClass, pInhibitorIcon);
 	}
+	cairo_dock_invalidate_class_image_buffers (pInhibitorIcon->cClass);  // the applis may have taken its image.
 }
 
 void cairo_dock_deinhibite_class (const gchar *cClass, Icon *pInhibitorIcon)
@@ -477,6 +489,7 @@ void cairo_dock_deinhibite_class (const gchar *cClass, Icon *pInhibitorIcon)
 		pInhibitorIcon->pSubDock->icons = NULL;  // empty the sub-dock
 		cairo_dock_destroy_class_subdock (cClass);  // destroy the sub-dock without destroying its icons
 		pInhibitorIcon->pSubDock = NULL;  // since the inhibitor can already be detached, the sub-dock can't find it
+		cairo_dock_reindex_icon (pInhibitorIcon);
 
 		Icon *pAppliIcon;
 		GList *ic;
@@ -487,11 +500,13 @@ void cairo_dock_deinhibite_class (const gchar *cClass, Icon *pInhibitorIcon)
 		}
 
 		// then re-insert the appli icons.
+		cairo_dock_begin_resize_transaction ();
 		for (ic = icons; ic != NULL; ic = ic->next)
 		{
 			pAppliIcon = ic->data;
 			gldi_appli_icon_insert_in_dock (pAppliIcon, g_pMainDock, ! CAIRO_DOCK_ANIMATE_ICON);
 		}
+		cairo_dock_commit_resize_transaction ();
 		g_list_free (icons);
 
 		cairo_dock_trigger_load_icon_buffers (pInhibitorIcon);  // in case the inhibitor was drawn with an emblem or a stack of the applis
@@ -615,6 +630,7 @@ void cairo_dock_remove_all_applis_from_class_table (void)  // for the stop_appli
 
 void cairo_dock_reset_class_table (void)
 {
+	cairo_dock_invalidate_class_image_buffers (NULL);
 	g_hash_table_remove_all (s_hClassTable);
 }
 
@@ -699,6 +715,109 @@ cairo_surface_t *cairo_dock_create_surface_from_class (const gchar *cClass, int
 	return NULL;
 }
 
+/* Image buffers shared by the applis and the class sub-dock icons of a class:
+ * each (class, size) is loaded once, and the icons only hold a reference on it;
+ * an icon gets its own copy when it draws on its buffer (see cairo_dock_unshare_image_buffer).
+ * The table holds a reference too, so that an icon alone doesn't draw on the buffer the next icons will get.
+ */
+typedef struct {
+	gchar *cClass;
+	CairoDockImageBuffer image;
+	} CDClassImageBuffer;
+
+static GHashTable *s_hClassImageBuffers = NULL;  // "WxH class" -> CDClassImageBuffer*
+
+static void _free_class_image_buffer (CDClassImageBuffer *pBuffer)
+{
+	cairo_dock_unload_image_buffer (&pBuffer->image);
+	g_free (pBuffer->cClass);
+	g_free (pBuffer);
+}
+
+static gboolean _class_image_buffer_is_unused (G_GNUC_UNUSED gchar *cKey, CDClassImageBuffer *pBuffer, G_GNUC_UNUSED gpointer data)
+{
+	return (pBuffer->image.pSurface == NULL || cairo_surface_get_reference_count (pBuffer->image.pSurface) == 1);  // only held by the table
+}
+
+static gboolean _class_image_buffer_is_of_class (G_GNUC_UNUSED gchar *cKey, CDClassImageBuffer *pBuffer, const gchar *cClass)
+{
+	return (strcmp (cClass, pBuffer->cClass) == 0);
+}
+
+void cairo_dock_invalidate_class_image_buffers (const gchar *cClass)
+{
+	if (s_hClassImageBuffers == NULL)
+		return;
+	if (cClass == NULL)  // all of them
+		g_hash_table_remove_all (s_hClassImageBuffers);
+	else
+		g_hash_table_foreach_remove (s_hClassImageBuffers, (GHRFunc)_class_image_buffer_is_of_class, (gpointer)cClass);
+}
+
+void cairo_dock_get_class_image_buffers_stats (guint *iNbImages, gsize *iNbBytesSaved)
+{
+	guint n = 0;
+	gsize iNbBytes = 0;
+	if (s_hClassImageBuffers != NULL)
+	{
+		GHashTableIter iter;
+		CDClassImageBuffer *pBuffer;
+		int iNbHolders;
+		g_hash_table_iter_init (&iter, s_hClassImageBuffers);
+		while (g_hash_table_iter_next (&iter, NULL, (gpointer*)&pBuffer))
+		{
+			if (pBuffer->image.pSurface == NULL)
+				continue;
+			n ++;
+			iNbHolders = cairo_surface_get_reference_count (pBuffer->image.pSurface) - 1;  // the table holds a reference too.
+			if (iNbHolders > 1)  // without sharing, each icon would have its own copy (and its own texture).
+				iNbBytes += (gsize)(iNbHolders - 1) * pBuffer->image.iWidth * pBuffer->image.iHeight * 4 * (pBuffer->image.iTexture != 0 ? 2 : 1);
+		}
+	}
+	if (iNbImages)
+		*iNbImages = n;
+	if (iNbBytesSaved)
+		*iNbBytesSaved = iNbBytes;
+}
+
+gboolean cairo_dock_load_image_buffer_from_class (CairoDockImageBuffer *pImage, const gchar *cClass, int iWidth, int iHeight)
+{
+	g_return_val_if_fail (cClass != NULL && iWidth > 0 && iHeight > 0, FALSE);
+	CairoDockClassAppli *pClassAppli = cairo_dock_get_class (cClass);
+	if (pClassAppli != NULL && pClassAppli->bUseXIcon)
+		return FALSE;
+	if (s_hClassImageBuffers == NULL)
+		s_hClassImageBuffers = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify)_free_class_image_buffer);
+	
+	//\_______________ use the buffer already loaded for this class and size.
+	gchar *cKey = g_strdup_printf ("%dx%d %s", iWidth, iHeight, cClass);
+	CDClassImageBuffer *pBuffer = g_hash_table_lookup (s_hClassImageBuffers, cKey);
+	if (pBuffer != NULL)
+	{
+		g_free (cKey);
+		cairo_dock_share_image_buffer (pImage, &pBuffer->image);
+		gsize iNbBytesSaved;
+		cairo_dock_get_class_image_buffers_stats (NULL, &iNbBytesSaved);
+		cd_debug ("%s shares its image (%dx%d); %lu bytes saved in total", cClass, iWidth, iHeight, (gulong)iNbBytesSaved);
+		return TRUE;
+	}
+	
+	//\_______________ otherwise load it, and keep it for the next icons.
+	g_hash_table_foreach_remove (s_hClassImageBuffers, (GHRFunc)_class_image_buffer_is_unused, NULL);  // forget the classes that have no icon anymore.
+	cairo_surface_t *pSurface = cairo_dock_create_surface_from_class (cClass, iWidth, iHeight);
+	if (pSurface == NULL)
+	{
+		g_free (cKey);
+		return FALSE;
+	}
+	cairo_dock_load_image_buffer_from_surface (pImage, pSurface, iWidth, iHeight);
+	pBuffer = g_new0 (CDClassImageBuffer, 1);
+	pBuffer->cClass = g_strdup (cClass);
+	cairo_dock_share_image_buffer (&pBuffer->image, pImage);
+	g_hash_table_insert (s_hClassImageBuffers, cKey, pBuffer);
+	return TRUE;
+}
+
 /**
 void cairo_dock_update_visibility_on_inhibitors (const gchar *cClass, GldiWindowActor *pAppli, gboolean bIsHidden)
 {
@@ -865,6 +984,7 @@ gboolean cairo_dock_check_class_subdock_is_empty (CairoDock *pDock, const gchar
 		Icon *pFakeClassIcon = cairo_dock_search_icon_pointing_on_dock (pDock, NULL);
 		cairo_dock_destroy_class_subdock (cClass);
 		pFakeClassIcon->pSubDock = NULL;
+		cairo_dock_reindex_icon (pFakeClassIcon);
 		if (CAIRO_DOCK_ICON_TYPE_IS_CLASS_CONTAINER (pFakeClassIcon))
 		{
 			gldi_icon_detach (pFakeClassIcon);
@@ -889,6 +1009,7 @@ gboolean cairo_dock_check_class_subdock_is_empty (CairoDock *pDock, const gchar
 		// destroy the class sub-dock
 		cairo_dock_destroy_class_subdock (cClass);
 		pFakeClassIcon->pSubDock = NULL;
+		cairo_dock_reindex_icon (pFakeClassIcon);
 
 		if (CAIRO_DOCK_ICON_TYPE_IS_CLASS_CONTAINER (pFakeClassIcon))  // the class sub-dock is pointed by a class-icon
 		{
@@ -1579,59 +1700,508 @@ const CairoDockImageBuffer *cairo_dock_get_class_image_buffer (const gchar *cCla
 }
 
 
-static gchar *_search_desktop_file (const gchar *cDesktopFile)  // file, path or even class
+/* Applications database: all the .desktop files of the XDG applications dirs,
+ * indexed by their name and by the class guessed from their Exec/StartupWMClass,
+ * so that finding the desktop file of a class doesn't touch the disk.
+ * The guessed classes are kept in a cache file across sessions, so that only
+ * new or modified files are parsed at startup; the dirs are then watched.
+ */
+#define CD_DESKTOP_ENTRIES_CACHE_HEADER "# cairo-dock desktop entries 1"
+#define CD_APPLICATIONS_DIR_MAX_DEPTH 3  // sub-dirs like kde4/ or xfce4/
+#define CD_DESKTOP_ENTRIES_MIN_RESCAN_DELAY 10  // s, when the dirs can't be watched.
+
+typedef struct {
+	gchar *cPath;
+	gchar *cName;  // lower-case file name
+	gchar *cClass;  // class guessed from the file, or NULL
+	gint64 iMTime;
+	gint iPriority;  // rank of its applications dir in the XDG data dirs; lower wins.
+	} CDDesktopEntry;
+
+static GHashTable *s_hDesktopEntries = NULL;  // path -> entry
+static GHashTable *s_hDesktopEntriesByName = NULL;  // name -> entry
+static GHashTable *s_hDesktopEntriesByClass = NULL;  // class -> entry
+static gint64 s_iLastDesktopEntriesScan = 0;
+static gboolean s_bDesktopEntriesCacheOutdated = FALSE;
+static guint s_iSidSaveDesktopEntries = 0;
+#ifdef CD_WATCH_APPLICATIONS_DIRS
+typedef struct {
+	gchar *cDir;
+	gint iPriority;
+	gint iDepth;
+	} CDApplicationsDir;
+static int s_iApplicationsDirsFd = -1;
+static GHashTable *s_hWatchedApplicationsDirs = NULL;  // watch descriptor -> dir
+#endif
+
+static void _free_desktop_entry (CDDesktopEntry *pEntry)
+{
+	g_free (pEntry->cPath);
+	g_free (pEntry->cName);
+	g_free (pEntry->cClass);
+	g_free (pEntry);
+}
+
+static inline GHashTable *_new_desktop_entries_table (void)
+{
+	return g_hash_table_new_full (g_str_hash,
+		g_str_equal,
+		NULL,  // the key is the path of the entry.
+		(GDestroyNotify) _free_desktop_entry);
+}
+
+static gchar *_guess_class_from_desktop_file (const gchar *cPath)
+{
+	GKeyFile *pKeyFile = g_key_file_new ();
+	gchar *cClass = NULL;
+	if (g_key_file_load_from_file (pKeyFile, cPath, G_KEY_FILE_NONE, NULL))
+	{
+		gchar *cCommand = g_key_file_get_string (pKeyFile, "Desktop Entry", "Exec", NULL);
+		gchar *cStartupWMClass = g_key_file_get_string (pKeyFile, "Desktop Entry", "StartupWMClass", NULL);
+		cClass = cairo_dock_guess_class (cCommand, cStartupWMClass);
+		g_free (cCommand);
+		g_free (cStartupWMClass);
+	}
+	g_key_file_free (pKeyFile);
+	return cClass;
+}
+
+static void _load_desktop_entry (const gchar *cPath, gint iPriority, GHashTable *pKnownEntries)
 {
-	if (cDesktopFile == NULL)
-		return NULL;
-	if (*cDesktopFile == '/' && g_file_test (cDesktopFile, G_FILE_TEST_EXISTS))  // it's a path and it exists.
+	struct stat st;
+	if (g_stat (cPath, &st) != 0 || ! S_ISREG (st.st_mode))
+		return;
+
+	CDDesktopEntry *pEntry = g_new0 (CDDesktopEntry, 1);
+	pEntry->cPath = g_strdup (cPath);
+	gchar *cFileName = g_path_get_basename (cPath);
+	pEntry->cName = g_ascii_strdown (cFileName, -1);  // handle stupid cases like Thunar.desktop
+	g_free (cFileName);
+	pEntry->iMTime = st.st_mtime;
+	pEntry->iPriority = iPriority;
+
+	CDDesktopEntry *pKnownEntry = (pKnownEntries ? g_hash_table_lookup (pKnownEntries, cPath) : NULL);
+	if (pKnownEntry != NULL && pKnownEntry->iMTime == pEntry->iMTime)  // not modified since we parsed it.
 	{
-		return g_strdup (cDesktopFile);
+		pEntry->cClass = g_strdup (pKnownEntry->cClass);
+	}
+	else
+	{
+		pEntry->cClass = _guess_class_from_desktop_file (cPath);
+		s_bDesktopEntriesCacheOutdated = TRUE;
+	}
+
+	CDDesktopEntry *pPrevEntry = g_hash_table_lookup (s_hDesktopEntries, cPath);  // same dir listed twice in the XDG data dirs.
+	if (pPrevEntry != NULL && pPrevEntry->iPriority < pEntry->iPriority)
+		pEntry->iPriority = pPrevEntry->iPriority;
+	g_hash_table_replace (s_hDesktopEntries, pEntry->cPath, pEntry);
+}
+
+#ifdef CD_WATCH_APPLICATIONS_DIRS
+static void _free_applications_dir (CDApplicationsDir *pDir)
+{
+	g_free (pDir->cDir);
+	g_free (pDir);
+}
+
+static void _watch_applications_dir (const gchar *cDir, gint iPriority, gint iDepth)
+{
+	if (s_iApplicationsDirsFd < 0)
+		return;
+	int iWatch = inotify_add_watch (s_iApplicationsDirsFd, cDir, IN_CREATE | IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_ONLYDIR);
+	if (iWatch < 0)
+	{
+		cd_debug ("couldn't watch %s (%s)", cDir, g_strerror (errno));
+		return;
+	}
+	CDApplicationsDir *pDir = g_new0 (CDApplicationsDir, 1);
+	pDir->cDir = g_strdup (cDir);
+	pDir->iPriority = iPriority;
+	pDir->iDepth = iDepth;
+	g_hash_table_replace (s_hWatchedApplicationsDirs, GINT_TO_POINTER (iWatch), pDir);  // a dir is watched only once, with the same descriptor.
+}
+#endif
+
+static void _scan_applications_dir (const gchar *cDir, gint iPriority, gint iDepth, GHashTable *pKnownEntries)
+{
+	GDir *dir = g_dir_open (cDir, 0, NULL);
+	if (dir == NULL)
+		return;
+	#ifdef CD_WATCH_APPLICATIONS_DIRS
+	_watch_applications_dir (cDir, iPriority, iDepth);
+	#endif
+
+	const gchar *cFileName;
+	gchar *cPath;
+	while ((cFileName = g_dir_read_name (dir)) != NULL)
+	{
+		cPath = g_build_filename (cDir, cFileName, NULL);
+		if (g_str_has_suffix (cFileName, ".desktop"))
+			_load_desktop_entry (cPath, iPriority, pKnownEntries);
+		else if (iDepth < CD_APPLICATIONS_DIR_MAX_DEPTH && g_file_test (cPath, G_FILE_TEST_IS_DIR))
+			_scan_applications_dir (cPath, iPriority, iDepth + 1, pKnownEntries);
+		g_free (cPath);
+	}
+	g_dir_close (dir);
+}
+
+static void _map_desktop_entry (GHashTable *pTable, const gchar *cKey, CDDesktopEntry *pEntry)
+{
+	CDDesktopEntry *pPrevEntry = g_hash_table_lookup (pTable, cKey);
+	if (pPrevEntry == NULL
+	|| pEntry->iPriority < pPrevEntry->iPriority
+	|| (pEntry->iPriority == pPrevEntry->iPriority && strcmp (pEntry->cPath, pPrevEntry->cPath) < 0))  // same result whatever the order of the scan.
+		g_hash_table_replace (pTable, (gpointer)cKey, pEntry);
+}
+static void _map_desktop_entry_by_name_and_class (G_GNUC_UNUSED const gchar *cPath, CDDesktopEntry *pEntry, G_GNUC_UNUSED gpointer data)
+{
+	_map_desktop_entry (s_hDesktopEntriesByName, pEntry->cName, pEntry);
+	if (pEntry->cClass != NULL)
+		_map_desktop_entry (s_hDesktopEntriesByClass, pEntry->cClass, pEntry);
+}
+static void _map_desktop_entries (void)
+{
+	g_hash_table_remove_all (s_hDesktopEntriesByName);
+	g_hash_table_remove_all (s_hDesktopEntriesByClass);
+	g_hash_table_foreach (s_hDesktopEntries, (GHFunc) _map_desktop_entry_by_name_and_class, NULL);
+}
+
+static gchar *_get_desktop_entries_cache_path (void)
+{
+	return g_build_filename (g_get_user_cache_dir (), "cairo-dock", "desktop-entries", NULL);
+}
+
+static GHashTable *_load_desktop_entries_cache (void)
+{
+	GHashTable *pEntries = _new_desktop_entries_table ();
+	gchar *cCachePath = _get_desktop_entries_cache_path ();
+	gchar *cContent = NULL;
+	if (g_file_get_contents (cCachePath, &cContent, NULL, NULL))
+	{
+		gchar **pLines = g_strsplit (cContent, "\n", -1);
+		if (pLines[0] != NULL && strcmp (pLines[0], CD_DESKTOP_ENTRIES_CACHE_HEADER) == 0)  // otherwise it's from another version, just ignore it.
+		{
+			CDDesktopEntry *pEntry;
+			gchar **pFields;
+			int i;
+			for (i = 1; pLines[i] != NULL; i ++)
+			{
+				pFields = g_strsplit (pLines[i], "\t", 3);  // mtime, class, path
+				if (g_strv_length (pFields) == 3 && *pFields[2] == '/')
+				{
+					pEntry = g_new0 (CDDesktopEntry, 1);
+					pEntry->iMTime = g_ascii_strtoll (pFields[0], NULL, 10);
+					pEntry->cClass = (*pFields[1] != '\0' ? g_strdup (pFields[1]) : NULL);
+					pEntry->cPath = g_strdup (pFields[2]);
+					g_hash_table_replace (pEntries, pEntry->cPath, pEntry);
+				}
+				g_strfreev (pFields);
+			}
+		}
+		g_strfreev (pLines);
+		g_free (cContent);
+	}
+	g_free (cCachePath);
+	return pEntries;
+}
+
+static void _write_desktop_entry (G_GNUC_UNUSED const gchar *cPath, CDDesktopEntry *pEntry, GString *sContent)
+{
+	if (strpbrk (pEntry->cPath, "\t\n") != NULL)  // can't be stored, it will just be parsed again next time.
+		return;
+	g_string_append_printf (sContent, "%" G_GINT64_FORMAT "\t%s\t%s\n",
+		pEntry->iMTime,
+		pEntry->cClass ? pEntry->cClass : "",
+		pEntry->cPath);
+}
+static gboolean _save_desktop_entries_cache (G_GNUC_UNUSED gpointer data)
+{
+	GString *sContent = g_string_new (CD_DESKTOP_ENTRIES_CACHE_HEADER"\n");
+	g_hash_table_foreach (s_hDesktopEntries, (GHFunc) _write_desktop_entry, sContent);
+
+	gchar *cCachePath = _get_desktop_entries_cache_path ();
+	gchar *cCacheDir = g_path_get_dirname (cCachePath);
+	GError *erreur = NULL;
+	if (g_mkdir_with_parents (cCacheDir, 0700) != 0
+	|| ! g_file_set_contents (cCachePath, sContent->str, sContent->len, &erreur))
+	{
+		cd_debug ("couldn't save the desktop entries in %s (%s)", cCachePath, erreur ? erreur->message : g_strerror (errno));
+		if (erreur)
+			g_error_free (erreur);
 	}
+	g_free (cCacheDir);
+	g_free (cCachePath);
+	g_string_free (sContent, TRUE);
 
-	gchar *cDesktopFileName = NULL;
-	if (*cDesktopFile == '/')
-		cDesktopFileName = g_path_get_basename (cDesktopFile);
-	else if (! g_str_has_suffix (cDesktopFile, ".desktop"))
-		cDesktopFileName = g_strdup_printf ("%s.desktop", cDesktopFile);
+	s_bDesktopEntriesCacheOutdated = FALSE;
+	s_iSidSaveDesktopEntries = 0;
+	return FALSE;
+}
+static void _save_desktop_entries_cache_later (void)
+{
+	if (s_iSidSaveDesktopEntries == 0)  // the dirs are often modified several times in a row by package managers.
+		s_iSidSaveDesktopEntries = g_timeout_add_seconds (5, (GSourceFunc) _save_desktop_entries_cache, NULL);
+}
 
-	const gchar *cFileName = (cDesktopFileName ? cDesktopFileName : cDesktopFile);
-	gboolean bFound = TRUE;
-	GString *sDesktopFilePath = g_string_new ("");
-	g_string_printf (sDesktopFilePath, "/usr/share/applications/%s", cFileName);
-	if (! g_file_test (sDesktopFilePath->str, G_FILE_TEST_EXISTS))
+static void _scan_applications_dirs (GHashTable *pKnownEntries)
+{
+	s_hDesktopEntries = _new_desktop_entries_table ();
+
+	gchar *cDir = g_build_filename (g_get_user_data_dir (), "applications", NULL);  // the user's ones come first.
+	_scan_applications_dir (cDir, 0, 0, pKnownEntries);
+	g_free (cDir);
+
+	const gchar * const *pDataDirs = g_get_system_data_dirs ();
+	int i;
+	for (i = 0; pDataDirs[i] != NULL; i ++)
 	{
-		g_string_printf (sDesktopFilePath, "/usr/share/applications/%c%s", g_ascii_toupper (*cFileName), cFileName+1);  // handle stupid cases like Thunar.desktop
-		if (! g_file_test (sDesktopFilePath->str, G_FILE_TEST_EXISTS))
+		cDir = g_build_filename (pDataDirs[i], "applications", NULL);
+		_scan_applications_dir (cDir, i + 1, 0, pKnownEntries);
+		g_free (cDir);
+	}
+
+	if (g_hash_table_size (s_hDesktopEntries) != g_hash_table_size (pKnownEntries))  // some files have been removed.
+		s_bDesktopEntriesCacheOutdated = TRUE;
+	s_iLastDesktopEntriesScan = g_get_monotonic_time ();
+	cd_debug ("%u desktop entries", g_hash_table_size (s_hDesktopEntries));
+}
+
+static void _rescan_applications_dirs (void)
+{
+	GHashTable *pKnownEntries = s_hDesktopEntries;  // only the new or modified files will be parsed.
+	g_hash_table_remove_all (s_hDesktopEntriesByName);  // they point to the old entries.
+	g_hash_table_remove_all (s_hDesktopEntriesByClass);
+	_scan_applications_dirs (pKnownEntries);
+	g_hash_table_destroy (pKnownEntries);
+	_map_desktop_entries ();
+	if (s_bDesktopEntriesCacheOutdated)
+		_save_desktop_entries_cache_later ();
+}
+
+#ifdef CD_WATCH_APPLICATIONS_DIRS
+static gboolean _on_applications_dir_changed (gint iFd, G_GNUC_UNUSED GIOCondition iCondition, G_GNUC_UNUSED gpointer data)
+{
+	char buffer[4096] __attribute__ ((aligned (__alignof__ (struct inotify_event))));
+	const struct inotify_event *event;
+	CDApplicationsDir *pDir;
+	gchar *cPath;
+	gboolean bChanged = FALSE, bRescan = FALSE;
+	ssize_t len;
+	char *ptr;
+	g_hash_table_remove_all (s_hDesktopEntriesByName);  // they point to the entries that are going to be replaced or removed.
+	g_hash_table_remove_all (s_hDesktopEntriesByClass);
+	while ((len = read (iFd, buffer, sizeof (buffer))) > 0)
+	{
+		for (ptr = buffer; ptr < buffer + len; ptr += sizeof (struct inotify_event) + event->len)
 		{
-			g_string_printf (sDesktopFilePath, "/usr/share/applications/xfce4/%s", cFileName);
-			if (! g_file_test (sDesktopFilePath->str, G_FILE_TEST_EXISTS))
+			event = (const struct inotify_event *) ptr;
+			if (event->mask & IN_Q_OVERFLOW)  // some events have been lost.
+			{
+				bRescan = TRUE;
+				continue;
+			}
+			pDir = g_hash_table_lookup (s_hWatchedApplicationsDirs, GINT_TO_POINTER (event->wd));
+			if (pDir == NULL)
+				continue;
+			if (event->mask & IN_IGNORED)  // the dir has been removed, its files have already been notified.
+			{
+				g_hash_table_remove (s_hWatchedApplicationsDirs, GINT_TO_POINTER (event->wd));
+				continue;
+			}
+			if (event->len == 0)
+				continue;
+
+			cPath = g_build_filename (pDir->cDir, event->name, NULL);
+			if (event->mask & IN_ISDIR)
 			{
-				g_string_printf (sDesktopFilePath, "/usr/share/applications/kde4/%s", cFileName);
-				if (! g_file_test (sDesktopFilePath->str, G_FILE_TEST_EXISTS))
+				if ((event->mask & (IN_CREATE | IN_MOVED_TO)) && pDir->iDepth < CD_APPLICATIONS_DIR_MAX_DEPTH)
 				{
-					g_string_printf (sDesktopFilePath, "%s/.local/share/applications/%s", g_getenv ("HOME"), cFileName);
-					if (! g_file_test (sDesktopFilePath->str, G_FILE_TEST_EXISTS))
+					_scan_applications_dir (cPath, pDir->iPriority, pDir->iDepth + 1, NULL);
+					bChanged = TRUE;
+				}
+				else if (event->mask & IN_MOVED_FROM)  // its files are not notified.
+					bRescan = TRUE;
+			}
+			else if (g_str_has_suffix (event->name, ".desktop"))
+			{
+				if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+				{
+					if (g_hash_table_remove (s_hDesktopEntries, cPath))
 					{
-						bFound = FALSE;
+						s_bDesktopEntriesCacheOutdated = TRUE;
+						bChanged = TRUE;
 					}
 				}
+				else
+				{
+					_load_desktop_entry (cPath, pDir->iPriority, NULL);  // parse it again, it may have been modified within the same second.
+					bChanged = TRUE;
+				}
 			}
+			g_free (cPath);
 		}
 	}
-	g_free (cDesktopFileName);
 
-	gchar *cResult;
-	if (bFound)
+	if (bRescan)
+		_rescan_applications_dirs ();
+	else
 	{
-		cResult = sDesktopFilePath->str;
-		g_string_free (sDesktopFilePath, FALSE);
+		_map_desktop_entries ();
+		if (bChanged && s_bDesktopEntriesCacheOutdated)
+			_save_desktop_entries_cache_later ();
+	}
+	return TRUE;
+}
+#endif
+
+static void _init_desktop_entries (void)
+{
+	if (s_hDesktopEntries != NULL)
+		return;
+	s_hDesktopEntriesByName = g_hash_table_new (g_str_hash, g_str_equal);  // keys and values belong to the entries.
+	s_hDesktopEntriesByClass = g_hash_table_new (g_str_hash, g_str_equal);
+
+	#ifdef CD_WATCH_APPLICATIONS_DIRS
+	s_iApplicationsDirsFd = inotify_init1 (IN_NONBLOCK | IN_CLOEXEC);
+	if (s_iApplicationsDirsFd >= 0)
+	{
+		s_hWatchedApplicationsDirs = g_hash_table_new_full (NULL, NULL, NULL, (GDestroyNotify) _free_applications_dir);
+		g_unix_fd_add (s_iApplicationsDirsFd, G_IO_IN, (GUnixFDSourceFunc) _on_applications_dir_changed, NULL);
 	}
 	else
+		cd_debug ("couldn't watch the applications dirs (%s)", g_strerror (errno));
+	#endif
+
+	GHashTable *pKnownEntries = _load_desktop_entries_cache ();
+	_scan_applications_dirs (pKnownEntries);
+	g_hash_table_destroy (pKnownEntries);
+	_map_desktop_entries ();
+	if (s_bDesktopEntriesCacheOutdated)
+		_save_desktop_entries_cache_later ();
+}
+
+static inline gboolean _applications_dirs_are_watched (void)
+{
+	#ifdef CD_WATCH_APPLICATIONS_DIRS
+	return (s_iApplicationsDirsFd >= 0);
+	#else
+	return FALSE;
+	#endif
+}
+
+static CDDesktopEntry *_lookup_desktop_entry (const gchar *cName, const gchar *cClass)
+{
+	CDDesktopEntry *pEntry = g_hash_table_lookup (s_hDesktopEntriesByName, cName);
+	if (pEntry == NULL && cClass != NULL)  // no file named after the class, look for an application with this class.
+		pEntry = g_hash_table_lookup (s_hDesktopEntriesByClass, cClass);
+	return pEntry;
+}
+
+static gchar *_search_desktop_file_full (const gchar *cDesktopFile, gboolean bCanRescan)  // file, path or even class; without rescan, it only reads the index and can be called from a worker thread.
+{
+	if (*cDesktopFile == '/'
+	&& (g_hash_table_lookup (s_hDesktopEntries, cDesktopFile) != NULL || g_file_test (cDesktopFile, G_FILE_TEST_EXISTS)))  // it's a path and it exists.
 	{
-		cResult = NULL;
-		g_string_free (sDesktopFilePath, TRUE);
+		return g_strdup (cDesktopFile);
 	}
-	return cResult;
+
+	gchar *cFileName = (*cDesktopFile == '/' ? g_path_get_basename (cDesktopFile) : g_strdup (cDesktopFile));
+	gchar *cClass = NULL;
+	if (! g_str_has_suffix (cFileName, ".desktop"))  // it's a class
+	{
+		cClass = g_ascii_strdown (cFileName, -1);
+		g_free (cFileName);
+		cFileName = g_strdup_printf ("%s.desktop", cClass);
+	}
+	gchar *cName = g_ascii_strdown (cFileName, -1);
+
+	CDDesktopEntry *pEntry = _lookup_desktop_entry (cName, cClass);
+	if (pEntry == NULL && bCanRescan && ! _applications_dirs_are_watched ()
+	&& g_get_monotonic_time () - s_iLastDesktopEntriesScan > CD_DESKTOP_ENTRIES_MIN_RESCAN_DELAY * G_USEC_PER_SEC)  // it may have been installed since the last scan.
+	{
+		_rescan_applications_dirs ();
+		pEntry = _lookup_desktop_entry (cName, cClass);
+	}
+	g_free (cName);
+	g_free (cFileName);
+	g_free (cClass);
+
+	return (pEntry ? g_strdup (pEntry->cPath) : NULL);
+}
+
+static gchar *_search_desktop_file (const gchar *cDesktopFile)
+{
+	if (cDesktopFile == NULL)
+		return NULL;
+	_init_desktop_entries ();
+	return _search_desktop_file_full (cDesktopFile, TRUE);
+}
+
+static GHashTable *s_hParsedDesktopFiles = NULL;  // path -> GKeyFile, desktop files parsed beforehand by worker threads, taken when their class is registered.
+G_LOCK_DEFINE_STATIC (s_hParsedDesktopFiles);
+
+void cairo_dock_begin_parsing_class_desktop_files (void)
+{
+	_init_desktop_entries ();  // the workers only read the index, so it must be ready.
+	if (s_hParsedDesktopFiles == NULL)
+		s_hParsedDesktopFiles = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_key_file_free);
+}
+
+gboolean cairo_dock_parse_class_desktop_file (const gchar *cDesktopFile)  // worker thread
+{
+	g_return_val_if_fail (s_hParsedDesktopFiles != NULL, FALSE);
+	if (cDesktopFile == NULL || *cDesktopFile == '\0')
+		return FALSE;
+	gchar *cDesktopFilePath = _search_desktop_file_full (cDesktopFile, FALSE);  // a missing file is searched again when the class is registered.
+	if (cDesktopFilePath == NULL)
+		return FALSE;
+	
+	G_LOCK (s_hParsedDesktopFiles);
+	gboolean bParsed = (g_hash_table_lookup (s_hParsedDesktopFiles, cDesktopFilePath) != NULL);  // several launchers can share a class.
+	G_UNLOCK (s_hParsedDesktopFiles);
+	if (bParsed)
+	{
+		g_free (cDesktopFilePath);
+		return TRUE;
+	}
+	
+	GKeyFile *pKeyFile = cairo_dock_open_key_file (cDesktopFilePath);
+	if (pKeyFile == NULL)
+	{
+		g_free (cDesktopFilePath);
+		return FALSE;
+	}
+	G_LOCK (s_hParsedDesktopFiles);
+	g_hash_table_replace (s_hParsedDesktopFiles, cDesktopFilePath, pKeyFile);
+	G_UNLOCK (s_hParsedDesktopFiles);
+	return TRUE;
+}
+
+void cairo_dock_end_parsing_class_desktop_files (void)
+{
+	if (s_hParsedDesktopFiles == NULL)
+		return;
+	g_hash_table_destroy (s_hParsedDesktopFiles);  // the files of the classes that were not registered.
+	s_hParsedDesktopFiles = NULL;
+}
+
+static GKeyFile *_open_class_desktop_file (const gchar *cDesktopFilePath)
+{
+	GKeyFile *pKeyFile = NULL;
+	if (s_hParsedDesktopFiles != NULL)
+	{
+		gchar *cPath = NULL;
+		G_LOCK (s_hParsedDesktopFiles);
+		if (g_hash_table_lookup_extended (s_hParsedDesktopFiles, cDesktopFilePath, (gpointer*)&cPath, (gpointer*)&pKeyFile))
+		{
+			g_hash_table_steal (s_hParsedDesktopFiles, cDesktopFilePath);
+			g_free (cPath);
+		}
+		G_UNLOCK (s_hParsedDesktopFiles);
+	}
+	if (pKeyFile == NULL)
+		pKeyFile = cairo_dock_open_key_file (cDesktopFilePath);
+	return pKeyFile;
 }
 
 gchar *cairo_dock_guess_class (const gchar *cCommand, const gchar *cStartupWMClass)
@@ -1869,7 +2439,7 @@ gchar *cairo_dock_register_class_full (const gchar *cDesktopFile, const gchar *c
 
 	//\__________________ open it.
 	cd_debug ("+ parsing class desktop file %s...", cDesktopFilePath);
-	GKeyFile* pKeyFile = cairo_dock_open_key_file (cDesktopFilePath);
+	GKeyFile* pKeyFile = _open_class_desktop_file (cDesktopFilePath);
 	g_return_val_if_fail (pKeyFile != NULL, NULL);
 
 	//\__________________ guess the class name.
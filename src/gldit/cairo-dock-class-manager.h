@@ -162,6 +162,26 @@ void cairo_dock_reset_class_table (void);
 */
 cairo_surface_t *cairo_dock_create_surface_from_class (const gchar *cClass, int iWidth, int ifHeight);
 
+/** Load the image of a class into an ImageBuffer, the same way as \ref cairo_dock_create_surface_from_class. The image is loaded once per class and size, and shared by all the ImageBuffers loaded this way (see \ref cairo_dock_share_image_buffer).
+*@param pImage an ImageBuffer, empty.
+*@param cClass the class.
+*@param iWidth width of the image.
+*@param iHeight height of the image.
+*@return TRUE if an image has been loaded, FALSE if the class has no image or uses the X icons.
+*/
+gboolean cairo_dock_load_image_buffer_from_class (CairoDockImageBuffer *pImage, const gchar *cClass, int iWidth, int iHeight);
+
+/** Forget the shared images of a class, so that the next icons load it again (for instance when its inhibitors have changed). The icons that use them keep them.
+*@param cClass the class, or NULL for all the classes.
+*/
+void cairo_dock_invalidate_class_image_buffers (const gchar *cClass);
+
+/** Get how many class images are currently shared, and how much memory it saves compared to each icon having its own copy.
+*@param iNbImages returns the number of shared images.
+*@param iNbBytesSaved returns the memory saved, in bytes (surfaces and textures).
+*/
+void cairo_dock_get_class_image_buffers_stats (guint *iNbImages, gsize *iNbBytesSaved);
+
 
 /** Run a function on each Icon that inhibites a given window.
 *@param actor the window actor
@@ -212,6 +232,20 @@ gchar *cairo_dock_guess_class (const gchar *cCommand, const gchar *cStartupWMCla
 
 gchar *cairo_dock_register_class_full (const gchar *cDesktopFile, const gchar *cClassName, const gchar *cWmClass);
 
+/** Prepare the parsing of desktop files by worker threads, before their classes are registered. Until \ref cairo_dock_end_parsing_class_desktop_files, the main thread must not register any class while the workers run.
+*/
+void cairo_dock_begin_parsing_class_desktop_files (void);
+
+/** Find and parse the desktop file of a class, so that registering the class later takes it rather than parsing it again. It can be called from a worker thread.
+* @param cDesktopFile the desktop file path or name, or a class, as for \ref cairo_dock_register_class_full.
+* @return TRUE if the file has been found and parsed.
+*/
+gboolean cairo_dock_parse_class_desktop_file (const gchar *cDesktopFile);
+
+/** Forget the desktop files that were parsed beforehand and not taken by a class.
+*/
+void cairo_dock_end_parsing_class_desktop_files (void);
+
 /** Register a class corresponding to a desktop file. Launchers can then derive from the class.
 * @param cDesktopFile the desktop file path or name; if it's a name or if the path couldn't be found, it will be searched in the common directories.
 * @return the class ID in a newly allocated string.
@@ -33,6 +33,7 @@
 #include "cairo-dock-utils.h"  // cairo_dock_string_is_address
 #include "cairo-dock-windows-manager.h"  // gldi_windows_get_active
 #include "cairo-dock-opengl.h"
+#include "cairo-dock-draw-opengl.h"  // cairo_dock_create_texture_from_raw_data
 #include "cairo-dock-animations.h"  // cairo_dock_animation_will_be_visible
 #include "cairo-dock-desktop-manager.h"  // gldi_desktop_get_width
 #include "cairo-dock-menu.h"  // gldi_menu_new
@@ -177,8 +178,12 @@ static inline void _redraw_container_area (GldiContainer *pContainer, GdkRectang
 
 void cairo_dock_redraw_container_area (GldiContainer *pContainer, GdkRectangle *pArea)
 {
-	if (CAIRO_DOCK_IS_DOCK (pContainer) && ! cairo_dock_animation_will_be_visible (CAIRO_DOCK (pContainer)))  // inutile de redessiner.
-		return ;
+	if (CAIRO_DOCK_IS_DOCK (pContainer))
+	{
+		CAIRO_DOCK (pContainer)->bRedirectedImageIsValid = FALSE;  // something has changed in the dock.
+		if (! cairo_dock_animation_will_be_visible (CAIRO_DOCK (pContainer)))  // inutile de redessiner.
+			return ;
+	}
 	_redraw_container_area (pContainer, pArea);
 }
 
@@ -190,6 +195,8 @@ void cairo_dock_redraw_icon (Icon *icon)
 	GdkRectangle rect;
 	cairo_dock_compute_icon_area (icon, pContainer, &rect);
 	
+	if (CAIRO_DOCK_IS_DOCK (pContainer))
+		CAIRO_DOCK (pContainer)->bRedirectedImageIsValid = FALSE;  // the icon has changed.
 	if (CAIRO_DOCK_IS_DOCK (pContainer) &&
 		( (cairo_dock_is_hidden (CAIRO_DOCK (pContainer)) && ! icon->bIsDemandingAttention && ! icon->bAlwaysVisible)
 		|| (CAIRO_DOCK (pContainer)->iRefCount != 0 && ! gldi_container_is_visible (pContainer)) ) )  // inutile de redessiner.
@@ -197,6 +204,85 @@ void cairo_dock_redraw_icon (Icon *icon)
 	_redraw_container_area (pContainer, &rect);
 }
 
+static void _render_container (GldiContainer *pContainer, cairo_t *pCairoContext)
+{
+	if (CAIRO_DOCK_IS_DOCK (pContainer))  // draw the dock itself, whatever its visibility.
+	{
+		CairoDock *pDock = CAIRO_DOCK (pContainer);
+		if (pCairoContext)
+			pDock->pRenderer->render (pCairoContext, pDock);
+		else
+			pDock->pRenderer->render_opengl (pDock);
+	}
+	else
+		gldi_object_notify (pContainer, NOTIFICATION_RENDER, pContainer, pCairoContext);
+}
+
+static gboolean _render_container_into_fbo (GldiContainer *pContainer, cairo_surface_t *pSurface, int iWidth, int iHeight)
+{
+	if (! g_openglConfig.bFboAvailable || ! gldi_gl_container_make_current (pContainer))
+	{
+		cd_warning ("can't draw this container offscreen");
+		return FALSE;
+	}
+	GLuint iTexture = cairo_dock_create_texture_from_raw_data (NULL, iWidth, iHeight);
+	GLuint iFboId = 0;
+	glGenFramebuffersEXT (1, &iFboId);
+	glBindFramebufferEXT (GL_FRAMEBUFFER_EXT, iFboId);
+	glFramebufferTexture2DEXT (GL_FRAMEBUFFER_EXT,
+		GL_COLOR_ATTACHMENT0_EXT,
+		GL_TEXTURE_2D,
+		iTexture,
+		0);
+	gboolean bDrawn = (glCheckFramebufferStatusEXT (GL_FRAMEBUFFER_EXT) == GL_FRAMEBUFFER_COMPLETE_EXT);
+	if (bDrawn)
+	{
+		glLoadIdentity ();
+		glClear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		_render_container (pContainer, NULL);  // no end_draw: nothing must be swapped on the window.
+		
+		// read the FBO, from bottom to top (GL goes up).
+		cairo_surface_flush (pSurface);
+		guchar *pData = cairo_image_surface_get_data (pSurface);
+		int iStride = cairo_image_surface_get_stride (pSurface);
+		int y;
+		for (y = 0; y < iHeight; y ++)
+		{
+			glReadPixels (0, iHeight - 1 - y, iWidth, 1, GL_BGRA, GL_UNSIGNED_BYTE, (GLvoid *)(pData + y * iStride));
+		}
+		cairo_surface_mark_dirty (pSurface);
+	}
+	else
+		cd_warning ("FBO not ready");
+	
+	glBindFramebufferEXT (GL_FRAMEBUFFER_EXT, 0);
+	glDeleteFramebuffersEXT (1, &iFboId);
+	_cairo_dock_delete_texture (iTexture);
+	return bDrawn;
+}
+
+cairo_surface_t *gldi_container_snapshot (GldiContainer *pContainer)
+{
+	g_return_val_if_fail (pContainer != NULL, NULL);
+	int iWidth = (pContainer->bIsHorizontal ? pContainer->iWidth : pContainer->iHeight);
+	int iHeight = (pContainer->bIsHorizontal ? pContainer->iHeight : pContainer->iWidth);
+	cairo_surface_t *pSurface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, iWidth, iHeight);
+	
+	gboolean bCanRenderOpenGL = (! CAIRO_DOCK_IS_DOCK (pContainer) || CAIRO_DOCK (pContainer)->pRenderer->render_opengl != NULL);
+	if (g_bUseOpenGL && bCanRenderOpenGL)
+	{
+		gtk_widget_realize (pContainer->pWidget);  // the container may never have been shown; the GL context needs a window.
+		_render_container_into_fbo (pContainer, pSurface, iWidth, iHeight);
+	}
+	else
+	{
+		cairo_t *pCairoContext = cairo_create (pSurface);
+		_render_container (pContainer, pCairoContext);
+		cairo_destroy (pCairoContext);
+	}
+	return pSurface;
+}
+
 
 void cairo_dock_allow_widget_to_receive_data (GtkWidget *pWidget, GCallback pCallBack, gpointer data)
 {
@@ -283,6 +283,12 @@ void cairo_dock_redraw_container_area (GldiContainer *pContainer, GdkRectangle *
 */
 void cairo_dock_redraw_icon (Icon *icon);
 
+/** Draw a Container into an image, without drawing on the screen. The renderer is called directly on an offscreen buffer (a FBO in OpenGL), without going through the expose event, so the container doesn't need to be visible and nothing is swapped on its window; a dock is drawn as if it were visible. Combined with \ref cairo_dock_step_animation, it gives reproducible snapshots.
+*@param pContainer the Container to draw.
+*@return a newly allocated image surface, of the size of the container's window.
+*/
+cairo_surface_t *gldi_container_snapshot (GldiContainer *pContainer);
+
 
 void cairo_dock_allow_widget_to_receive_data (GtkWidget *pWidget, GCallback pCallBack, gpointer data);
 
@@ -39,6 +39,7 @@
 #include "cairo-dock-windows-manager.h"
 #include "cairo-dock-X-manager.h"
 #include "cairo-dock-wayland-manager.h"
+#include "cairo-dock-headless-manager.h"
 #include "cairo-dock-module-manager.h"
 #include "cairo-dock-module-instance-manager.h"
 #include "cairo-dock-packages.h"
@@ -91,6 +92,7 @@ static void _gldi_register_core_managers (void)
 	gldi_register_style_manager ();  // get config before other manager that could use this manager
 	gldi_register_X_manager ();
 	gldi_register_wayland_manager ();
+	gldi_register_headless_manager ();
 }
 
 void gldi_init (GldiRenderingMethod iRendering)
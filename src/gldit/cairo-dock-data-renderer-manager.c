@@ -45,7 +45,7 @@ static CairoDockGLFont *s_pFont = NULL;
  /// FONT ///
 ////////////
 
-#define _init_data_renderer_font(...) s_pFont = cairo_dock_load_textured_font ("Monospace Bold 12", 0, 184)  // on va jusqu'a ø
+#define _init_data_renderer_font(...) s_pFont = cairo_dock_load_glyph_font ("Monospace Bold 12")
 
 CairoDockGLFont *cairo_dock_get_default_data_renderer_font (void)
 {
@@ -134,14 +134,8 @@ void cairo_data_renderer_get_size (CairoDataRenderer *pRenderer, gint *iWidth, g
 }
 
 
-void cairo_dock_render_overlays_to_texture (CairoDataRenderer *pRenderer, int iNumValue)
+static void _render_emblem_and_label_to_texture (CairoDataRenderer *pRenderer, int iNumValue, int iWidth, int iHeight)
 {
-	gint iWidth = pRenderer->iWidth, iHeight = pRenderer->iHeight;
-	cairo_data_renderer_get_size (pRenderer, &iWidth, &iHeight);
-	glPushMatrix ();
-	if (pRenderer->bisRotate)
-		glRotatef (90., 0., 0., 1.);
-	
 	if (pRenderer->pEmblems != NULL)
 	{
 		_cairo_dock_enable_texture ();
@@ -188,34 +182,59 @@ void cairo_dock_render_overlays_to_texture (CairoDataRenderer *pRenderer, int iN
 		}
 		_cairo_dock_disable_texture ();
 	}
+}
+
+static void _add_value_text_to_batch (CairoDataRenderer *pRenderer, int iNumValue, int iWidth, int iHeight, CairoDockGLFont *pFont)
+{
+	CairoDataRendererTextParam *pText;
+	pText = &pRenderer->pValuesText[iNumValue];
+	if (pText->fWidth != 0 && pText->fHeight != 0)
+	{
+		cairo_data_renderer_format_value (pRenderer, iNumValue);
+		
+		int w = pText->fWidth * pRenderer->iWidth;
+		int h = pText->fHeight * pRenderer->iHeight;
+		int dw = w & 1;
+		int dh = h & 1;
+		cairo_dock_add_gl_text_to_batch (pRenderer->cFormatBuffer,
+			pFont,
+			floor (pText->fX * iWidth) + .5*dw,
+			floor (pText->fY * iHeight) + .5*dh,
+			w,
+			h,
+			TRUE,
+			pText->pColor);
+	}
+}
+
+void cairo_dock_render_overlays_to_texture (CairoDataRenderer *pRenderer, int iNumValue)
+{
+	cairo_dock_render_all_overlays_to_texture (pRenderer, iNumValue, 1);
+}
+
+void cairo_dock_render_all_overlays_to_texture (CairoDataRenderer *pRenderer, int iFirstValue, int iNbValues)
+{
+	gint iWidth, iHeight;
+	cairo_data_renderer_get_size (pRenderer, &iWidth, &iHeight);
+	glPushMatrix ();
+	if (pRenderer->bisRotate)
+		glRotatef (90., 0., 0., 1.);
 	
-	if (pRenderer->bWriteValues && pRenderer->bCanRenderValueAsText)
+	int i;
+	for (i = iFirstValue; i < iFirstValue + iNbValues; i ++)
 	{
-		CairoDataRendererTextParam *pText;
-		pText = &pRenderer->pValuesText[iNumValue];
-		if (pText->fWidth != 0 && pText->fHeight != 0)
+		_render_emblem_and_label_to_texture (pRenderer, i, iWidth, iHeight);
+	}
+	
+	if (pRenderer->bWriteValues && pRenderer->bCanRenderValueAsText)  // all the values are drawn in 1 go.
+	{
+		CairoDockGLFont *pFont = cairo_dock_get_default_data_renderer_font ();
+		cairo_dock_begin_gl_text_batch (pFont);
+		for (i = iFirstValue; i < iFirstValue + iNbValues; i ++)
 		{
-			cairo_data_renderer_format_value (pRenderer, iNumValue);
-			
-			CairoDockGLFont *pFont = cairo_dock_get_default_data_renderer_font ();
-			glColor3f (pText->pColor[0], pText->pColor[1], pText->pColor[2]);
-			glPushMatrix ();
-			
-			int w = pText->fWidth * pRenderer->iWidth;
-			int h = pText->fHeight * pRenderer->iHeight;
-			int dw = w & 1;
-			int dh = h & 1;
-			cairo_dock_draw_gl_text_at_position_in_area ((guchar *) pRenderer->cFormatBuffer,
-				pFont,
-				floor (pText->fX * iWidth) + .5*dw,
-				floor (pText->fY * iHeight) + .5*dh,
-				w,
-				h,
-				TRUE);
-			
-			glPopMatrix ();
-			glColor3f (1.0, 1.0, 1.0);
+			_add_value_text_to_batch (pRenderer, i, iWidth, iHeight, pFont);
 		}
+		cairo_dock_end_gl_text_batch (pFont);
 	}
 	glPopMatrix ();
 }
@@ -338,7 +357,10 @@ static void _cairo_dock_render_to_context (CairoDataRenderer *pRenderer, Icon *p
 	if (pRenderer->bUseOverlay && pRenderer->pOverlay != NULL)
 		cairo_dock_end_draw_image_buffer_cairo (&pRenderer->pOverlay->image);
 	else
+	{
 		cairo_dock_end_draw_image_buffer_cairo (&pIcon->image);
+		cairo_dock_mark_icon_image_changed (pIcon);
+	}
 	/**if (CAIRO_DOCK_CONTAINER_IS_OPENGL (pContainer))
 	{
 		if (pRenderer->bUseOverlay)
@@ -245,6 +245,13 @@ void cairo_dock_render_overlays_to_context (CairoDataRenderer *pRenderer, int iN
 
 void cairo_dock_render_overlays_to_texture (CairoDataRenderer *pRenderer, int iNumValue);
 
+/** Draw the overlays (emblems, labels and values) of several consecutive values; the values are written with the default font in a single batch.
+*@param pRenderer the data renderer
+*@param iFirstValue index of the first value
+*@param iNbValues number of values to draw
+*/
+void cairo_dock_render_all_overlays_to_texture (CairoDataRenderer *pRenderer, int iFirstValue, int iNbValues);
+
 void cairo_data_renderer_get_size (CairoDataRenderer *pRenderer, gint *iWidth, gint *iHeight);
 
 ///
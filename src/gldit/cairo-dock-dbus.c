@@ -30,6 +30,17 @@ static DBusGProxy *s_pDBusSystemProxy = NULL;
 static GHashTable *s_pFilterTable = NULL;
 static GList *s_pFilterList = NULL;
 
+typedef struct {
+	GHashTable *pNames;  // names currently owned on the bus (as a set); NULL until we got the list.
+	GHashTable *pActivatableNames;  // names that can be activated on the bus; NULL until we got the list.
+	gint64 iActivatableNamesTime;  // when the list of activatable names was got.
+	gboolean bListening;
+	} CairoDockDBusNameRegistry;
+static CairoDockDBusNameRegistry s_SessionNames = {NULL, NULL, 0, FALSE};
+static CairoDockDBusNameRegistry s_SystemNames = {NULL, NULL, 0, FALSE};
+
+#define CD_DBUS_ACTIVATABLE_NAMES_REFRESH_DELAY 2  // s; a service can be installed at any time, and the bus doesn't tell us, so the list is fetched again on a miss, but not more often than that.
+
 DBusGConnection *cairo_dock_get_session_connection (void)
 {
 	if (s_pSessionConnexion == NULL)
@@ -107,6 +118,16 @@ gboolean cairo_dock_dbus_is_enabled (void)
 	return (cairo_dock_get_session_connection () != NULL && cairo_dock_get_system_connection () != NULL);
 }
 
+static void _add_name_owner_changed_signal (DBusGProxy *pProxy)
+{
+	if (g_object_get_data (G_OBJECT (pProxy), "cd-name-owner-changed") != NULL)  // a signal can only be added once to a proxy.
+		return;
+	g_object_set_data (G_OBJECT (pProxy), "cd-name-owner-changed", GINT_TO_POINTER (1));
+	dbus_g_proxy_add_signal (pProxy, "NameOwnerChanged",
+		G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING,
+		G_TYPE_INVALID);
+}
+
 static void on_name_owner_changed (G_GNUC_UNUSED DBusGProxy *pProxy, const gchar *cName, G_GNUC_UNUSED const gchar *cPrevOwner, const gchar *cNewOwner, G_GNUC_UNUSED gpointer data)
 {
 	//g_print ("%s (%s)\n", __func__, cName);
@@ -146,9 +167,7 @@ void cairo_dock_watch_dbus_name_owner (const char *cName, CairoDockDbusNameOwner
 		DBusGProxy *pProxy = cairo_dock_get_main_proxy ();
 		g_return_if_fail (pProxy != NULL);
 		
-		dbus_g_proxy_add_signal (pProxy, "NameOwnerChanged",
-			G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING,
-			G_TYPE_INVALID);
+		_add_name_owner_changed_signal (pProxy);
 		dbus_g_proxy_connect_signal (pProxy, "NameOwnerChanged",
 			G_CALLBACK (on_name_owner_changed),
 			NULL, NULL);
@@ -240,6 +259,158 @@ DBusGProxy *cairo_dock_create_new_system_proxy (const char *name, const char *pa
 		return NULL;
 }
 
+static inline CairoDockDBusNameRegistry *_get_name_registry (DBusGProxy *pProxy)
+{
+	return (pProxy == s_pDBusSystemProxy ? &s_SystemNames : &s_SessionNames);
+}
+
+static GHashTable *_make_name_set (gchar **name_list)
+{
+	GHashTable *pNames = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	int i;
+	for (i = 0; name_list != NULL && name_list[i] != NULL; i ++)
+		g_hash_table_insert (pNames, g_strdup (name_list[i]), GINT_TO_POINTER (1));
+	return pNames;
+}
+
+static void _set_registry_names (CairoDockDBusNameRegistry *pRegistry, gchar **name_list)
+{
+	if (pRegistry->pNames != NULL)  // already up-to-date thanks to the signal.
+		return;
+	pRegistry->pNames = _make_name_set (name_list);
+}
+
+static void _on_registry_name_owner_changed (G_GNUC_UNUSED DBusGProxy *pProxy, const gchar *cName, G_GNUC_UNUSED const gchar *cPrevOwner, const gchar *cNewOwner, CairoDockDBusNameRegistry *pRegistry)
+{
+	if (strcmp (cName, DBUS_SERVICE_DBUS) == 0 && pRegistry->pActivatableNames != NULL)  // the bus has restarted or reloaded, the activatable names may have changed.
+	{
+		g_hash_table_destroy (pRegistry->pActivatableNames);
+		pRegistry->pActivatableNames = NULL;
+	}
+	if (pRegistry->pNames == NULL)  // we'll get the complete list soon.
+		return;
+	if (cNewOwner != NULL && *cNewOwner != '\0')
+		g_hash_table_insert (pRegistry->pNames, g_strdup (cName), GINT_TO_POINTER (1));
+	else
+		g_hash_table_remove (pRegistry->pNames, cName);
+}
+
+static void _on_list_names (DBusGProxy *proxy, DBusGProxyCall *call_id, CairoDockDBusNameRegistry *pRegistry)
+{
+	gchar **name_list = NULL;
+	if (dbus_g_proxy_end_call (proxy,
+		call_id,
+		NULL,
+		G_TYPE_STRV,
+		&name_list,
+		G_TYPE_INVALID))
+		_set_registry_names (pRegistry, name_list);
+	g_strfreev (name_list);
+}
+
+static void _on_list_activatable_names (DBusGProxy *proxy, DBusGProxyCall *call_id, CairoDockDBusNameRegistry *pRegistry)
+{
+	gchar **name_list = NULL;
+	if (dbus_g_proxy_end_call (proxy,
+		call_id,
+		NULL,
+		G_TYPE_STRV,
+		&name_list,
+		G_TYPE_INVALID))
+	{
+		if (pRegistry->pActivatableNames != NULL)
+			g_hash_table_destroy (pRegistry->pActivatableNames);
+		pRegistry->pActivatableNames = _make_name_set (name_list);
+		pRegistry->iActivatableNamesTime = g_get_monotonic_time ();
+	}
+	g_strfreev (name_list);
+}
+
+static void _start_name_registry (DBusGProxy *pProxy, gboolean bListNames)
+{
+	CairoDockDBusNameRegistry *pRegistry = _get_name_registry (pProxy);
+	if (pRegistry->bListening)
+		return;
+	pRegistry->bListening = TRUE;
+	
+	// listen to the changes first, so that we don't miss any of them.
+	_add_name_owner_changed_signal (pProxy);
+	dbus_g_proxy_connect_signal (pProxy, "NameOwnerChanged",
+		G_CALLBACK (_on_registry_name_owner_changed),
+		pRegistry, NULL);
+	
+	// then get the current names.
+	if (bListNames)
+		dbus_g_proxy_begin_call (pProxy, "ListNames",
+			(DBusGProxyCallNotify)_on_list_names,
+			pRegistry,
+			NULL,
+			G_TYPE_INVALID);
+	dbus_g_proxy_begin_call (pProxy, "ListActivatableNames",
+		(DBusGProxyCallNotify)_on_list_activatable_names,
+		pRegistry,
+		NULL,
+		G_TYPE_INVALID);
+}
+
+static gboolean _name_is_in_set (GHashTable *pNames, const gchar *cName)
+{
+	int n = strlen (cName);
+	if (n != 0 && cName[n-1] == '*')  // look for a prefix
+	{
+		GHashTableIter iter;
+		gpointer key;
+		g_hash_table_iter_init (&iter, pNames);
+		while (g_hash_table_iter_next (&iter, &key, NULL))
+		{
+			if (strncmp (key, cName, n-1) == 0)
+				return TRUE;
+		}
+		return FALSE;
+	}
+	return (g_hash_table_lookup (pNames, cName) != NULL);
+}
+
+static void _list_activatable_names (DBusGProxy *pProxy, CairoDockDBusNameRegistry *pRegistry)
+{
+	gchar **name_list = NULL;
+	if (dbus_g_proxy_call (pProxy, "ListActivatableNames", NULL,
+		G_TYPE_INVALID,
+		G_TYPE_STRV,
+		&name_list,
+		G_TYPE_INVALID))
+	{
+		if (pRegistry->pActivatableNames != NULL)
+			g_hash_table_destroy (pRegistry->pActivatableNames);
+		pRegistry->pActivatableNames = _make_name_set (name_list);
+		pRegistry->iActivatableNamesTime = g_get_monotonic_time ();
+	}
+	g_strfreev (name_list);
+}
+
+gboolean cairo_dock_dbus_name_is_activatable (const gchar *cName)
+{
+	g_return_val_if_fail (cName != NULL, FALSE);
+	DBusGProxy *pProxy = cairo_dock_get_main_proxy ();
+	g_return_val_if_fail (pProxy != NULL, FALSE);
+	CairoDockDBusNameRegistry *pRegistry = _get_name_registry (pProxy);
+	if (pRegistry->pActivatableNames == NULL)
+	{
+		_list_activatable_names (pProxy, pRegistry);
+		_start_name_registry (pProxy, TRUE);
+		if (pRegistry->pActivatableNames == NULL)
+			return FALSE;
+	}
+	if (_name_is_in_set (pRegistry->pActivatableNames, cName))
+		return TRUE;
+	
+	// not found: the service may have been installed since we got the list.
+	if (g_get_monotonic_time () - pRegistry->iActivatableNamesTime < CD_DBUS_ACTIVATABLE_NAMES_REFRESH_DELAY * G_USEC_PER_SEC)
+		return FALSE;
+	_list_activatable_names (pProxy, pRegistry);
+	return (pRegistry->pActivatableNames != NULL && _name_is_in_set (pRegistry->pActivatableNames, cName));
+}
+
 static void _on_detect_application (DBusGProxy *proxy, DBusGProxyCall *call_id, gpointer *data)
 {
 	CairoDockOnAppliPresentOnDbus pCallback = data[0];
@@ -253,35 +424,11 @@ static void _on_detect_application (DBusGProxy *proxy, DBusGProxyCall *call_id,
 		&name_list,
 		G_TYPE_INVALID);
 	
-	gboolean bPresent = FALSE;
 	cd_message ("detection du service %s (%d)...", cName, bSuccess);
-	if (bSuccess && name_list)
-	{
-		int i;
-		int n = strlen(cName);
-		if (cName[n-1] == '*')
-		{
-			for (i = 0; name_list[i] != NULL; i ++)
-			{
-				if (strncmp (name_list[i], cName, n) == 0)
-				{
-					bPresent = TRUE;
-					break;
-				}
-			}
-		}
-		else
-		{
-			for (i = 0; name_list[i] != NULL; i ++)
-			{
-				if (strcmp (name_list[i], cName) == 0)
-				{
-					bPresent = TRUE;
-					break;
-				}
-			}
-		}
-	}
+	CairoDockDBusNameRegistry *pRegistry = _get_name_registry (proxy);
+	if (bSuccess)  // we got the list anyway, so let's fill the registry with it.
+		_set_registry_names (pRegistry, name_list);
+	gboolean bPresent = (pRegistry->pNames != NULL && _name_is_in_set (pRegistry->pNames, cName));
 	
 	pCallback (bPresent, user_data);
 	
@@ -289,6 +436,23 @@ static void _on_detect_application (DBusGProxy *proxy, DBusGProxyCall *call_id,
 	g_free (cName);
 	data[2] = NULL;
 }
+static void _on_detect_application_in_registry (DBusGProxy *proxy, DBusGProxyCall *call_id, gpointer *data)
+{
+	CairoDockOnAppliPresentOnDbus pCallback = data[0];
+	gpointer user_data = data[1];
+	gchar *cName = data[2];
+	gchar *cId = NULL;
+	dbus_g_proxy_end_call (proxy,
+		call_id,
+		NULL,
+		G_TYPE_STRING,
+		&cId,
+		G_TYPE_INVALID);
+	g_free (cId);
+	
+	CairoDockDBusNameRegistry *pRegistry = _get_name_registry (proxy);  // the signals that came before the reply have been processed, so it's up-to-date.
+	pCallback (pRegistry->pNames != NULL && _name_is_in_set (pRegistry->pNames, cName), user_data);
+}
 static void _free_detect_application (gpointer *data)
 {
 	cd_debug ("free detection data\n");
@@ -302,6 +466,16 @@ static inline DBusGProxyCall *_dbus_detect_application_async (const gchar *cName
 	data[0] = pCallback;
 	data[1] = user_data;
 	data[2] = g_strdup (cName);
+	
+	CairoDockDBusNameRegistry *pRegistry = _get_name_registry (pProxy);
+	if (pRegistry->pNames != NULL)  // no need to list the names, the registry will answer; a trivial call still defers the answer and gives a pending call that can be cancelled.
+		return dbus_g_proxy_begin_call (pProxy, "GetId",
+			(DBusGProxyCallNotify)_on_detect_application_in_registry,
+			data,
+			(GDestroyNotify) _free_detect_application,
+			G_TYPE_INVALID);
+	_start_name_registry (pProxy, FALSE);  // the reply to our call will fill it.
+	
 	DBusGProxyCall* pCall= dbus_g_proxy_begin_call (pProxy, "ListNames",
 		(DBusGProxyCallNotify)_on_detect_application,
 		data,
@@ -328,28 +502,23 @@ static inline gboolean _dbus_detect_application (const gchar *cName, DBusGProxy
 {
 	g_return_val_if_fail (cName != NULL && pProxy != NULL, FALSE);
 	
-	gchar **name_list = NULL;
-	gboolean bPresent = FALSE;
-	
-	if(dbus_g_proxy_call (pProxy, "ListNames", NULL,
-		G_TYPE_INVALID,
-		G_TYPE_STRV,
-		&name_list,
-		G_TYPE_INVALID))
+	CairoDockDBusNameRegistry *pRegistry = _get_name_registry (pProxy);
+	if (pRegistry->pNames == NULL)  // first time: get the list of names once, the registry will then follow the changes.
 	{
-		cd_message ("detection du service %s ...", cName);
-		int i;
-		for (i = 0; name_list[i] != NULL; i ++)
-		{
-			if (strcmp (name_list[i], cName) == 0)
-			{
-				bPresent = TRUE;
-				break;
-			}
-		}
+		_start_name_registry (pProxy, FALSE);
+		gchar **name_list = NULL;
+		if(dbus_g_proxy_call (pProxy, "ListNames", NULL,
+			G_TYPE_INVALID,
+			G_TYPE_STRV,
+			&name_list,
+			G_TYPE_INVALID))
+			_set_registry_names (pRegistry, name_list);
+		g_strfreev (name_list);
+		if (pRegistry->pNames == NULL)
+			return FALSE;
 	}
-	g_strfreev (name_list);
-	return bPresent;
+	cd_message ("detection du service %s ...", cName);
+	return _name_is_in_set (pRegistry->pNames, cName);
 }
 
 gboolean cairo_dock_dbus_detect_application (const gchar *cName)
@@ -370,13 +539,31 @@ gboolean cairo_dock_dbus_detect_system_application (const gchar *cName)
 gchar **cairo_dock_dbus_get_services (void)
 {
 	DBusGProxy *pProxy = cairo_dock_get_main_proxy ();
+	g_return_val_if_fail (pProxy != NULL, NULL);
+	CairoDockDBusNameRegistry *pRegistry = _get_name_registry (pProxy);
+	if (pRegistry->pNames != NULL)
+	{
+		gchar **name_list = g_new0 (gchar*, g_hash_table_size (pRegistry->pNames) + 1);
+		GHashTableIter iter;
+		gpointer key;
+		int i = 0;
+		g_hash_table_iter_init (&iter, pRegistry->pNames);
+		while (g_hash_table_iter_next (&iter, &key, NULL))
+			name_list[i++] = g_strdup (key);
+		return name_list;
+	}
+	
+	_start_name_registry (pProxy, FALSE);
 	gchar **name_list = NULL;
 	if(dbus_g_proxy_call (pProxy, "ListNames", NULL,
 		G_TYPE_INVALID,
 		G_TYPE_STRV,
 		&name_list,
 		G_TYPE_INVALID))
+	{
+		_set_registry_names (pRegistry, name_list);
 		return name_list;
+	}
 	else
 		return NULL;
 }
@@ -547,8 +734,217 @@ void cairo_dock_dbus_get_properties (DBusGProxy *pDbusProxy, const gchar *cComma
 
 
 
+  ///////////////////////
+ /// PROPERTIES CACHE ///
+///////////////////////
+
+typedef struct {
+	gchar *cKey;
+	gchar *cInterface;
+	DBusGProxy *pProxy;  // our own proxy on the 'Properties' interface of the object.
+	DBusGProxyCall *pGetAllCall;
+	GHashTable *pProperties;  // property name -> GValue*
+	gint iRefCount;
+	} CairoDockDBusPropertiesCache;
+
+static GHashTable *s_pPropertiesCaches = NULL;  // "name|path|interface" -> cache
+static guint s_iNbCachedReads = 0;
+static guint s_iNbUncachedReads = 0;
+
+static gchar *_get_cache_key (DBusGProxy *pDbusProxy, const gchar *cInterface)
+{
+	return g_strdup_printf ("%s|%s|%s", dbus_g_proxy_get_bus_name (pDbusProxy), dbus_g_proxy_get_path (pDbusProxy), cInterface);
+}
+
+static inline CairoDockDBusPropertiesCache *_get_properties_cache (DBusGProxy *pDbusProxy, const gchar *cInterface)
+{
+	if (s_pPropertiesCaches == NULL || pDbusProxy == NULL || cInterface == NULL)
+		return NULL;
+	gchar *cKey = _get_cache_key (pDbusProxy, cInterface);
+	CairoDockDBusPropertiesCache *pCache = g_hash_table_lookup (s_pPropertiesCaches, cKey);
+	g_free (cKey);
+	return pCache;
+}
+
+static void _free_gvalue (GValue *v)
+{
+	g_value_unset (v);
+	g_free (v);
+}
+
+static void _insert_property (const gchar *cProperty, const GValue *pValue, GHashTable *pProperties)
+{
+	GValue *v = g_new0 (GValue, 1);
+	g_value_init (v, G_VALUE_TYPE (pValue));
+	g_value_copy (pValue, v);
+	g_hash_table_insert (pProperties, g_strdup (cProperty), v);
+}
+
+static void _on_properties_changed (G_GNUC_UNUSED DBusGProxy *proxy, const gchar *cInterface, GHashTable *pChangedProps, gchar **cInvalidatedProps, CairoDockDBusPropertiesCache *pCache)
+{
+	if (g_strcmp0 (cInterface, pCache->cInterface) != 0)
+		return;
+	if (pChangedProps != NULL)
+		g_hash_table_foreach (pChangedProps, (GHFunc)_insert_property, pCache->pProperties);
+	if (cInvalidatedProps != NULL)  // these ones will be fetched again on the next read.
+	{
+		int i;
+		for (i = 0; cInvalidatedProps[i] != NULL; i ++)
+			g_hash_table_remove (pCache->pProperties, cInvalidatedProps[i]);
+	}
+}
+
+static void _on_get_all_properties (DBusGProxy *proxy, DBusGProxyCall *call_id, CairoDockDBusPropertiesCache *pCache)
+{
+	GError *erreur = NULL;
+	GHashTable *hProperties = NULL;
+	pCache->pGetAllCall = NULL;
+	dbus_g_proxy_end_call (proxy,
+		call_id,
+		&erreur,
+		dbus_g_type_get_map ("GHashTable", G_TYPE_STRING, G_TYPE_VALUE), &hProperties,
+		G_TYPE_INVALID);
+	if (erreur != NULL)
+	{
+		cd_warning ("couldn't get the properties of %s: %s", pCache->cKey, erreur->message);
+		g_error_free (erreur);
+		return;
+	}
+	if (hProperties != NULL)
+	{
+		g_hash_table_foreach (hProperties, (GHFunc)_insert_property, pCache->pProperties);
+		g_hash_table_unref (hProperties);
+	}
+}
+
+static void _fetch_all_properties (CairoDockDBusPropertiesCache *pCache)
+{
+	pCache->pGetAllCall = dbus_g_proxy_begin_call (pCache->pProxy, "GetAll",
+		(DBusGProxyCallNotify)_on_get_all_properties,
+		pCache,
+		NULL,
+		G_TYPE_STRING, pCache->cInterface,
+		G_TYPE_INVALID);
+}
+
+static void _on_cached_name_owner_changed (G_GNUC_UNUSED DBusGProxy *pProxy, const gchar *cName, G_GNUC_UNUSED const gchar *cPrevOwner, const gchar *cNewOwner, G_GNUC_UNUSED gpointer data)
+{
+	// the service has quit or has been replaced: its properties are not valid any more.
+	GHashTableIter iter;
+	CairoDockDBusPropertiesCache *pCache;
+	g_hash_table_iter_init (&iter, s_pPropertiesCaches);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer*)&pCache))
+	{
+		if (g_strcmp0 (dbus_g_proxy_get_bus_name (pCache->pProxy), cName) != 0)
+			continue;
+		cd_debug ("%s has a new owner, drop its properties", pCache->cKey);
+		if (pCache->pGetAllCall != NULL)
+		{
+			dbus_g_proxy_cancel_call (pCache->pProxy, pCache->pGetAllCall);
+			pCache->pGetAllCall = NULL;
+		}
+		g_hash_table_remove_all (pCache->pProperties);
+		if (cNewOwner != NULL && *cNewOwner != '\0')
+			_fetch_all_properties (pCache);
+	}
+}
+
+static void _watch_cached_names (DBusGProxy *pProxy)
+{
+	if (pProxy == NULL)
+		return;
+	_add_name_owner_changed_signal (pProxy);
+	dbus_g_proxy_connect_signal (pProxy, "NameOwnerChanged",
+		G_CALLBACK (_on_cached_name_owner_changed),
+		NULL, NULL);
+}
+
+void cairo_dock_dbus_cache_properties (DBusGProxy *pDbusProxy, const gchar *cInterface)
+{
+	g_return_if_fail (pDbusProxy != NULL && cInterface != NULL);
+	if (s_pPropertiesCaches == NULL)
+	{
+		s_pPropertiesCaches = g_hash_table_new (g_str_hash, g_str_equal);  // keys belong to the caches.
+		dbus_g_object_register_marshaller (g_cclosure_marshal_generic,
+			G_TYPE_NONE, G_TYPE_STRING, dbus_g_type_get_map ("GHashTable", G_TYPE_STRING, G_TYPE_VALUE), G_TYPE_STRV,
+			G_TYPE_INVALID);
+		_watch_cached_names (cairo_dock_get_main_proxy ());  // we can't tell on which bus a proxy is, so watch both; a service with the same name on the other bus would only cost a useless refresh.
+		_watch_cached_names (cairo_dock_get_main_system_proxy ());
+	}
+	
+	CairoDockDBusPropertiesCache *pCache = _get_properties_cache (pDbusProxy, cInterface);
+	if (pCache != NULL)
+	{
+		pCache->iRefCount ++;
+		return;
+	}
+	
+	pCache = g_new0 (CairoDockDBusPropertiesCache, 1);
+	pCache->cKey = _get_cache_key (pDbusProxy, cInterface);
+	pCache->cInterface = g_strdup (cInterface);
+	pCache->iRefCount = 1;
+	pCache->pProperties = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify)_free_gvalue);
+	pCache->pProxy = dbus_g_proxy_new_from_proxy (pDbusProxy, DBUS_INTERFACE_PROPERTIES, NULL);
+	g_hash_table_insert (s_pPropertiesCaches, pCache->cKey, pCache);
+	
+	// keep the cache up-to-date.
+	dbus_g_proxy_add_signal (pCache->pProxy, "PropertiesChanged",
+		G_TYPE_STRING, dbus_g_type_get_map ("GHashTable", G_TYPE_STRING, G_TYPE_VALUE), G_TYPE_STRV,
+		G_TYPE_INVALID);
+	dbus_g_proxy_connect_signal (pCache->pProxy, "PropertiesChanged",
+		G_CALLBACK (_on_properties_changed),
+		pCache, NULL);
+	
+	// fill it with all the properties in one call.
+	_fetch_all_properties (pCache);
+}
+
+void cairo_dock_dbus_uncache_properties (DBusGProxy *pDbusProxy, const gchar *cInterface)
+{
+	CairoDockDBusPropertiesCache *pCache = _get_properties_cache (pDbusProxy, cInterface);
+	g_return_if_fail (pCache != NULL);
+	pCache->iRefCount --;
+	if (pCache->iRefCount > 0)
+		return;
+	
+	g_hash_table_remove (s_pPropertiesCaches, pCache->cKey);
+	if (pCache->pGetAllCall != NULL)
+		dbus_g_proxy_cancel_call (pCache->pProxy, pCache->pGetAllCall);
+	dbus_g_proxy_disconnect_signal (pCache->pProxy, "PropertiesChanged",
+		G_CALLBACK (_on_properties_changed),
+		pCache);
+	g_object_unref (pCache->pProxy);
+	g_hash_table_destroy (pCache->pProperties);
+	g_free (pCache->cInterface);
+	g_free (pCache->cKey);
+	g_free (pCache);
+}
+
+void cairo_dock_dbus_get_properties_cache_stats (guint *iNbCachedReads, guint *iNbUncachedReads)
+{
+	if (iNbCachedReads)
+		*iNbCachedReads = s_iNbCachedReads;
+	if (iNbUncachedReads)
+		*iNbUncachedReads = s_iNbUncachedReads;
+}
+
 void cairo_dock_dbus_get_property_in_value_with_timeout (DBusGProxy *pDbusProxy, const gchar *cInterface, const gchar *cProperty, GValue *pProperty, gint iTimeOut)
 {
+	// if the properties of this object are cached, serve the value locally.
+	CairoDockDBusPropertiesCache *pCache = _get_properties_cache (pDbusProxy, cInterface);
+	if (pCache != NULL)
+	{
+		GValue *v = g_hash_table_lookup (pCache->pProperties, cProperty);
+		if (v != NULL)
+		{
+			s_iNbCachedReads ++;
+			g_value_init (pProperty, G_VALUE_TYPE (v));
+			g_value_copy (v, pProperty);
+			return;
+		}
+	}
+	s_iNbUncachedReads ++;
+	
 	GError *erreur=NULL;
 	
 	dbus_g_proxy_call_with_timeout (pDbusProxy, "Get", iTimeOut, &erreur,
@@ -563,6 +959,10 @@ void cairo_dock_dbus_get_property_in_value_with_timeout (DBusGProxy *pDbusProxy,
 		cd_warning (erreur->message);
 		g_error_free (erreur);
 	}
+	else if (pCache != NULL && G_IS_VALUE (pProperty))  // not received yet, or invalidated; keep it for the next time.
+	{
+		_insert_property (cProperty, pProperty, pCache->pProperties);
+	}
 }
 
 gboolean cairo_dock_dbus_get_property_as_boolean_with_timeout (DBusGProxy *pDbusProxy, const gchar *cInterface, const gchar *cProperty, gint iTimeOut)
@@ -669,6 +1069,16 @@ gchar **cairo_dock_dbus_get_property_as_string_list_with_timeout (DBusGProxy *pD
 
 GHashTable *cairo_dock_dbus_get_all_properties_with_timeout (DBusGProxy *pDbusProxy, const gchar *cInterface, gint iTimeOut)
 {
+	CairoDockDBusPropertiesCache *pCache = _get_properties_cache (pDbusProxy, cInterface);
+	if (pCache != NULL && pCache->pGetAllCall == NULL && g_hash_table_size (pCache->pProperties) != 0)
+	{
+		s_iNbCachedReads ++;
+		GHashTable *hProperties = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify)_free_gvalue);
+		g_hash_table_foreach (pCache->pProperties, (GHFunc)_insert_property, hProperties);
+		return hProperties;
+	}
+	s_iNbUncachedReads ++;
+	
 	GError *erreur=NULL;
 	GHashTable *hProperties = NULL;
 	
@@ -707,6 +1117,12 @@ void cairo_dock_dbus_set_property_with_timeout (DBusGProxy *pDbusProxy, const gc
 		cd_warning (erreur->message);
 		g_error_free (erreur);
 	}
+	else
+	{
+		CairoDockDBusPropertiesCache *pCache = _get_properties_cache (pDbusProxy, cInterface);
+		if (pCache != NULL)  // don't wait for the 'PropertiesChanged' signal (some services don't emit it).
+			_insert_property (cProperty, pProperty, pCache->pProperties);
+	}
 }
 
 void cairo_dock_dbus_set_boolean_property_with_timeout (DBusGProxy *pDbusProxy, const gchar *cInterface, const gchar *cProperty, gboolean bValue, gint iTimeOut)
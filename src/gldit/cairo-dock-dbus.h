@@ -82,12 +82,18 @@ DBusGProxy *cairo_dock_create_new_system_proxy (const char *name, const char *pa
 
 typedef void (*CairoDockOnAppliPresentOnDbus) (gboolean bPresent, gpointer data);
 
+/** Detect asynchronously if an application is currently running on Session bus. Once the list of names on the bus is known, the answer comes from it and the bus is not listed again.
+*@param cName name of the application; it can end with a '*' to look for a prefix.
+*@param pCallback function called with the result; it's always called after this function returns.
+*@param user_data data passed to the callback.
+*@return the pending call, that can be cancelled.
+*/
 DBusGProxyCall *cairo_dock_dbus_detect_application_async (const gchar *cName, CairoDockOnAppliPresentOnDbus pCallback, gpointer user_data);
 
 DBusGProxyCall *cairo_dock_dbus_detect_system_application_async (const gchar *cName, CairoDockOnAppliPresentOnDbus pCallback, gpointer user_data);
 
 /** Detect if an application is currently running on Session bus.
-*@param cName name of the application.
+*@param cName name of the application; it can end with a '*' to look for a prefix.
 *@return TRUE if the application is running and has a service on the bus.
 */
 gboolean cairo_dock_dbus_detect_application (const gchar *cName);
@@ -99,8 +105,17 @@ gboolean cairo_dock_dbus_detect_application (const gchar *cName);
 gboolean cairo_dock_dbus_detect_system_application (const gchar *cName);
 
 
+/** Get the list of names currently owned on the Session bus. The list is kept up-to-date locally, so this doesn't need a call on the bus.
+*@return the names, to be freed with g_strfreev.
+*/
 gchar **cairo_dock_dbus_get_services (void);
 
+/** Say if a service can be activated on the Session bus (i.e. if its application will be launched when calling it).
+*@param cName name of the service; it can end with a '*' to look for a prefix.
+*@return TRUE if the name is activatable.
+*/
+gboolean cairo_dock_dbus_name_is_activatable (const gchar *cName);
+
 /** Get the value of a 'boolean' parameter on the bus.
 *@param pDbusProxy proxy to the connection.
 *@param cAccessor name of the accessor.
@@ -156,6 +171,25 @@ void cairo_dock_dbus_call (DBusGProxy *pDbusProxy, const gchar *cCommand);
 
 void cairo_dock_dbus_get_properties (DBusGProxy *pDbusProxy, const gchar *cCommand, const gchar *cInterface, const gchar *cProperty, GValue *vProperties);  /// deprecated...
 
+/** Keep a local copy of all the properties of an interface of an object. The properties are fetched asynchronously with a single 'GetAll' call, and are then kept up-to-date with the 'PropertiesChanged' signal; they are fetched again if the service restarts or changes owner. From then on, the cairo_dock_dbus_get_property_* functions (and cairo_dock_dbus_get_all_properties) called on a proxy to this object don't need a round-trip on the bus anymore.
+* The cache is shared between all the callers, and is freed when each of them has called \ref cairo_dock_dbus_uncache_properties.
+*@param pDbusProxy proxy to the object (on the 'org.freedesktop.DBus.Properties' interface).
+*@param cInterface name of the interface which properties should be cached.
+*/
+void cairo_dock_dbus_cache_properties (DBusGProxy *pDbusProxy, const gchar *cInterface);
+
+/** Release the cache of properties created by \ref cairo_dock_dbus_cache_properties.
+*@param pDbusProxy proxy to the object.
+*@param cInterface name of the interface.
+*/
+void cairo_dock_dbus_uncache_properties (DBusGProxy *pDbusProxy, const gchar *cInterface);
+
+/** Get the number of property reads that were served by the cache, and the number of those that needed a call on the bus.
+*@param iNbCachedReads returns the number of reads served locally.
+*@param iNbUncachedReads returns the number of reads that made a round-trip.
+*/
+void cairo_dock_dbus_get_properties_cache_stats (guint *iNbCachedReads, guint *iNbUncachedReads);
+
 #define cairo_dock_dbus_get_property_in_value(pDbusProxy, cInterface, cProperty, pProperties) cairo_dock_dbus_get_property_in_value_with_timeout(pDbusProxy, cInterface, cProperty, pProperties, -1)
 void cairo_dock_dbus_get_property_in_value_with_timeout (DBusGProxy *pDbusProxy, const gchar *cInterface, const gchar *cProperty, GValue *pProperty, gint iTimeOut);
 
@@ -195,7 +195,8 @@ struct _CairoDesklet {
 	guint time;  // date du clic.
 	
 	CairoDeskletVisibility iVisibility;
-	gpointer reserved[4];
+	gpointer pPickingCache;  // private: transformation used to pick the icons in OpenGL.
+	gpointer reserved[3];
 };
 
 /** Say if an object is a Desklet.
@@ -38,6 +38,7 @@
 #include "cairo-dock-module-instance-manager.h"  // gldi_module_instance_open_conf_file
 #include "cairo-dock-config.h"
 #include "cairo-dock-icon-facility.h"  // cairo_dock_set_icon_container
+#include "cairo-dock-icon-factory.h"  // cairo_dock_create_dummy_launcher
 #include "cairo-dock-desktop-manager.h"
 #include "cairo-dock-log.h"
 #include "cairo-dock-container.h"
@@ -268,38 +269,102 @@ static void _render_desklet_cairo (CairoDesklet *pDesklet, cairo_t *pCairoContex
 	cairo_restore (pCairoContext);
 }
 
-static inline void _set_desklet_matrix (CairoDesklet *pDesklet)
+static void _matrix_mult (gdouble *m, const gdouble *n)  // m <- m * n, like glMultMatrix
+{
+	gdouble r[16];
+	int i, j, k;
+	for (i = 0; i < 4; i ++)  // column
+		for (j = 0; j < 4; j ++)  // row
+		{
+			r[4*i+j] = 0;
+			for (k = 0; k < 4; k ++)
+				r[4*i+j] += m[4*k+j] * n[4*i+k];
+		}
+	memcpy (m, r, sizeof (r));
+}
+
+static void _matrix_translate (gdouble *m, double x, double y, double z)
+{
+	gdouble t[16] = {1,0,0,0, 0,1,0,0, 0,0,1,0, x,y,z,1};
+	_matrix_mult (m, t);
+}
+
+static void _matrix_scale (gdouble *m, double x, double y, double z)
+{
+	gdouble t[16] = {x,0,0,0, 0,y,0,0, 0,0,z,0, 0,0,0,1};
+	_matrix_mult (m, t);
+}
+
+static void _matrix_rotate (gdouble *m, double fAngle, double x, double y, double z)  // angle in degrees, (x,y,z) normalized, like glRotate
+{
+	double a = fAngle * G_PI / 180., c = cos (a), s = sin (a);
+	gdouble t[16] = {
+		x*x*(1-c)+c,   y*x*(1-c)+z*s, x*z*(1-c)-y*s, 0,
+		x*y*(1-c)-z*s, y*y*(1-c)+c,   y*z*(1-c)+x*s, 0,
+		x*z*(1-c)+y*s, y*z*(1-c)-x*s, z*z*(1-c)+c,   0,
+		0, 0, 0, 1};
+	_matrix_mult (m, t);
+}
+
+// the transformations of a desklet (m <- m * T), shared by the rendering and the picking.
+static void _compute_desklet_matrix (CairoDesklet *pDesklet, gdouble *m)
 {
 	double fDepthRotationY = (fabs (pDesklet->fDepthRotationY) > ANGLE_MIN ? pDesklet->fDepthRotationY : 0.);
 	double fDepthRotationX = (fabs (pDesklet->fDepthRotationX) > ANGLE_MIN ? pDesklet->fDepthRotationX : 0.);
-	glTranslatef (0., 0., -pDesklet->container.iHeight * sqrt(3)/2 - 
+	_matrix_translate (m, 0., 0., -pDesklet->container.iHeight * sqrt(3)/2 - 
 		.45 * MAX (pDesklet->container.iWidth * fabs (sin (fDepthRotationY)),
 			pDesklet->container.iHeight * fabs (sin (fDepthRotationX)))
 		);  // avec 60 deg de perspective
 	
 	if (pDesklet->container.fRatio != 1)
 	{
-		glScalef (pDesklet->container.fRatio, pDesklet->container.fRatio, 1.);
+		_matrix_scale (m, pDesklet->container.fRatio, pDesklet->container.fRatio, 1.);
 	}
 	
 	if (fabs (pDesklet->fRotation) > ANGLE_MIN)
 	{
 		double fZoom = _compute_zoom_for_rotation (pDesklet);
-		glScalef (fZoom, fZoom, 1.);
-		glRotatef (- pDesklet->fRotation / G_PI * 180., 0., 0., 1.);
+		_matrix_scale (m, fZoom, fZoom, 1.);
+		_matrix_rotate (m, - pDesklet->fRotation / G_PI * 180., 0., 0., 1.);
 	}
 	
 	if (fDepthRotationY != 0)
 	{
-		glRotatef (- pDesklet->fDepthRotationY / G_PI * 180., 0., 1., 0.);
+		_matrix_rotate (m, - pDesklet->fDepthRotationY / G_PI * 180., 0., 1., 0.);
 	}
 	
 	if (fDepthRotationX != 0)
 	{
-		glRotatef (- pDesklet->fDepthRotationX / G_PI * 180., 1., 0., 0.);
+		_matrix_rotate (m, - pDesklet->fDepthRotationX / G_PI * 180., 1., 0., 0.);
+	}
+}
+
+// the area reserved around the renderer's drawing (m <- m * T).
+static void _compute_surface_offsets_matrix (CairoDesklet *pDesklet, gdouble *m)
+{
+	if (pDesklet->iLeftSurfaceOffset != 0 || pDesklet->iTopSurfaceOffset != 0 || pDesklet->iRightSurfaceOffset != 0 || pDesklet->iBottomSurfaceOffset != 0)
+	{
+		_matrix_translate (m, (pDesklet->iLeftSurfaceOffset - pDesklet->iRightSurfaceOffset)/2, (pDesklet->iBottomSurfaceOffset - pDesklet->iTopSurfaceOffset)/2, 0.);
+		_matrix_scale (m, 1. - (double)(pDesklet->iLeftSurfaceOffset + pDesklet->iRightSurfaceOffset) / pDesklet->container.iWidth,
+			1. - (double)(pDesklet->iTopSurfaceOffset + pDesklet->iBottomSurfaceOffset) / pDesklet->container.iHeight,
+			1.);
 	}
 }
 
+static inline void _set_desklet_matrix (CairoDesklet *pDesklet)
+{
+	gdouble m[16] = {1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1};
+	_compute_desklet_matrix (pDesklet, m);
+	glMultMatrixd (m);
+}
+
+static inline void _set_surface_offsets_matrix (CairoDesklet *pDesklet)
+{
+	gdouble m[16] = {1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1};
+	_compute_surface_offsets_matrix (pDesklet, m);
+	glMultMatrixd (m);
+}
+
 static void _render_desklet_opengl (CairoDesklet *pDesklet)
 {
 	gboolean bUseDefaultColors = pDesklet->bUseDefaultColors;
@@ -327,13 +392,7 @@ static void _render_desklet_opengl (CairoDesklet *pDesklet)
 	}
 	
 	glPushMatrix ();
-	if (pDesklet->iLeftSurfaceOffset != 0 || pDesklet->iTopSurfaceOffset != 0 || pDesklet->iRightSurfaceOffset != 0 || pDesklet->iBottomSurfaceOffset != 0)
-	{
-		glTranslatef ((pDesklet->iLeftSurfaceOffset - pDesklet->iRightSurfaceOffset)/2, (pDesklet->iBottomSurfaceOffset - pDesklet->iTopSurfaceOffset)/2, 0.);
-		glScalef (1. - (double)(pDesklet->iLeftSurfaceOffset + pDesklet->iRightSurfaceOffset) / pDesklet->container.iWidth,
-			1. - (double)(pDesklet->iTopSurfaceOffset + pDesklet->iBottomSurfaceOffset) / pDesklet->container.iHeight,
-			1.);
-	}
+	_set_surface_offsets_matrix (pDesklet);
 	
 	if (pDesklet->pRenderer != NULL && pDesklet->pRenderer->render_opengl != NULL)  // un moteur de rendu specifique a ete fourni.
 	{
@@ -461,6 +520,136 @@ static gboolean _on_update_desklet_notification (G_GNUC_UNUSED gpointer data, Ca
 	return GLDI_NOTIFICATION_LET_PASS;
 }
 
+  ///////////////
+ /// PICKING ///
+///////////////
+
+// The icons of an OpenGL desklet are picked by projecting their quads on the screen with the same transformations as the rendering, and testing the pointer against them. The projection only depends on the geometry of the desklet, so it is computed once and cached until the geometry changes; a mouse event then costs a few operations per icon, without any round-trip to the GPU.
+// The GL_SELECT picking is still used for the renderers that draw their own bounding box (they name their objects themselves). Both pickers are compared by gldi_desklets_check_picking().
+
+typedef struct {
+	// the geometry the matrix was computed for
+	gint iWidth, iHeight;
+	gdouble fRatio;
+	gdouble fRotation, fDepthRotationY, fDepthRotationX;
+	gint iLeftSurfaceOffset, iTopSurfaceOffset, iRightSurfaceOffset, iBottomSurfaceOffset;
+	// projection * modelview, column-major like OpenGL
+	gdouble m[16];
+	} CDDeskletPickingCache;
+
+// same transformations as the rendering: gluPerspective, then the desklet's own ones.
+static void _compute_picking_matrix (CairoDesklet *pDesklet, gdouble *m)
+{
+	double fAspect = (double)pDesklet->container.iWidth / pDesklet->container.iHeight;
+	double fNear = 1., fFar = 4 * pDesklet->container.iHeight;
+	double f = 1. / tan (G_PI / 6);  // 60 deg of fovy
+	gdouble p[16] = {
+		f / fAspect, 0, 0, 0,
+		0, f, 0, 0,
+		0, 0, (fFar + fNear) / (fNear - fFar), -1,
+		0, 0, 2 * fFar * fNear / (fNear - fFar), 0};
+	memcpy (m, p, sizeof (p));
+	
+	_compute_desklet_matrix (pDesklet, m);
+	_compute_surface_offsets_matrix (pDesklet, m);
+	_matrix_translate (m, -pDesklet->container.iWidth/2, -pDesklet->container.iHeight/2, 0.);
+}
+
+static CDDeskletPickingCache *_get_picking_cache (CairoDesklet *pDesklet)
+{
+	CDDeskletPickingCache *pCache = pDesklet->pPickingCache;
+	if (pCache == NULL)
+	{
+		pCache = g_new0 (CDDeskletPickingCache, 1);
+		pDesklet->pPickingCache = pCache;
+	}
+	else if (pCache->iWidth == pDesklet->container.iWidth
+	&& pCache->iHeight == pDesklet->container.iHeight
+	&& pCache->fRatio == pDesklet->container.fRatio
+	&& pCache->fRotation == pDesklet->fRotation
+	&& pCache->fDepthRotationY == pDesklet->fDepthRotationY
+	&& pCache->fDepthRotationX == pDesklet->fDepthRotationX
+	&& pCache->iLeftSurfaceOffset == pDesklet->iLeftSurfaceOffset
+	&& pCache->iTopSurfaceOffset == pDesklet->iTopSurfaceOffset
+	&& pCache->iRightSurfaceOffset == pDesklet->iRightSurfaceOffset
+	&& pCache->iBottomSurfaceOffset == pDesklet->iBottomSurfaceOffset)
+		return pCache;  // still valid
+	
+	pCache->iWidth = pDesklet->container.iWidth;
+	pCache->iHeight = pDesklet->container.iHeight;
+	pCache->fRatio = pDesklet->container.fRatio;
+	pCache->fRotation = pDesklet->fRotation;
+	pCache->fDepthRotationY = pDesklet->fDepthRotationY;
+	pCache->fDepthRotationX = pDesklet->fDepthRotationX;
+	pCache->iLeftSurfaceOffset = pDesklet->iLeftSurfaceOffset;
+	pCache->iTopSurfaceOffset = pDesklet->iTopSurfaceOffset;
+	pCache->iRightSurfaceOffset = pDesklet->iRightSurfaceOffset;
+	pCache->iBottomSurfaceOffset = pDesklet->iBottomSurfaceOffset;
+	_compute_picking_matrix (pDesklet, pCache->m);
+	return pCache;
+}
+
+// project a point of the desklet's plane into window coordinates (y going up, like the viewport). Returns FALSE if the point is behind the eye.
+static inline gboolean _project_point (const gdouble *m, double x, double y, int iWidth, int iHeight, double *wx, double *wy)
+{
+	double cx = m[0]*x + m[4]*y + m[12];
+	double cy = m[1]*x + m[5]*y + m[13];
+	double cw = m[3]*x + m[7]*y + m[15];
+	if (cw <= 0)
+		return FALSE;
+	*wx = (cx / cw + 1) * iWidth / 2;
+	*wy = (cy / cw + 1) * iHeight / 2;
+	return TRUE;
+}
+
+static gboolean _icon_is_under_pointer (Icon *pIcon, CairoDesklet *pDesklet, const gdouble *m, double mx, double my)
+{
+	int iWidth = pDesklet->container.iWidth, iHeight = pDesklet->container.iHeight;
+	double x0 = pIcon->fDrawX, x1 = pIcon->fDrawX + pIcon->fWidth;
+	double y1 = iHeight - pIcon->fDrawY, y0 = y1 - pIcon->fHeight;
+	double px[4], py[4];
+	if (! _project_point (m, x0, y1, iWidth, iHeight, &px[0], &py[0])
+	|| ! _project_point (m, x1, y1, iWidth, iHeight, &px[1], &py[1])
+	|| ! _project_point (m, x1, y0, iWidth, iHeight, &px[2], &py[2])
+	|| ! _project_point (m, x0, y0, iWidth, iHeight, &px[3], &py[3]))
+		return FALSE;
+	
+	// the projected quad is convex: the pointer is inside if it's on the same side of each edge.
+	int i, iNbPositive = 0, iNbNegative = 0;
+	double c;
+	for (i = 0; i < 4; i ++)
+	{
+		c = (px[(i+1)%4] - px[i]) * (my - py[i]) - (py[(i+1)%4] - py[i]) * (mx - px[i]);
+		if (c > 0)
+			iNbPositive ++;
+		else if (c < 0)
+			iNbNegative ++;
+	}
+	return (iNbPositive == 0 || iNbNegative == 0);
+}
+
+static Icon *_cairo_dock_pick_icon_on_opengl_desklet_analytic (CairoDesklet *pDesklet)
+{
+	CDDeskletPickingCache *pCache = _get_picking_cache (pDesklet);
+	double mx = pDesklet->container.iMouseX + .5;  // center of the pixel
+	double my = pDesklet->container.iHeight - pDesklet->container.iMouseY - .5;
+	
+	pDesklet->iPickedObject = 0;
+	// same order as the rendering of the bounding boxes: the main icon, then the sub-icons.
+	Icon *pIcon = pDesklet->pIcon;
+	if (pIcon != NULL && pIcon->image.iTexture != 0 && _icon_is_under_pointer (pIcon, pDesklet, pCache->m, mx, my))
+		return pIcon;
+	
+	GList *ic;
+	for (ic = pDesklet->icons; ic != NULL; ic = ic->next)
+	{
+		pIcon = ic->data;
+		if (pIcon->image.iTexture != 0 && _icon_is_under_pointer (pIcon, pDesklet, pCache->m, mx, my))
+			return pIcon;
+	}
+	return NULL;
+}
+
 static Icon *_cairo_dock_pick_icon_on_opengl_desklet (CairoDesklet *pDesklet)
 {
 	GLuint selectBuf[4];
@@ -489,13 +678,7 @@ static Icon *_cairo_dock_pick_icon_on_opengl_desklet (CairoDesklet *pDesklet)
 	
 	_set_desklet_matrix (pDesklet);
 	
-	if (pDesklet->iLeftSurfaceOffset != 0 || pDesklet->iTopSurfaceOffset != 0 || pDesklet->iRightSurfaceOffset != 0 || pDesklet->iBottomSurfaceOffset != 0)
-	{
-		glTranslatef ((pDesklet->iLeftSurfaceOffset - pDesklet->iRightSurfaceOffset)/2, (pDesklet->iBottomSurfaceOffset - pDesklet->iTopSurfaceOffset)/2, 0.);
-		glScalef (1. - (double)(pDesklet->iLeftSurfaceOffset + pDesklet->iRightSurfaceOffset) / pDesklet->container.iWidth,
-			1. - (double)(pDesklet->iTopSurfaceOffset + pDesklet->iBottomSurfaceOffset) / pDesklet->container.iHeight,
-			1.);
-	}
+	_set_surface_offsets_matrix (pDesklet);
 	
 	glPolygonMode (GL_FRONT, GL_FILL);
 	glColor4f (1., 1., 1., 1.);
@@ -611,7 +794,10 @@ Icon *gldi_desklet_find_clicked_icon (CairoDesklet *pDesklet)
 {
 	if (g_bUseOpenGL && pDesklet->pRenderer && pDesklet->pRenderer->render_opengl)
 	{
-		return _cairo_dock_pick_icon_on_opengl_desklet (pDesklet);
+		if (pDesklet->render_bounding_box != NULL || pDesklet->pRenderer->render_bounding_box != NULL)  // the renderer names its own objects.
+			return _cairo_dock_pick_icon_on_opengl_desklet (pDesklet);
+		
+		return _cairo_dock_pick_icon_on_opengl_desklet_analytic (pDesklet);
 	}
 	
 	int iMouseX = pDesklet->container.iMouseX, iMouseY = pDesklet->container.iMouseY;
@@ -661,6 +847,128 @@ Icon *gldi_desklet_find_clicked_icon (CairoDesklet *pDesklet)
 	return NULL;
 }
 
+#define CD_CHECK_PICKING_SIZE 200
+#define CD_CHECK_PICKING_STEP 8
+#define CD_CHECK_PICKING_NB_ICONS 4
+static gboolean _picked_icon_is_near (CairoDesklet *pDesklet, Icon *pIcon, int iMouseX, int iMouseY)  // the edges of the quads are rasterized by the GPU, so allow 1 pixel of difference there.
+{
+	int i, j;
+	for (i = -1; i <= 1; i ++)
+	{
+		for (j = -1; j <= 1; j ++)
+		{
+			pDesklet->container.iMouseX = iMouseX + i;
+			pDesklet->container.iMouseY = iMouseY + j;
+			if (_cairo_dock_pick_icon_on_opengl_desklet_analytic (pDesklet) == pIcon)
+				return TRUE;
+		}
+	}
+	return FALSE;
+}
+gint gldi_desklets_check_picking (void)
+{
+	g_return_val_if_fail (g_bUseOpenGL, -1);
+
+	//\_____________ build a desklet with a main icon and a few sub-icons, laid out like a simple renderer would do.
+	CairoDeskletAttr attr;
+	memset (&attr, 0, sizeof (CairoDeskletAttr));
+	attr.bDeskletUseSize = TRUE;
+	attr.iDeskletWidth = CD_CHECK_PICKING_SIZE;
+	attr.iDeskletHeight = CD_CHECK_PICKING_SIZE;
+	attr.pIcon = cairo_dock_create_dummy_launcher (g_strdup ("main"), NULL, NULL, NULL, 0);
+	CairoDesklet *pDesklet = gldi_desklet_new (&attr);
+	g_return_val_if_fail (pDesklet != NULL, -1);
+	gtk_widget_realize (pDesklet->container.pWidget);
+
+	int w = CD_CHECK_PICKING_SIZE, h = CD_CHECK_PICKING_SIZE;
+	pDesklet->container.iWidth = w;
+	pDesklet->container.iHeight = h;
+	Icon *pIcon = pDesklet->pIcon;
+	pIcon->fDrawX = w/4;
+	pIcon->fDrawY = h/4;
+	pIcon->fWidth = w/2;
+	pIcon->fHeight = h/2;
+	pIcon->image.iTexture = 1000;  // the pickers only use the texture as a name.
+	int i;
+	for (i = 0; i < CD_CHECK_PICKING_NB_ICONS; i ++)  // one in each corner, overlapping the main icon.
+	{
+		pIcon = cairo_dock_create_dummy_launcher (g_strdup_printf ("icon %d", i), NULL, NULL, NULL, i+1);
+		pIcon->fDrawX = (i % 2) * w/2 + 10;
+		pIcon->fDrawY = (i / 2) * h/2 + 10;
+		pIcon->fWidth = w/2 - 30;
+		pIcon->fHeight = h/2 - 20;
+		pIcon->image.iTexture = 1001 + i;
+		pDesklet->icons = g_list_append (pDesklet->icons, pIcon);
+	}
+
+	g_return_val_if_fail (gldi_gl_container_make_current (CAIRO_CONTAINER (pDesklet)), -1);
+	glViewport (0, 0, w, h);
+
+	//\_____________ compare both pickers on a grid of points, for a set of geometries.
+	const double fRotations[] = {0., .5, -1.2};
+	const double fDepthRotationsY[] = {0., .6};
+	const double fDepthRotationsX[] = {0., -.4};
+	const double fRatios[] = {1., .8};
+	const int iOffsets[2][4] = {{0, 0, 0, 0}, {10, 5, 20, 15}};
+	int r, dy, dx, z, o, x, y;
+	int iNbCases = 0, iNbPoints = 0, iNbMismatches = 0, iNbBoundaries = 0;
+	Icon *pAnalyticIcon, *pSelectedIcon;
+	for (r = 0; r < (int)G_N_ELEMENTS (fRotations); r ++)
+	for (dy = 0; dy < (int)G_N_ELEMENTS (fDepthRotationsY); dy ++)
+	for (dx = 0; dx < (int)G_N_ELEMENTS (fDepthRotationsX); dx ++)
+	for (z = 0; z < (int)G_N_ELEMENTS (fRatios); z ++)
+	for (o = 0; o < (int)G_N_ELEMENTS (iOffsets); o ++)
+	{
+		pDesklet->fRotation = fRotations[r];
+		pDesklet->fDepthRotationY = fDepthRotationsY[dy];
+		pDesklet->fDepthRotationX = fDepthRotationsX[dx];
+		pDesklet->container.fRatio = fRatios[z];
+		pDesklet->iLeftSurfaceOffset = iOffsets[o][0];
+		pDesklet->iTopSurfaceOffset = iOffsets[o][1];
+		pDesklet->iRightSurfaceOffset = iOffsets[o][2];
+		pDesklet->iBottomSurfaceOffset = iOffsets[o][3];
+		iNbCases ++;
+
+		for (x = 0; x < w; x += CD_CHECK_PICKING_STEP)
+		{
+			for (y = 0; y < h; y += CD_CHECK_PICKING_STEP)
+			{
+				pDesklet->container.iMouseX = x;
+				pDesklet->container.iMouseY = y;
+				pAnalyticIcon = _cairo_dock_pick_icon_on_opengl_desklet_analytic (pDesklet);
+				pSelectedIcon = _cairo_dock_pick_icon_on_opengl_desklet (pDesklet);
+				iNbPoints ++;
+				if (pAnalyticIcon == pSelectedIcon)
+					continue;
+				if (_picked_icon_is_near (pDesklet, pSelectedIcon, x, y))
+				{
+					iNbBoundaries ++;
+				}
+				else
+				{
+					iNbMismatches ++;
+					cd_warning ("picking mismatch at (%d;%d), rotation %.2f/%.2f/%.2f, ratio %.2f, offsets %d: %s (analytic) / %s (GL_SELECT)", x, y, pDesklet->fRotation, pDesklet->fDepthRotationY, pDesklet->fDepthRotationX, pDesklet->container.fRatio, o, pAnalyticIcon ? pAnalyticIcon->cName : "none", pSelectedIcon ? pSelectedIcon->cName : "none");
+				}
+			}
+		}
+	}
+	g_print ("{\"cases\":%d, \"points\":%d, \"mismatches\":%d, \"boundary\":%d}\n", iNbCases, iNbPoints, iNbMismatches, iNbBoundaries);
+
+	//\_____________ the textures are fake, don't let the icons delete them.
+	GList *ic;
+	for (ic = pDesklet->icons; ic != NULL; ic = ic->next)
+	{
+		pIcon = ic->data;
+		pIcon->image.iTexture = 0;
+	}
+	pIcon = pDesklet->pIcon;
+	pIcon->image.iTexture = 0;
+	gldi_object_unref (GLDI_OBJECT (pDesklet));
+	gldi_object_unref (GLDI_OBJECT (pIcon));
+
+	return iNbMismatches;
+}
+
 
   ///////////////
  /// MANAGER ///
@@ -1035,6 +1343,7 @@ static void reset_object (GldiObject *obj)
 	
 	g_free (pDesklet->cDecorationTheme);
 	gldi_desklet_decoration_free (pDesklet->pUserDecoration);
+	g_free (pDesklet->pPickingCache);
 	
 	cairo_dock_unload_image_buffer (&pDesklet->backGroundImageBuffer);
 	cairo_dock_unload_image_buffer (&pDesklet->foreGroundImageBuffer);
@@ -102,6 +102,11 @@ gboolean gldi_desklet_manager_is_ready (void);  // internals for the factory
 
 Icon *gldi_desklet_find_clicked_icon (CairoDesklet *pDesklet);  // internals for the factory; placed here because it uses the same code as the rendering
 
+/** Compare the picking of the icons of an OpenGL desklet with the GL_SELECT one, on a test desklet and for a set of rotations, zooms and surface offsets. The result is printed as a JSON object.
+*@return the number of points where the 2 pickers disagree (not counting the edges of the icons), or -1 if OpenGL is not used.
+*/
+gint gldi_desklets_check_picking (void);
+
 
 void gldi_register_desklets_manager (void);
 
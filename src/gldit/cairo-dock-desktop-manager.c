@@ -21,6 +21,7 @@
 #include "cairo-dock-desklet-manager.h"  // cairo_dock_foreach_desklet
 #include "cairo-dock-desklet-factory.h"
 #include "cairo-dock-draw-opengl.h"  // cairo_dock_create_texture_from_surface
+#include "cairo-dock-surface-factory.h"  // cairo_dock_create_blank_surface
 #include "cairo-dock-compiz-integration.h"
 #include "cairo-dock-kwin-integration.h"
 #include "cairo-dock-gnome-shell-integration.h"
@@ -224,23 +225,137 @@ gboolean gldi_desktop_grab_shortkey (guint keycode, guint modifiers, gboolean gr
 	return FALSE;
 }
 
+gboolean gldi_desktop_watch_pointer_motion (gboolean bWatch)
+{
+	if (s_backend.watch_pointer_motion)
+		return s_backend.watch_pointer_motion (bWatch);
+	return FALSE;
+}
+
   //////////////////
  /// DESKTOP BG ///
 //////////////////
 
+// the desktop background is loaded lazily: when possible, only the areas that are drawn (i.e. behind the containers) are read, each one into a surface of its size; it's loaded entirely only when a texture or the whole surface is needed, or if it can't be read by areas.
+struct _GldiDesktopBackground {
+	cairo_surface_t *pSurface;  // the whole background, or NULL if it's read by areas.
+	GList *pAreas;  // areas that have been read (CDDesktopBgArea), the most recently used first.
+	gboolean bReadByAreas;  // FALSE once reading an area has failed, until the background changes.
+	GLuint iTexture;
+	guint iSidDestroyBg;
+	gint iRefCount;
+	} ;
+
+typedef struct {
+	cairo_rectangle_int_t rect;  // in desktop coordinates
+	cairo_surface_t *pSurface;  // of the size of the area
+	} CDDesktopBgArea;
+
+#define CD_DESKTOP_BG_MAX_AREAS 8  // roughly one per container, plus the previous position of the ones that moved.
+
+static void _free_desktop_bg_areas (GldiDesktopBackground *pDesktopBg)
+{
+	GList *a;
+	CDDesktopBgArea *pArea;
+	for (a = pDesktopBg->pAreas; a != NULL; a = a->next)
+	{
+		pArea = a->data;
+		cairo_surface_destroy (pArea->pSurface);
+		g_free (pArea);
+	}
+	g_list_free (pDesktopBg->pAreas);
+	pDesktopBg->pAreas = NULL;
+}
+
+static void _load_desktop_bg_entirely (GldiDesktopBackground *pDesktopBg)
+{
+	if (pDesktopBg->pSurface != NULL)
+		return;
+	pDesktopBg->pSurface = _get_desktop_bg_surface ();
+	_free_desktop_bg_areas (pDesktopBg);  // not needed any more.
+}
+
+static CDDesktopBgArea *_read_desktop_bg_area (const cairo_rectangle_int_t *rect)
+{
+	cairo_surface_t *pSurface = cairo_dock_create_blank_surface (rect->width, rect->height);
+	if (! s_backend.get_desktop_bg_area (pSurface, rect->x, rect->y, rect->width, rect->height))
+	{
+		cairo_surface_destroy (pSurface);
+		return NULL;
+	}
+	CDDesktopBgArea *pArea = g_new (CDDesktopBgArea, 1);
+	pArea->rect = *rect;
+	pArea->pSurface = pSurface;
+	return pArea;
+}
+
+cairo_surface_t *gldi_desktop_background_get_area (GldiDesktopBackground *pDesktopBg, int x, int y, int iWidth, int iHeight, int *iOffsetX, int *iOffsetY)
+{
+	g_return_val_if_fail (pDesktopBg != NULL, NULL);
+	*iOffsetX = *iOffsetY = 0;
+	if (pDesktopBg->pSurface == NULL && (! pDesktopBg->bReadByAreas || s_backend.get_desktop_bg_area == NULL))
+		_load_desktop_bg_entirely (pDesktopBg);
+	if (pDesktopBg->pSurface != NULL)
+		return pDesktopBg->pSurface;
+	
+	//\_______________ look for an area that has already been read and contains this one.
+	cairo_rectangle_int_t rect;  // the part of the area that is inside the desktop
+	rect.x = MAX (0, x);
+	rect.y = MAX (0, y);
+	rect.width = MIN (x + iWidth, gldi_desktop_get_width()) - rect.x;
+	rect.height = MIN (y + iHeight, gldi_desktop_get_height()) - rect.y;
+	if (rect.width <= 0 || rect.height <= 0)  // outside of the desktop, nothing to draw.
+		return NULL;
+	GList *a;
+	CDDesktopBgArea *pArea = NULL;
+	for (a = pDesktopBg->pAreas; a != NULL; a = a->next)
+	{
+		pArea = a->data;
+		if (pArea->rect.x <= rect.x && pArea->rect.y <= rect.y
+		&& pArea->rect.x + pArea->rect.width >= rect.x + rect.width
+		&& pArea->rect.y + pArea->rect.height >= rect.y + rect.height)
+			break;
+	}
+	if (a != NULL)  // found, put it first.
+	{
+		pDesktopBg->pAreas = g_list_delete_link (pDesktopBg->pAreas, a);
+	}
+	else  // not read yet.
+	{
+		pArea = _read_desktop_bg_area (&rect);
+		if (pArea == NULL)  // this background can't be read by areas (pattern, plain color, unusual pixel format), load it entirely.
+		{
+			cd_debug ("the desktop background is loaded entirely");
+			pDesktopBg->bReadByAreas = FALSE;
+			_load_desktop_bg_entirely (pDesktopBg);
+			return pDesktopBg->pSurface;
+		}
+		if (g_list_length (pDesktopBg->pAreas) >= CD_DESKTOP_BG_MAX_AREAS)  // forget the least recently used one.
+		{
+			GList *pLast = g_list_last (pDesktopBg->pAreas);
+			CDDesktopBgArea *pOldArea = pLast->data;
+			cairo_surface_destroy (pOldArea->pSurface);
+			g_free (pOldArea);
+			pDesktopBg->pAreas = g_list_delete_link (pDesktopBg->pAreas, pLast);
+		}
+	}
+	pDesktopBg->pAreas = g_list_prepend (pDesktopBg->pAreas, pArea);
+	*iOffsetX = pArea->rect.x;
+	*iOffsetY = pArea->rect.y;
+	return pArea->pSurface;
+}
+
 GldiDesktopBackground *gldi_desktop_background_get (gboolean bWithTextureToo)
 {
 	//g_print ("%s (%d, %d)\n", __func__, bWithTextureToo, s_pDesktopBg?s_pDesktopBg->iRefCount:-1);
 	if (s_pDesktopBg == NULL)
 	{
 		s_pDesktopBg = g_new0 (GldiDesktopBackground, 1);
+		s_pDesktopBg->bReadByAreas = TRUE;
 	}
-	if (s_pDesktopBg->pSurface == NULL)
-	{
-		s_pDesktopBg->pSurface = _get_desktop_bg_surface ();
-	}
-	if (s_pDesktopBg->iTexture == 0 && bWithTextureToo)
+	if (s_pDesktopBg->iTexture == 0 && bWithTextureToo)  // the texture covers the whole desktop; otherwise nothing is read until it's drawn.
 	{
+		_load_desktop_bg_entirely (s_pDesktopBg);
 		s_pDesktopBg->iTexture = cairo_dock_create_texture_from_surface (s_pDesktopBg->pSurface);
 	}
 	
@@ -264,6 +379,8 @@ static gboolean _destroy_bg (GldiDesktopBackground *pDesktopBg)
 		pDesktopBg->pSurface = NULL;
 		//g_print ("--- surface destroyed\n");
 	}
+	_free_desktop_bg_areas (pDesktopBg);
+	pDesktopBg->bReadByAreas = TRUE;
 	if (pDesktopBg->iTexture != 0)
 	{
 		_cairo_dock_delete_texture (pDesktopBg->iTexture);
@@ -289,6 +406,7 @@ void gldi_desktop_background_destroy (GldiDesktopBackground *pDesktopBg)
 cairo_surface_t *gldi_desktop_background_get_surface (GldiDesktopBackground *pDesktopBg)
 {
 	g_return_val_if_fail (pDesktopBg != NULL, NULL);
+	_load_desktop_bg_entirely (pDesktopBg);  // we don't know which part will be used.
 	return pDesktopBg->pSurface;
 }
 
@@ -303,19 +421,22 @@ static void _reload_desktop_background (void)
 	//g_print ("%s ()\n", __func__);
 	if (s_pDesktopBg == NULL)  // rien a recharger.
 		return ;
-	if (s_pDesktopBg->pSurface == NULL && s_pDesktopBg->iTexture == 0)  // rien a recharger.
+	if (s_pDesktopBg->pSurface == NULL && s_pDesktopBg->pAreas == NULL && s_pDesktopBg->iTexture == 0)  // rien a recharger.
 		return ;
 	
 	if (s_pDesktopBg->pSurface != NULL)
 	{
 		cairo_surface_destroy (s_pDesktopBg->pSurface);
+		s_pDesktopBg->pSurface = NULL;
 		//g_print ("--- surface destroyed\n");
 	}
-	s_pDesktopBg->pSurface = _get_desktop_bg_surface ();
+	_free_desktop_bg_areas (s_pDesktopBg);  // the areas will be read again when the containers are redrawn.
+	s_pDesktopBg->bReadByAreas = TRUE;  // the new background may be readable by areas.
 	
 	if (s_pDesktopBg->iTexture != 0)
 	{
 		_cairo_dock_delete_texture (s_pDesktopBg->iTexture);
+		_load_desktop_bg_entirely (s_pDesktopBg);
 		s_pDesktopBg->iTexture = cairo_dock_create_texture_from_surface (s_pDesktopBg->pSurface);
 	}
 }
@@ -56,6 +56,8 @@ typedef enum {
 	NOTIFICATION_SHORTKEY_PRESSED,
 	/// notification called when the keymap changed, before and after updating it. data: updated
 	NOTIFICATION_KEYMAP_CHANGED,
+	/// notification called when the pointer has moved, while its motion is watched (see \ref gldi_desktop_watch_pointer_motion). data: NULL
+	NOTIFICATION_POINTER_MOVED,
 	NB_NOTIFICATIONS_DESKTOP
 	} CairoDesktopNotifications;
 
@@ -87,15 +89,10 @@ struct _GldiDesktopManagerBackend {
 	void (*refresh) (void);
 	void (*notify_startup) (const gchar *cClass);
 	gboolean (*grab_shortkey) (guint keycode, guint modifiers, gboolean grab);
+	gboolean (*watch_pointer_motion) (gboolean bWatch);
+	gboolean (*get_desktop_bg_area) (cairo_surface_t *pSurface, int x, int y, int iWidth, int iHeight);  // copy an area of the background at the top-left corner of the surface; FALSE if it can't be read by areas.
 	};
 
-/// Definition of a Desktop Background Buffer. It has a reference count so that it can be shared across all the lib.
-struct _GldiDesktopBackground {
-	cairo_surface_t *pSurface;
-	GLuint iTexture;
-	guint iSidDestroyBg;
-	gint iRefCount;
-	} ;
 
 
   /////////////////////
@@ -154,6 +151,12 @@ void gldi_desktop_notify_startup (const gchar *cClass);
 
 gboolean gldi_desktop_grab_shortkey (guint keycode, guint modifiers, gboolean grab);
 
+/** Start or stop watching the motion of the pointer on the whole screen. While it's watched, NOTIFICATION_POINTER_MOVED is emitted when the pointer moves, at most once per batch of events. It's not ref-counted.
+*@param bWatch TRUE to watch the pointer, FALSE to stop.
+*@return TRUE if the backend can watch the pointer; otherwise the pointer has to be polled.
+*/
+gboolean gldi_desktop_watch_pointer_motion (gboolean bWatch);
+
   ////////////////////
  // Desktop access //
 ////////////////////
@@ -182,6 +185,18 @@ GldiDesktopBackground *gldi_desktop_background_get (gboolean bWithTextureToo);
 
 void gldi_desktop_background_destroy (GldiDesktopBackground *pDesktopBg);
 
+/** Get a surface containing an area of the desktop background, reading it if needed. When possible, the background is only read behind the containers that draw it, so use this to draw a part of it; \ref gldi_desktop_background_get_surface loads it entirely.
+*@param pDesktopBg the desktop background
+*@param x left of the area, in desktop coordinates
+*@param y top of the area
+*@param iWidth width of the area
+*@param iHeight height of the area
+*@param iOffsetX returns the position of the surface on the desktop
+*@param iOffsetY returns the position of the surface on the desktop
+*@return the surface, or NULL if the background couldn't be read. It belongs to the desktop background, so use it right away.
+*/
+cairo_surface_t *gldi_desktop_background_get_area (GldiDesktopBackground *pDesktopBg, int x, int y, int iWidth, int iHeight, int *iOffsetX, int *iOffsetY);
+
 cairo_surface_t *gldi_desktop_background_get_surface (GldiDesktopBackground *pDesktopBg);
 
 GLuint gldi_desktop_background_get_texture (GldiDesktopBackground *pDesktopBg);
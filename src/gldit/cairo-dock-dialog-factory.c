@@ -278,14 +278,50 @@ static cairo_surface_t *_cairo_dock_create_dialog_text_surface (const gchar *cTe
 		return NULL;
 	
 	myDialogsParam.dialogTextDescription.bUseMarkup = bUseMarkup;  // slight optimization, rather than duplicating the TextDescription each time.
-	cairo_surface_t *pSurface = cairo_dock_create_surface_from_text (cText,
+	cairo_surface_t *pSurface = cairo_dock_create_surface_from_text_cached (cText,
 		&myDialogsParam.dialogTextDescription,
+		1.,
+		0,
 		iTextWidth,
-		iTextHeight);
+		iTextHeight);  // identical messages share the same surface.
 	myDialogsParam.dialogTextDescription.bUseMarkup = FALSE;  // by default
 	return pSurface;
 }
 
+static void _set_text_surface (CairoDialog *pDialog, cairo_surface_t *pNewTextSurface, int iNewTextWidth, int iNewTextHeight);
+
+static void _on_dialog_text_ready (cairo_surface_t *pSurface, int iWidth, int iHeight, CairoDialog *pDialog)
+{
+	if (pDialog->pMessageWidget == NULL)  // the text was already available, the dialog is still being built.
+	{
+		pDialog->pTextBuffer = pSurface;
+		pDialog->iTextWidth = iWidth;
+		pDialog->iTextHeight = iHeight;
+		return;
+	}
+	pDialog->pTextRequest = NULL;
+	_set_text_surface (pDialog, pSurface, iWidth, iHeight);
+	if (! pDialog->bHidden)  // now that it's complete, show the dialog, unless it has been hidden in the meantime.
+	{
+		if (pDialog->pInteractiveWidget != NULL)
+			gtk_window_present (GTK_WINDOW (pDialog->container.pWidget));
+		else
+			gtk_widget_show (pDialog->container.pWidget);
+	}
+}
+
+static void _load_dialog_text_async (CairoDialog *pDialog, const gchar *cText, gboolean bUseMarkup)
+{
+	myDialogsParam.dialogTextDescription.bUseMarkup = bUseMarkup;
+	pDialog->pTextRequest = cairo_dock_create_surface_from_text_async (cText,
+		&myDialogsParam.dialogTextDescription,
+		1.,
+		0,
+		(CairoDockTextSurfaceReadyFunc) _on_dialog_text_ready,
+		pDialog);
+	myDialogsParam.dialogTextDescription.bUseMarkup = FALSE;  // by default
+}
+
 static cairo_surface_t *_cairo_dock_create_dialog_icon_surface (const gchar *cImageFilePath, Icon *pIcon, int iDesiredSize, int *iIconSize)
 {
 	if (cImageFilePath == NULL)
@@ -389,9 +425,12 @@ void gldi_dialog_init_internals (CairoDialog *pDialog, CairoDialogAttr *pAttribu
 	if (pAttribute->cText != NULL)
 	{
 		pDialog->cText = g_strdup (pAttribute->cText);  // it may be a const string, so duplicate it
-		pDialog->pTextBuffer = _cairo_dock_create_dialog_text_surface (pAttribute->cText,
-			pAttribute->bUseMarkup,
-			&pDialog->iTextWidth, &pDialog->iTextHeight);
+		if (! pAttribute->pInteractiveWidget && ! pAttribute->pActionFunc)  // a mere message (applets often send them in bursts): draw it in the background, the dialog will appear once it's ready.
+			_load_dialog_text_async (pDialog, pAttribute->cText, pAttribute->bUseMarkup);
+		else
+			pDialog->pTextBuffer = _cairo_dock_create_dialog_text_surface (pAttribute->cText,
+				pAttribute->bUseMarkup,
+				&pDialog->iTextWidth, &pDialog->iTextHeight);
 		///pDialog->iTextTexture = cairo_dock_create_texture_from_surface (pDialog->pTextBuffer);
 	}
 	pDialog->bUseMarkup = pAttribute->bUseMarkup;  // remember this attribute, in case another text is set (with cairo_dock_set_dialog_message).
@@ -500,7 +539,7 @@ void gldi_dialog_init_internals (CairoDialog *pDialog, CairoDialogAttr *pAttribu
 		pDialog->pTopWidget = _cairo_dock_add_dialog_internal_box (pDialog, 0, pDialog->iTopMargin, FALSE);
 	else
 		pDialog->pTipWidget = _cairo_dock_add_dialog_internal_box (pDialog, 0, pDialog->iMinBottomGap + pDialog->iBottomMargin, TRUE);
-	if (pDialog->iMessageWidth != 0 && pDialog->iMessageHeight != 0)
+	if ((pDialog->iMessageWidth != 0 && pDialog->iMessageHeight != 0) || pDialog->pTextRequest != NULL)
 	{
 		pDialog->pMessageWidget = _cairo_dock_add_dialog_internal_box (pDialog, pDialog->iMessageWidth, pDialog->iMessageHeight, FALSE);
 	}
@@ -511,7 +550,8 @@ void gldi_dialog_init_internals (CairoDialog *pDialog, CairoDialogAttr *pAttribu
 			FALSE,
 			FALSE,
 			0);
-		gtk_window_present (GTK_WINDOW (pDialog->container.pWidget));
+		if (pDialog->pTextRequest == NULL)  // otherwise it will be presented when the text is ready.
+			gtk_window_present (GTK_WINDOW (pDialog->container.pWidget));
 		gtk_widget_grab_focus (pDialog->pInteractiveWidget);
 		
 		// set a MenuItem style to the dialog, so that the interactive widget can use the style defined for menu-items (either from the GTK theme, or from our own .css), and therefore be well integrated into the dialog, as if it was inside a menu.
@@ -527,7 +567,10 @@ void gldi_dialog_init_internals (CairoDialog *pDialog, CairoDialogAttr *pAttribu
 	else
 		pDialog->pTopWidget = _cairo_dock_add_dialog_internal_box (pDialog, 0, pDialog->iTopMargin, TRUE);
 	
-	gtk_widget_show_all (pDialog->container.pWidget);
+	if (pDialog->pTextRequest == NULL)
+		gtk_widget_show_all (pDialog->container.pWidget);
+	else  // the window will be shown when the text is ready.
+		gtk_widget_show_all (pMainHBox);
 	
 	//\________________ load the input shape.
 	if (pDialog->bNoInput)
@@ -904,10 +947,18 @@ static void _set_text_surface (CairoDialog *pDialog, cairo_surface_t *pNewTextSu
 void gldi_dialog_set_message (CairoDialog *pDialog, const gchar *cMessage)
 {
 	cd_debug ("%s", cMessage);
+	gboolean bPending = (pDialog->pTextRequest != NULL);
+	if (bPending)  // the previous text is not needed anymore.
+	{
+		cairo_dock_cancel_text_surface_request (pDialog->pTextRequest);
+		pDialog->pTextRequest = NULL;
+	}
 	int iNewTextWidth=0, iNewTextHeight=0;
 	cairo_surface_t *pNewTextSurface = _cairo_dock_create_dialog_text_surface (cMessage, pDialog->bUseMarkup, &iNewTextWidth, &iNewTextHeight);
 	
 	_set_text_surface (pDialog, pNewTextSurface, iNewTextWidth, iNewTextHeight);
+	if (bPending && ! pDialog->bHidden)
+		gtk_widget_show (pDialog->container.pWidget);
 	
 	g_free (pDialog->cText);
 	pDialog->cText = g_strdup (cMessage);
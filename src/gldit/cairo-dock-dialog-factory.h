@@ -148,7 +148,8 @@ struct _CairoDialog {
 	guint iButtonPressTime;
 	gboolean bInAnswer;
 	gchar *cText;
-	gpointer reserved[1];
+	gpointer pTextRequest;  // text being drawn in the background (CairoDockTextSurfaceRequest)
+	gboolean bHidden;  // visibility requested with gldi_dialog_hide/unhide; it's recorded even if the window is not shown yet (its text is still being drawn), so that it's respected once the text is ready.
 };
 
 #define CAIRO_DIALOG_FIRST_BUTTON 0
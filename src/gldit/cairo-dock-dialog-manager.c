@@ -57,9 +57,16 @@ static GSList *s_pDialogList = NULL;
 static cairo_surface_t *s_pButtonOkSurface = NULL;
 static cairo_surface_t *s_pButtonCancelSurface = NULL;
 static guint s_iSidReplaceDialogs = 0;
+static GHashTable *s_pDialogPlacements = NULL;  // dialog -> CDDialogPlacement, as of the last placement
+static gboolean s_bPlacementsDirty = TRUE;  // a dialog has been placed on its own since the last global placement
+static guint s_iNbPlacedDialogs = 0;  // number of dialogs handled by the last global placement
+static guint s_iNbReflows = 0;
+static guint s_iNbReflowsAvoided = 0;
+static guint s_iNbMovesAvoided = 0;
 
 static void _set_dialog_orientation (CairoDialog *pDialog, GldiContainer *pContainer);
 static void _place_dialog (CairoDialog *pDialog, GldiContainer *pContainer);
+static void _remember_dialog_placement (CairoDialog *pDialog);
 static gboolean on_style_changed (G_GNUC_UNUSED gpointer data);
 
 
@@ -676,6 +683,276 @@ static void _place_dialog (CairoDialog *pDialog, GldiContainer *pContainer)
 	gtk_window_move (GTK_WINDOW (pDialog->container.pWidget),
 		pDialog->iComputedPositionX,
 		pDialog->iComputedPositionY);
+	_remember_dialog_placement (pDialog);
+	s_bPlacementsDirty = TRUE;  // the other dialogs were not taken into account the same way as in a global placement.
+}
+
+  /////////////////
+ /// PLACEMENT ///
+/////////////////
+
+typedef struct {
+	gint iAimedX, iAimedY;
+	gboolean bDirectionUp, bRight;
+	gint iWidth, iHeight;
+	gint iPositionX, iPositionY;  // where the dialog was moved
+	} CDDialogPlacement;
+
+typedef struct {
+	gint x, y, w, h;
+	gint iAimedX;
+	} CDPlacedDialogBox;
+
+static CDDialogPlacement *_get_dialog_placement (CairoDialog *pDialog)
+{
+	if (s_pDialogPlacements == NULL)
+		return NULL;
+	return g_hash_table_lookup (s_pDialogPlacements, pDialog);
+}
+
+static void _remember_dialog_placement (CairoDialog *pDialog)
+{
+	if (s_pDialogPlacements == NULL)
+		s_pDialogPlacements = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, g_free);
+	CDDialogPlacement *p = g_hash_table_lookup (s_pDialogPlacements, pDialog);
+	if (p == NULL)
+	{
+		p = g_new (CDDialogPlacement, 1);
+		g_hash_table_insert (s_pDialogPlacements, pDialog, p);
+	}
+	p->iAimedX = pDialog->iAimedX;
+	p->iAimedY = pDialog->iAimedY;
+	p->bDirectionUp = pDialog->container.bDirectionUp;
+	p->bRight = pDialog->bRight;
+	p->iWidth = pDialog->iComputedWidth;
+	p->iHeight = pDialog->iComputedHeight;
+	p->iPositionX = pDialog->iComputedPositionX;
+	p->iPositionY = pDialog->iComputedPositionY;
+}
+
+static gboolean _dialog_anchor_changed (CairoDialog *pDialog, CDDialogPlacement *p)
+{
+	return (p == NULL
+		|| p->iAimedX != pDialog->iAimedX
+		|| p->iAimedY != pDialog->iAimedY
+		|| p->bDirectionUp != pDialog->container.bDirectionUp
+		|| p->bRight != pDialog->bRight
+		|| p->iWidth != pDialog->iComputedWidth
+		|| p->iHeight != pDialog->iComputedHeight);
+}
+
+static int _get_dialog_screen (CairoDialog *pDialog)
+{
+	int i;
+	for (i = 0; i < g_desktopGeometry.iNbScreens; i ++)
+	{
+		GtkAllocation *pScreen = &g_desktopGeometry.pScreens[i];
+		if (pDialog->iAimedX >= pScreen->x && pDialog->iAimedX < pScreen->x + pScreen->width
+		&& pDialog->iAimedY >= pScreen->y && pDialog->iAimedY <= pScreen->y + pScreen->height)
+			return i;
+	}
+	return -1;
+}
+
+static int _compare_dialogs_placement_order (CairoDialog **d1, CairoDialog **d2)
+{
+	int s1 = _get_dialog_screen (*d1), s2 = _get_dialog_screen (*d2);
+	if (s1 != s2)
+		return s1 - s2;
+	if ((*d1)->container.bDirectionUp != (*d2)->container.bDirectionUp)
+		return (*d1)->container.bDirectionUp - (*d2)->container.bDirectionUp;
+	return (*d1)->iAimedX - (*d2)->iAimedX;
+}
+
+// index of the first box whose left edge is not on the left of x.
+static guint _find_first_box_from (GArray *pBoxes, int x)
+{
+	guint iMin = 0, iMax = pBoxes->len, k;
+	while (iMin < iMax)
+	{
+		k = (iMin + iMax) / 2;
+		if (g_array_index (pBoxes, CDPlacedDialogBox, k).x < x)
+			iMin = k + 1;
+		else
+			iMax = k;
+	}
+	return iMin;
+}
+
+// place a dialog among the dialogs already placed on the same screen and in the same direction; it is the same strategy as _cairo_dock_dialog_find_optimal_placement, but against a list of boxes sorted by their left edge, so that only the boxes around the dialog are looked at: no box starting more than the widest box on the left of the zone can reach it.
+static void _place_dialog_among_boxes (CairoDialog *pDialog, GArray *pBoxes, int *iMaxBoxWidth)
+{
+	int iWidth = pDialog->iComputedWidth;
+	int iHeight = pDialog->iComputedHeight;
+	int iY = (pDialog->container.bDirectionUp ? pDialog->iAimedY - iHeight : pDialog->iAimedY);
+	int iZoneXLeft = MAX (pDialog->iAimedX - iWidth, 0);
+	int iZoneXRight = MIN (pDialog->iAimedX + iWidth, gldi_desktop_get_width());
+	int iLimitXLeft, iLimitXRight, iMinYLimit;
+	gboolean bDialogOnOurWay;
+	CDPlacedDialogBox *b;
+	guint i, n, iFirstBox = _find_first_box_from (pBoxes, iZoneXLeft - *iMaxBoxWidth);
+	for (n = 0; n <= pBoxes->len; n ++)  // each try moves the dialog beyond at least 1 box.
+	{
+		iLimitXLeft = iZoneXLeft;
+		iLimitXRight = iZoneXRight;
+		iMinYLimit = (pDialog->container.bDirectionUp ? -1e4 : 1e4);
+		bDialogOnOurWay = FALSE;
+		for (i = iFirstBox; i < pBoxes->len; i ++)
+		{
+			b = &g_array_index (pBoxes, CDPlacedDialogBox, i);
+			if (b->x >= iZoneXRight)  // this box and the next ones are on the right of our zone.
+				break;
+			if (b->x + b->w <= iZoneXLeft || b->y >= iY + iHeight || b->y + b->h <= iY)  // no intersection.
+				continue;
+			if (b->iAimedX < pDialog->iAimedX)  // this dialog is on our left.
+				iLimitXLeft = MAX (iLimitXLeft, b->x + b->w);
+			else
+				iLimitXRight = MIN (iLimitXRight, b->x);
+			iMinYLimit = (pDialog->container.bDirectionUp ? MAX (iMinYLimit, b->y) : MIN (iMinYLimit, b->y + b->h));
+			bDialogOnOurWay = TRUE;
+		}
+		if (! bDialogOnOurWay || iLimitXRight - iLimitXLeft >= MIN (gldi_desktop_get_width(), iWidth))  // there is enough room to place the dialog.
+			break;
+		iY = (pDialog->container.bDirectionUp ? iMinYLimit - iHeight : iMinYLimit);  // not enough room, try again above the closest dialog that was disturbing.
+	}
+	
+	if (pDialog->bRight)
+		pDialog->iComputedPositionX = MAX (0, MIN (pDialog->iAimedX - pDialog->fAlign * (iWidth - pDialog->iIconOffsetX) - pDialog->iIconOffsetX, iLimitXRight - iWidth));
+	else
+		pDialog->iComputedPositionX = MIN (gldi_desktop_get_width() - iWidth, MAX (pDialog->iAimedX - (1. - pDialog->fAlign) * (iWidth - pDialog->iIconOffsetX) - pDialog->iIconOffsetX, iLimitXLeft));
+	if (pDialog->container.bDirectionUp && iY < 0)
+		iY = 0;
+	else if (!pDialog->container.bDirectionUp && iY + iHeight > gldi_desktop_get_height())
+		iY = gldi_desktop_get_height() - iHeight;
+	pDialog->iComputedPositionY = iY;
+	
+	// insert our box, keeping the list sorted.
+	CDPlacedDialogBox box = {pDialog->iComputedPositionX, pDialog->iComputedPositionY, iWidth, iHeight, pDialog->iAimedX};
+	g_array_insert_val (pBoxes, _find_first_box_from (pBoxes, box.x), box);
+	*iMaxBoxWidth = MAX (*iMaxBoxWidth, iWidth);
+}
+
+// the dialogs that can't be moved (the mouse is inside) are obstacles at their current position, whatever the group being placed.
+static void _add_fixed_dialogs_boxes (GPtrArray *pFixedDialogs, GArray *pBoxes, int *iMaxBoxWidth)
+{
+	CairoDialog *pDialog;
+	guint i;
+	for (i = 0; i < pFixedDialogs->len; i ++)
+	{
+		pDialog = g_ptr_array_index (pFixedDialogs, i);
+		CDPlacedDialogBox box = {pDialog->container.iWindowPositionX, pDialog->container.iWindowPositionY, pDialog->container.iWidth, pDialog->container.iHeight, pDialog->iAimedX};
+		g_array_insert_val (pBoxes, _find_first_box_from (pBoxes, box.x), box);
+		*iMaxBoxWidth = MAX (*iMaxBoxWidth, box.w);
+	}
+}
+
+// place all the visible dialogs at once: the dialogs pointing on an horizontal dock are sorted by screen, direction and position, and placed in this order, each against the ones placed before and the ones that can't be moved. Nothing is done if no anchor changed since the last time, and only the dialogs whose position changed are moved.
+static void _replace_all_dialogs (void)
+{
+	GPtrArray *pDialogs = g_ptr_array_new ();
+	GPtrArray *pFixedDialogs = g_ptr_array_new ();
+	gboolean bChanged = s_bPlacementsDirty;
+	CairoDialog *pDialog;
+	GldiContainer *pContainer;
+	GSList *ic;
+	for (ic = s_pDialogList; ic != NULL; ic = ic->next)
+	{
+		pDialog = ic->data;
+		if (pDialog->pIcon == NULL || ! gldi_container_is_visible (CAIRO_CONTAINER (pDialog)))  // on ne replace pas les dialogues en cours de destruction ou caches.
+			continue;
+		if (pDialog->container.bInside && ! (pDialog->pInteractiveWidget || pDialog->action_on_answer))  // same as in _place_dialog: don't move it, but don't place the others over it.
+		{
+			g_ptr_array_add (pFixedDialogs, pDialog);
+			continue;
+		}
+		pContainer = cairo_dock_get_icon_container (pDialog->pIcon);
+		if (! pContainer)
+			continue;
+		
+		int iAimedX = pDialog->iAimedX;
+		int iAimedY = pDialog->iAimedY;
+		_set_dialog_orientation (pDialog, pContainer);
+		if (iAimedX != pDialog->iAimedX || iAimedY != pDialog->iAimedY)
+			gtk_widget_queue_draw (pDialog->container.pWidget);  // on redessine si la pointe change de position.
+		
+		if (_dialog_anchor_changed (pDialog, _get_dialog_placement (pDialog)))
+			bChanged = TRUE;
+		g_ptr_array_add (pDialogs, pDialog);
+	}
+	if (! bChanged && pDialogs->len + pFixedDialogs->len == s_iNbPlacedDialogs)  // nothing moved since the last time.
+	{
+		s_iNbReflowsAvoided ++;
+		g_ptr_array_free (pDialogs, TRUE);
+		g_ptr_array_free (pFixedDialogs, TRUE);
+		return;
+	}
+	s_iNbReflows ++;
+	
+	//\________________ compute the new positions.
+	g_ptr_array_sort (pDialogs, (GCompareFunc)_compare_dialogs_placement_order);
+	GArray *pBoxes = g_array_new (FALSE, FALSE, sizeof (CDPlacedDialogBox));
+	int iCurrentScreen = -2;
+	gboolean bCurrentDirectionUp = FALSE;
+	int iMaxBoxWidth = 0;
+	guint i;
+	for (i = 0; i < pDialogs->len; i ++)
+	{
+		pDialog = g_ptr_array_index (pDialogs, i);
+		if (pDialog->bTopBottomDialog)
+		{
+			int iScreen = _get_dialog_screen (pDialog);
+			if (iScreen != iCurrentScreen || pDialog->container.bDirectionUp != bCurrentDirectionUp)  // new group of dialogs.
+			{
+				g_array_set_size (pBoxes, 0);
+				iMaxBoxWidth = 0;
+				iCurrentScreen = iScreen;
+				bCurrentDirectionUp = pDialog->container.bDirectionUp;
+				_add_fixed_dialogs_boxes (pFixedDialogs, pBoxes, &iMaxBoxWidth);
+			}
+			_place_dialog_among_boxes (pDialog, pBoxes, &iMaxBoxWidth);
+		}
+		else  // dialogue lie a un dock vertical, on ne cherche pas a optimiser le placement.
+		{
+			pDialog->iComputedPositionX = (pDialog->bRight ? MAX (0, pDialog->iAimedX - pDialog->container.iWidth) : pDialog->iAimedX);
+			pDialog->iComputedPositionY = (pDialog->container.bDirectionUp ? MAX (0, pDialog->iAimedY - pDialog->iComputedHeight) : pDialog->iAimedY + pDialog->iMinBottomGap);
+		}
+	}
+	g_array_free (pBoxes, TRUE);
+	
+	//\________________ move the dialogs that need it.
+	CDDialogPlacement *p;
+	for (i = 0; i < pDialogs->len; i ++)
+	{
+		pDialog = g_ptr_array_index (pDialogs, i);
+		p = _get_dialog_placement (pDialog);
+		if (p != NULL && p->iPositionX == pDialog->iComputedPositionX && p->iPositionY == pDialog->iComputedPositionY
+		&& pDialog->container.iWindowPositionX == pDialog->iComputedPositionX && pDialog->container.iWindowPositionY == pDialog->iComputedPositionY)  // already there.
+		{
+			s_iNbMovesAvoided ++;
+		}
+		else
+		{
+			pDialog->bPositionForced = FALSE;
+			gtk_window_move (GTK_WINDOW (pDialog->container.pWidget),
+				pDialog->iComputedPositionX,
+				pDialog->iComputedPositionY);
+		}
+		_remember_dialog_placement (pDialog);
+	}
+	s_iNbPlacedDialogs = pDialogs->len + pFixedDialogs->len;
+	s_bPlacementsDirty = FALSE;
+	g_ptr_array_free (pDialogs, TRUE);
+	g_ptr_array_free (pFixedDialogs, TRUE);
+}
+
+void gldi_dialogs_get_placement_stats (guint *iNbReflows, guint *iNbReflowsAvoided, guint *iNbMovesAvoided)
+{
+	if (iNbReflows)
+		*iNbReflows = s_iNbReflows;
+	if (iNbReflowsAvoided)
+		*iNbReflowsAvoided = s_iNbReflowsAvoided;
+	if (iNbMovesAvoided)
+		*iNbMovesAvoided = s_iNbMovesAvoided;
 }
 
 void _refresh_all_dialogs (gboolean bReplace)
@@ -688,7 +965,13 @@ void _refresh_all_dialogs (gboolean bReplace)
 
 	if (s_pDialogList == NULL)
 		return ;
-
+	
+	if (bReplace)
+	{
+		_replace_all_dialogs ();
+		return;
+	}
+	
 	for (ic = s_pDialogList; ic != NULL; ic = ic->next)
 	{
 		pDialog = ic->data;
@@ -701,10 +984,7 @@ void _refresh_all_dialogs (gboolean bReplace)
 			{
 				int iAimedX = pDialog->iAimedX;
 				int iAimedY = pDialog->iAimedY;
-				if (bReplace)
-					_place_dialog (pDialog, pContainer);
-				else
-					_set_dialog_orientation (pDialog, pContainer);
+				_set_dialog_orientation (pDialog, pContainer);
 				
 				if (iAimedX != pDialog->iAimedX || iAimedY != pDialog->iAimedY)
 					gtk_widget_queue_draw (pDialog->container.pWidget);  // on redessine si la pointe change de position.
@@ -742,6 +1022,7 @@ static void _trigger_replace_all_dialogs (void)
 void gldi_dialog_hide (CairoDialog *pDialog)
 {
 	cd_debug ("%s ()", __func__);
+	pDialog->bHidden = TRUE;  // even if it's not shown yet, so that it's not shown when its text is ready.
 	if (gldi_container_is_visible (CAIRO_CONTAINER (pDialog)))
 	{
 		pDialog->bAllowMinimize = TRUE;
@@ -776,6 +1057,7 @@ void gldi_dialog_hide (CairoDialog *pDialog)
 void gldi_dialog_unhide (CairoDialog *pDialog)
 {
 	cd_debug ("%s ()", __func__);
+	pDialog->bHidden = FALSE;
 	if (! gldi_container_is_visible (CAIRO_CONTAINER (pDialog)))
 	{
 		if (pDialog->pInteractiveWidget != NULL)
@@ -799,12 +1081,14 @@ void gldi_dialog_unhide (CairoDialog *pDialog)
 		}
 	}
 	pDialog->bPositionForced = FALSE;
-	gtk_window_present (GTK_WINDOW (pDialog->container.pWidget));
+	if (pDialog->pTextRequest == NULL)  // otherwise it will be shown when its text is ready.
+		gtk_window_present (GTK_WINDOW (pDialog->container.pWidget));
 }
 
 void gldi_dialog_toggle_visibility (CairoDialog *pDialog)
 {
-	if (gldi_container_is_visible (CAIRO_CONTAINER (pDialog)))
+	if (gldi_container_is_visible (CAIRO_CONTAINER (pDialog))
+	|| (pDialog->pTextRequest != NULL && ! pDialog->bHidden))  // a dialog waiting for its text is considered as visible, since it will be shown as soon as it's ready.
 		gldi_dialog_hide (pDialog);
 	else
 		gldi_dialog_unhide (pDialog);
@@ -1147,7 +1431,13 @@ static void reset_object (GldiObject *obj)
 		g_source_remove (pDialog->iSidTimer);
 	}
 	
+	// forget its placement
+	if (s_pDialogPlacements != NULL && g_hash_table_remove (s_pDialogPlacements, pDialog))
+		s_bPlacementsDirty = TRUE;
+	
 	// destroy private data
+	if (pDialog->pTextRequest != NULL)
+		cairo_dock_cancel_text_surface_request (pDialog->pTextRequest);
 	if (pDialog->pTextBuffer != NULL)
 		cairo_surface_destroy (pDialog->pTextBuffer);
 	if (pDialog->pIconBuffer != NULL)
@@ -120,6 +120,13 @@ void gldi_dialogs_refresh_all (void);
 
 void gldi_dialogs_replace_all (void);
 
+/** Get some statistics about the placement of the dialogs.
+*@param iNbReflows returns the number of times all the dialogs were placed, or NULL.
+*@param iNbReflowsAvoided returns the number of times it was skipped because no dialog had moved, or NULL.
+*@param iNbMovesAvoided returns the number of dialogs that were not moved because they were already at the right place, or NULL.
+*/
+void gldi_dialogs_get_placement_stats (guint *iNbReflows, guint *iNbReflowsAvoided, guint *iNbMovesAvoided);
+
 
 CairoDialog *gldi_dialogs_foreach (GCompareFunc callback, gpointer data);
 
@@ -18,6 +18,7 @@
 */
 
 #include <math.h>
+#include <string.h>
 #include <gtk/gtk.h>
 
 #include "cairo-dock-applications-manager.h"  // cairo_dock_set_icons_geometry_for_window_manager
@@ -35,12 +36,14 @@
 #include "cairo-dock-animations.h"
 #include "cairo-dock-desktop-manager.h"  // gldi_desktop_get*
 #include "cairo-dock-data-renderer.h"  // cairo_dock_reload_data_renderer_on_icon
-#include "cairo-dock-opengl.h"  // gldi_gl_container_begin_draw
+#include "cairo-dock-container.h"  // gldi_container_snapshot
 
 extern CairoDockGLConfig g_openglConfig;
 #include "cairo-dock-dock-facility.h"
 
-extern gboolean g_bUseOpenGL;  // for cairo_dock_make_preview()
+
+static gint s_iResizeTransactionDepth = 0;  // > 0 while some icons are being inserted/removed in a row.
+static GList *s_pResizeTransactionDocks = NULL;  // docks whose size has to be updated at the end of the transaction.
 
 
 /**
@@ -55,6 +58,12 @@ void cairo_dock_update_dock_size (CairoDock *pDock)
 		//g_print (" -> delayed\n");
 		return;
 	}
+	if (s_iResizeTransactionDepth > 0)  // will be done once at the end of the transaction.
+	{
+		if (g_list_find (s_pResizeTransactionDocks, pDock) == NULL)
+			s_pResizeTransactionDocks = g_list_prepend (s_pResizeTransactionDocks, pDock);
+		return;
+	}
 	int iPrevMaxDockHeight = pDock->iMaxDockHeight;
 	int iPrevMaxDockWidth = pDock->iMaxDockWidth;
 	
@@ -195,12 +204,53 @@ static gboolean _update_dock_size_idle (CairoDock *pDock)
 }
 void cairo_dock_trigger_update_dock_size (CairoDock *pDock)
 {
+	if (s_iResizeTransactionDepth > 0)  // will be done once at the end of the transaction.
+	{
+		if (pDock->iSidUpdateDockSize == 0 && g_list_find (s_pResizeTransactionDocks, pDock) == NULL)
+			s_pResizeTransactionDocks = g_list_prepend (s_pResizeTransactionDocks, pDock);
+		return;
+	}
 	if (pDock->iSidUpdateDockSize == 0)
 	{
 		pDock->iSidUpdateDockSize = g_idle_add ((GSourceFunc) _update_dock_size_idle, pDock);
 	}
 }
 
+void cairo_dock_begin_resize_transaction (void)
+{
+	s_iResizeTransactionDepth ++;
+}
+
+void cairo_dock_commit_resize_transaction (void)
+{
+	g_return_if_fail (s_iResizeTransactionDepth > 0);
+	s_iResizeTransactionDepth --;
+	if (s_iResizeTransactionDepth > 0)  // an enclosing transaction will do it.
+		return;
+	
+	GList *pDocks = s_pResizeTransactionDocks;
+	s_pResizeTransactionDocks = NULL;
+	CairoDock *pDock;
+	GList *d;
+	for (d = pDocks; d != NULL; d = d->next)
+	{
+		pDock = d->data;
+		if (pDock->iSidUpdateDockSize != 0)  // do it now rather than later.
+		{
+			g_source_remove (pDock->iSidUpdateDockSize);
+			pDock->iSidUpdateDockSize = 0;
+		}
+		cairo_dock_update_dock_size (pDock);  // compute the layout; the window is moved/resized once, in an idle.
+		gtk_widget_queue_draw (pDock->container.pWidget);
+	}
+	g_list_free (pDocks);
+}
+
+void cairo_dock_remove_dock_from_resize_transaction (CairoDock *pDock)
+{
+	s_pResizeTransactionDocks = g_list_remove (s_pResizeTransactionDocks, pDock);
+}
+
 static gboolean _emit_leave_signal_delayed (CairoDock *pDock)
 {
 	cairo_dock_emit_leave_signal (CAIRO_CONTAINER (pDock));
@@ -495,6 +545,75 @@ void cairo_dock_move_resize_dock (CairoDock *pDock)
   ///////////////////
  /// INPUT SHAPE ///
 ///////////////////
+
+typedef struct {
+	gint W, H, w, h;
+	gint iActiveWidth, iActiveHeight;
+	gdouble fAlign;
+	gboolean bIsHorizontal, bDirectionUp;
+	gboolean bNoInput;
+	} CDInputShapeKey;
+
+typedef struct {
+	// input zones computed for a given geometry
+	gboolean bValid;
+	CDInputShapeKey key;
+	cairo_region_t *pShapeBitmap, *pHiddenShapeBitmap, *pActiveShapeBitmap;  // the ones we built, only compared to the dock's ones.
+	// input zone that was sent to the X server
+	gboolean bApplied;
+	cairo_region_t *pAppliedShape;  // a copy, NULL <=> all the window.
+	} CDInputShapeCache;
+
+static guint s_iNbShapesSent = 0;
+static guint s_iNbShapesSkipped = 0;
+
+static CDInputShapeCache *_get_input_shape_cache (CairoDock *pDock)
+{
+	if (pDock->pInputShapeCache == NULL)
+		pDock->pInputShapeCache = g_new0 (CDInputShapeCache, 1);
+	return pDock->pInputShapeCache;
+}
+
+void cairo_dock_apply_input_shape (CairoDock *pDock, cairo_region_t *pShape)
+{
+	CDInputShapeCache *pCache = _get_input_shape_cache (pDock);
+	if (pCache->bApplied
+	&& (pShape == NULL ? pCache->pAppliedShape == NULL : pCache->pAppliedShape != NULL && cairo_region_equal (pShape, pCache->pAppliedShape)))  // same zone as the current one, no need to bother the X server (and the compositor).
+	{
+		s_iNbShapesSkipped ++;
+		return;
+	}
+	s_iNbShapesSent ++;
+	
+	gldi_container_set_input_shape (CAIRO_CONTAINER (pDock), NULL);  // if gdkwindow->shape == NULL, setting a NULL shape will do nothing, so reset it first.
+	if (pShape != NULL)
+		gldi_container_set_input_shape (CAIRO_CONTAINER (pDock), pShape);
+	
+	if (pCache->pAppliedShape != NULL)
+		cairo_region_destroy (pCache->pAppliedShape);
+	pCache->pAppliedShape = (pShape != NULL ? cairo_region_copy (pShape) : NULL);
+	pCache->bApplied = TRUE;
+}
+
+void cairo_dock_free_input_shape_cache (CairoDock *pDock)
+{
+	CDInputShapeCache *pCache = pDock->pInputShapeCache;
+	if (pCache == NULL)
+		return;
+	if (pCache->pAppliedShape != NULL)
+		cairo_region_destroy (pCache->pAppliedShape);
+	g_free (pCache);
+	pDock->pInputShapeCache = NULL;
+}
+
+void cairo_dock_get_input_shape_stats (guint *iNbSent, guint *iNbSkipped)
+{
+	if (iNbSent)
+		*iNbSent = s_iNbShapesSent;
+	if (iNbSkipped)
+		*iNbSkipped = s_iNbShapesSkipped;
+}
+
 static cairo_region_t *_cairo_dock_create_input_shape (CairoDock *pDock, int w, int h)
 {
  	int W = pDock->iMaxDockWidth;
@@ -528,8 +647,56 @@ static cairo_region_t *_cairo_dock_create_input_shape (CairoDock *pDock, int w,
 	return pShapeBitmap;
 }
 
+static void _remember_input_shapes (CairoDock *pDock, CDInputShapeCache *pCache, CDInputShapeKey *pKey)
+{
+	pCache->key = *pKey;
+	pCache->pShapeBitmap = pDock->pShapeBitmap;
+	pCache->pHiddenShapeBitmap = pDock->pHiddenShapeBitmap;
+	pCache->pActiveShapeBitmap = pDock->pActiveShapeBitmap;
+	pCache->bValid = TRUE;
+}
+
 void cairo_dock_update_input_shape (CairoDock *pDock)
 {
+	//\_______________ define the input zones' geometry
+	int W = pDock->iMaxDockWidth;
+	int H = pDock->iMaxDockHeight;
+	int w = pDock->iMinDockWidth;
+	int h = pDock->iMinDockHeight;
+	//g_print ("%s (%dx%d; %dx%d)\n", __func__, w, h, W, H);
+	int w_ = 0;  // Note: in older versions of X, a fully empty input shape was not working and we had to set 1 pixel ON.
+	int h_ = 0;
+	
+	//\_______________ if the geometry didn't change, keep the current input zones.
+	CDInputShapeCache *pCache = _get_input_shape_cache (pDock);
+	CDInputShapeKey key;
+	memset (&key, 0, sizeof (CDInputShapeKey));
+	key.W = W;
+	key.H = H;
+	key.w = w;
+	key.h = h;
+	key.iActiveWidth = pDock->iActiveWidth;
+	key.iActiveHeight = pDock->iActiveHeight;
+	key.fAlign = pDock->fAlign;
+	key.bIsHorizontal = pDock->container.bIsHorizontal;
+	key.bDirectionUp = pDock->container.bDirectionUp;
+	key.bNoInput = (w == 0 || h == 0 || pDock->iRefCount > 0 || W == 0 || H == 0);
+	if (pCache->bValid
+	&& (pDock->pRenderer == NULL || pDock->pRenderer->update_input_shape == NULL)  // else the renderer may define the zones from other parameters.
+	&& memcmp (&key, &pCache->key, sizeof (CDInputShapeKey)) == 0
+	&& pCache->pShapeBitmap == pDock->pShapeBitmap
+	&& pCache->pHiddenShapeBitmap == pDock->pHiddenShapeBitmap
+	&& pCache->pActiveShapeBitmap == pDock->pActiveShapeBitmap)  // the zones were not modified in the meantime.
+	{
+		if (key.bNoInput && pDock->iInputState != CAIRO_DOCK_INPUT_ACTIVE)
+		{
+			cairo_dock_set_input_shape_active (pDock);
+			pDock->iInputState = CAIRO_DOCK_INPUT_ACTIVE;
+		}
+		return;
+	}
+	pCache->bValid = FALSE;
+	
 	//\_______________ destroy the current input zones.
 	if (pDock->pShapeBitmap != NULL)
 	{
@@ -547,21 +714,13 @@ void cairo_dock_update_input_shape (CairoDock *pDock)
 		pDock->pActiveShapeBitmap = NULL;
 	}
 	
-	//\_______________ define the input zones' geometry
-	int W = pDock->iMaxDockWidth;
-	int H = pDock->iMaxDockHeight;
-	int w = pDock->iMinDockWidth;
-	int h = pDock->iMinDockHeight;
-	//g_print ("%s (%dx%d; %dx%d)\n", __func__, w, h, W, H);
-	int w_ = 0;  // Note: in older versions of X, a fully empty input shape was not working and we had to set 1 pixel ON.
-	int h_ = 0;
-	
 	//\_______________ check that the dock can have input zones.
-	if (w == 0 || h == 0 || pDock->iRefCount > 0 || W == 0 || H == 0)
+	if (key.bNoInput)
 	{
 		if (pDock->iActiveWidth != pDock->iMaxDockWidth || pDock->iActiveHeight != pDock->iMaxDockHeight)
 			// else all the dock is active when the mouse is inside, so we can just set a NULL shape.
 			pDock->pActiveShapeBitmap = _cairo_dock_create_input_shape (pDock, pDock->iActiveWidth, pDock->iActiveHeight);
+		_remember_input_shapes (pDock, pCache, &key);
 		if (pDock->iInputState != CAIRO_DOCK_INPUT_ACTIVE)
 		{
 			//g_print ("+++ input shape active on update input shape\n");
@@ -583,6 +742,8 @@ void cairo_dock_update_input_shape (CairoDock *pDock)
 	//\_______________ if the renderer can define the input shape, let it finish the job.
 	if (pDock->pRenderer->update_input_shape != NULL)
 		pDock->pRenderer->update_input_shape (pDock);
+	
+	_remember_input_shapes (pDock, pCache, &key);
 }
 
 
@@ -1141,6 +1302,11 @@ static gboolean _redraw_subdock_content_idle (Icon *pIcon)
 	{
 		if (pIcon->pSubDock != NULL)
 		{
+			if (! cairo_dock_subdock_content_has_changed (pIcon))  // none of the icons displayed on the icon has changed, nothing to do.
+			{
+				pIcon->iSidRedrawSubdockContent = 0;
+				return FALSE;
+			}
 			cairo_dock_draw_subdock_content_on_icon (pIcon, pDock);
 		}
 		else
@@ -1157,26 +1323,34 @@ static gboolean _redraw_subdock_content_idle (Icon *pIcon)
 	pIcon->iSidRedrawSubdockContent = 0;
 	return FALSE;
 }
+static void _schedule_redraw_subdock_content (Icon *pIcon)
+{
+	/* if we already have an expected re-draw, it will take this change into account too;
+	 * we wait for 1 frame, so that the icons that changed in the meantime are redrawn before.
+	 */
+	if (pIcon->iSidRedrawSubdockContent != 0)
+		return;
+	GldiContainer *pContainer = cairo_dock_get_icon_container (pIcon);
+	pIcon->iSidRedrawSubdockContent = g_timeout_add_full (G_PRIORITY_DEFAULT_IDLE,
+		pContainer ? cairo_dock_get_animation_delta_t (pContainer) : 30,
+		(GSourceFunc) _redraw_subdock_content_idle,
+		pIcon,
+		NULL);
+}
 void cairo_dock_trigger_redraw_subdock_content (CairoDock *pDock)
 {
 	Icon *pPointingIcon = cairo_dock_search_icon_pointing_on_dock (pDock, NULL);
 	//g_print ("%s (%s, %d)\n", __func__, pPointingIcon?pPointingIcon->cName:NULL, pPointingIcon?pPointingIcon->iSubdockViewType:0);
 	if (pPointingIcon != NULL && (pPointingIcon->iSubdockViewType != 0 || (pPointingIcon->cClass != NULL && ! myIndicatorsParam.bUseClassIndic && (CAIRO_DOCK_ICON_TYPE_IS_CLASS_CONTAINER (pPointingIcon) || GLDI_OBJECT_IS_LAUNCHER_ICON (pPointingIcon)))))
 	{
-		/* if we already have an expected re-draw, we go to the end in order to
-		 * not do it before the redraw of icon linked to this trigger
-		 */
-		if (pPointingIcon->iSidRedrawSubdockContent != 0)
-			g_source_remove (pPointingIcon->iSidRedrawSubdockContent);
-		pPointingIcon->iSidRedrawSubdockContent = g_idle_add ((GSourceFunc) _redraw_subdock_content_idle, pPointingIcon);
+		_schedule_redraw_subdock_content (pPointingIcon);  // the content will only be redrawn if one of the displayed icons has changed.
 	}
 }
 
 void cairo_dock_trigger_redraw_subdock_content_on_icon (Icon *icon)
 {
-	if (icon->iSidRedrawSubdockContent != 0)
-		g_source_remove (icon->iSidRedrawSubdockContent);
-	icon->iSidRedrawSubdockContent = g_idle_add ((GSourceFunc) _redraw_subdock_content_idle, icon);
+	cairo_dock_invalidate_subdock_content (icon);  // the icon itself asks for a redraw, so do it unconditionally.
+	_schedule_redraw_subdock_content (icon);
 }
 
 void cairo_dock_redraw_subdock_content (CairoDock *pDock)
@@ -1422,61 +1596,9 @@ void cairo_dock_make_preview (CairoDock *pDock, const gchar *cPreviewPath)
 		pDock->container.iMouseY = 1;
 		cairo_dock_calculate_dock_icons (pDock);
 		
-		// dump the context into a cairo-surface
-		cairo_surface_t *pSurface;
-		int w = (pDock->container.bIsHorizontal ? pDock->container.iWidth : pDock->container.iHeight);  // iActiveWidth
-		int h = (pDock->container.bIsHorizontal ? pDock->container.iHeight : pDock->container.iWidth);  // iActiveHeight
-		GLubyte *glbuffer = NULL;
-		if (g_bUseOpenGL)
-		{
-			if (gldi_gl_container_begin_draw (CAIRO_CONTAINER (pDock)))
-			{
-				pDock->pRenderer->render_opengl (pDock);
-			}
-			int s = 4;  // 4 channels of 1 byte each (rgba).
-			GLubyte *buffer = (GLubyte *) g_malloc (w * h * s);
-			glbuffer = (GLubyte *) g_malloc (w * h * s);
-
-			glReadPixels(0, 0, w, h, GL_BGRA, GL_UNSIGNED_BYTE, (GLvoid *)buffer);
-
-			// make upside down
-			int x, y;
-			for (y=0; y<h; y++) {
-				for (x=0; x<w*s; x++) {
-					glbuffer[y * s * w + x] = buffer[(h - y - 1) * w * s + x];
-				}
-			}
-			
-			int iStride = w * s;  // number of bytes between the beginning of the 2 lines
-			pSurface = cairo_image_surface_create_for_data ((guchar *)glbuffer,
-				CAIRO_FORMAT_ARGB32,
-				w,
-				h,
-				iStride);
-			
-			g_free (buffer);
-		}
-		else
-		{
-			pSurface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
-				w,
-				h);
-			cairo_t *pCairoContext = cairo_create (pSurface);
-			pDock->pRenderer->render (pCairoContext, pDock);
-			cairo_destroy (pCairoContext);
-		}
-		// dump the surface into a PNG
-		if (!pDock->container.bIsHorizontal)
-		{
-			cairo_t *pCairoContext = cairo_create (pSurface);
-			cairo_translate (pCairoContext, w/2, h/2);
-			cairo_rotate (pCairoContext, -G_PI/2);
-			cairo_translate (pCairoContext, -h/2, -w/2);
-			cairo_destroy (pCairoContext);
-		}
-		
+		// draw the dock offscreen with its renderer (it doesn't need to be visible) and dump it into a PNG
+		cairo_surface_t *pSurface = gldi_container_snapshot (CAIRO_CONTAINER (pDock));
 		cairo_surface_write_to_png (pSurface, cPreviewPath);
 		cairo_surface_destroy (pSurface);
-		g_free (glbuffer);
 	}
 }
@@ -61,6 +61,16 @@ void cairo_dock_update_dock_size (CairoDock *pDock);
 
 void cairo_dock_trigger_update_dock_size (CairoDock *pDock);
 
+/** Start a series of insertions/removals of icons. Until the transaction is committed, the size of the docks is not updated; it will be updated once for each dock at the end, with only one move/resize of its window. Transactions can be nested.
+*/
+void cairo_dock_begin_resize_transaction (void);
+
+/** End a series of insertions/removals of icons started with \ref cairo_dock_begin_resize_transaction, and update the size of the docks that were modified in the meantime.
+*/
+void cairo_dock_commit_resize_transaction (void);
+
+void cairo_dock_remove_dock_from_resize_transaction (CairoDock *pDock);
+
 /** Calculate the position of all icons inside a dock, and triggers the enter/leave events according to the position of the mouse.
 *@param pDock the dock.
 *@return the pointed icon, or NULL if none is pointed.
@@ -93,21 +103,26 @@ void cairo_dock_move_resize_dock (CairoDock *pDock);
 */
 void cairo_dock_update_input_shape (CairoDock *pDock);
 
-#define cairo_dock_set_input_shape_active(pDock) do {\
-	gldi_container_set_input_shape (CAIRO_CONTAINER (pDock), NULL);\
-	if (pDock->fMagnitudeMax == 0.)\
-		gldi_container_set_input_shape (CAIRO_CONTAINER (pDock), pDock->pShapeBitmap);\
-	else if (pDock->pActiveShapeBitmap != NULL)\
-		gldi_container_set_input_shape (CAIRO_CONTAINER (pDock), pDock->pActiveShapeBitmap);\
-	} while (0)
-#define cairo_dock_set_input_shape_at_rest(pDock) do {\
-	gldi_container_set_input_shape (CAIRO_CONTAINER (pDock), NULL);\
-	gldi_container_set_input_shape (CAIRO_CONTAINER (pDock), pDock->pShapeBitmap);\
-	} while (0)
-#define cairo_dock_set_input_shape_hidden(pDock) do {\
-	gldi_container_set_input_shape (CAIRO_CONTAINER (pDock), NULL);\
-	gldi_container_set_input_shape (CAIRO_CONTAINER (pDock), pDock->pHiddenShapeBitmap);\
-	} while (0)
+/** Set the input zone of a dock. Nothing is sent to the X server if the zone is the same as the current one.
+*@param pDock the dock.
+*@param pShape the input zone, or NULL to make the whole window sensitive.
+*/
+void cairo_dock_apply_input_shape (CairoDock *pDock, cairo_region_t *pShape);
+
+void cairo_dock_free_input_shape_cache (CairoDock *pDock);
+
+/** Get the number of input zones that were sent to the X server, and the ones that were not because they didn't change.
+*@param iNbSent returns the number of updates sent, or NULL.
+*@param iNbSkipped returns the number of updates skipped, or NULL.
+*/
+void cairo_dock_get_input_shape_stats (guint *iNbSent, guint *iNbSkipped);
+
+#define cairo_dock_set_input_shape_active(pDock) \
+	cairo_dock_apply_input_shape (pDock, (pDock)->fMagnitudeMax == 0. ? (pDock)->pShapeBitmap : (pDock)->pActiveShapeBitmap)
+#define cairo_dock_set_input_shape_at_rest(pDock) \
+	cairo_dock_apply_input_shape (pDock, (pDock)->pShapeBitmap)
+#define cairo_dock_set_input_shape_hidden(pDock) \
+	cairo_dock_apply_input_shape (pDock, (pDock)->pHiddenShapeBitmap)
 
 /** Pop up a sub-dock.
 *@param pPointedIcon icon pointing on the sub-dock.
@@ -1083,6 +1083,23 @@ static gboolean _on_scroll (G_GNUC_UNUSED GtkWidget* pWidget, GdkEventScroll* pS
 }
 
 
+#if GTK_CHECK_VERSION (3, 10, 0)
+// anything that invalidates the window (a redraw of the dock, of an icon, or any gtk_widget_queue_draw) means that the image of the dock kept for the hiding effect may be outdated.
+static void _on_window_invalidated (GdkWindow *pGdkWindow, G_GNUC_UNUSED cairo_region_t *pRegion)
+{
+	GtkWidget *pWidget = NULL;
+	gdk_window_get_user_data (pGdkWindow, (gpointer*)&pWidget);
+	CairoDock *pDock = (pWidget != NULL ? g_object_get_data (G_OBJECT (pWidget), "cd-dock") : NULL);
+	if (pDock != NULL)
+		pDock->bRedirectedImageIsValid = FALSE;
+}
+
+static void _on_realize (GtkWidget* pWidget, G_GNUC_UNUSED CairoDock *pDock)
+{
+	gdk_window_set_invalidate_handler (gtk_widget_get_window (pWidget), _on_window_invalidated);
+}
+#endif
+
 static gboolean _on_configure (GtkWidget* pWidget, GdkEventConfigure* pEvent, CairoDock *pDock)
 {
 	//g_print ("%s (%p, main dock : %d) : (%d;%d) (%dx%d)\n", __func__, pDock, pDock->bIsMainDock, pEvent->x, pEvent->y, pEvent->width, pEvent->height);
@@ -1161,6 +1178,14 @@ static gboolean _on_configure (GtkWidget* pWidget, GdkEventConfigure* pEvent, Ca
 			}
 		}
 		
+		// the image of the dock kept for the hiding effect doesn't have the right size any more.
+		pDock->bRedirectedImageIsValid = FALSE;
+		if (pDock->pRedirectedSurface != NULL)
+		{
+			cairo_surface_destroy (pDock->pRedirectedSurface);
+			pDock->pRedirectedSurface = NULL;
+		}
+		
 		cairo_dock_calculate_dock_icons (pDock);
 		//g_print ("configure size %s\n", pDock->cDockName);
 		cairo_dock_trigger_set_WM_icons_geometry (pDock);  // changement de position ou de taille du dock => on replace les icones.
@@ -1760,6 +1785,14 @@ static gboolean _cairo_dock_handle_inserting_removing_icons (CairoDock *pDock)
 	return TRUE;
 }
 
+// redraw the dock for the next step of a hiding transition: only the effect changes, so the image of the dock stays valid, unless something else has invalidated it.
+static void _queue_draw_hiding_step (CairoDock *pDock)
+{
+	gboolean bImageIsValid = pDock->bRedirectedImageIsValid;
+	gtk_widget_queue_draw (pDock->container.pWidget);
+	pDock->bRedirectedImageIsValid = bImageIsValid;
+}
+
 static gboolean _cairo_dock_dock_animation_loop (GldiContainer *pContainer)
 {
 	CairoDock *pDock = CAIRO_DOCK (pContainer);
@@ -1789,13 +1822,13 @@ static gboolean _cairo_dock_dock_animation_loop (GldiContainer *pContainer)
 	{
 		//g_print ("le dock se cache\n");
 		pDock->bIsHiding = _cairo_dock_hide (pDock);
-		gtk_widget_queue_draw (pContainer->pWidget);  // on n'utilise pas cairo_dock_redraw_container, sinon a la derniere iteration, le dock etant cache, la fonction ne le redessine pas.
+		_queue_draw_hiding_step (pDock);  // on n'utilise pas cairo_dock_redraw_container, sinon a la derniere iteration, le dock etant cache, la fonction ne le redessine pas.
 		bContinue |= pDock->bIsHiding;
 	}
 	if (pDock->bIsShowing)
 	{
 		pDock->bIsShowing = _cairo_dock_show (pDock);
-		cairo_dock_redraw_container (CAIRO_CONTAINER (pDock));
+		_queue_draw_hiding_step (pDock);
 		bContinue |= pDock->bIsShowing;
 	}
 	//g_print (" => %d, %d\n", pDock->bIsShrinkingDown, pDock->bIsGrowingUp);
@@ -1827,7 +1860,9 @@ static gboolean _cairo_dock_dock_animation_loop (GldiContainer *pContainer)
 		}
 		
 		bContinue |= bIconIsAnimating;
-		if (! bIconIsAnimating)
+		if (bIconIsAnimating)  // the icon will look different on the next frame, so the dock has to be drawn again.
+			pDock->bRedirectedImageIsValid = FALSE;
+		else
 		{
 			icon->iAnimationState = CAIRO_DOCK_STATE_REST;
 			if (icon->bIsDemandingAttention)
@@ -1986,6 +2021,7 @@ static void _detach_icon (GldiContainer *pContainer, Icon *icon)
 	//\___________________ On l'enleve de la liste.
 	pDock->icons = g_list_delete_link (pDock->icons, ic);
 	ic = NULL;
+	cairo_dock_unindex_icon (pDock, icon);
 	pDock->fFlatDockWidth -= icon->fWidth + myIconsParam.iIconGap;
 	
 	//\___________________ On enleve le separateur si c'est la derniere icone de son type.
@@ -1995,6 +2031,7 @@ static void _detach_icon (GldiContainer *pContainer, Icon *icon)
 		{
 			pDock->icons = g_list_delete_link (pDock->icons, next_ic);  // optimisation
 			next_ic = NULL;
+			cairo_dock_unindex_icon (pDock, pNextIcon);
 			pDock->fFlatDockWidth -= pNextIcon->fWidth + myIconsParam.iIconGap;
 			cairo_dock_set_icon_container (pNextIcon, NULL);
 			gldi_object_unref (GLDI_OBJECT (pNextIcon));
@@ -2004,6 +2041,7 @@ static void _detach_icon (GldiContainer *pContainer, Icon *icon)
 		{
 			pDock->icons = g_list_delete_link (pDock->icons, prev_ic);  // optimisation
 			prev_ic = NULL;
+			cairo_dock_unindex_icon (pDock, pPrevIcon);
 			pDock->fFlatDockWidth -= pPrevIcon->fWidth + myIconsParam.iIconGap;
 			cairo_dock_set_icon_container (pPrevIcon, NULL);
 			gldi_object_unref (GLDI_OBJECT (pPrevIcon));
@@ -2091,6 +2129,7 @@ static void _insert_icon (GldiContainer *pContainer, Icon *icon, gboolean bAnima
 	pDock->icons = g_list_insert_sorted (pDock->icons,
 		icon,
 		(GCompareFunc)cairo_dock_compare_icons_order);
+	cairo_dock_index_icon (pDock, icon);
 	
 	//\______________ set the icon size, now that it's inside a container.
 	int wi = icon->image.iWidth, hi = icon->image.iHeight;
@@ -2224,6 +2263,15 @@ void gldi_dock_init_internals (CairoDock *pDock)
 		"drag-drop",
 		G_CALLBACK (_on_drag_drop),
 		pDock);*/
+	#if GTK_CHECK_VERSION (3, 10, 0)
+	g_object_set_data (G_OBJECT (pWindow), "cd-dock", pDock);
+	g_signal_connect (G_OBJECT (pWindow),
+		"realize",
+		G_CALLBACK (_on_realize),
+		pDock);
+	if (gtk_widget_get_realized (pWindow))
+		_on_realize (pWindow, pDock);
+	#endif
 	
 	gtk_widget_show_all (pDock->container.pWidget);
 }
@@ -2259,6 +2307,7 @@ void cairo_dock_remove_icons_from_dock (CairoDock *pDock, CairoDock *pReceivingD
 	g_return_if_fail (pReceivingDock != NULL);
 	GList *pIconsList = pDock->icons;
 	pDock->icons = NULL;
+	cairo_dock_free_icon_index (pDock);  // the icons are taken out without being detached.
 	Icon *icon;
 	GList *ic;
 	for (ic = pIconsList; ic != NULL; ic = ic->next)
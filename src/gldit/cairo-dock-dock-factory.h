@@ -290,7 +290,14 @@ struct _CairoDock {
 	GLuint iRedirectedTexture;
 	GLuint iFboId;
 	
-	gpointer reserved[4];
+	/// cache of the input shapes, private.
+	gpointer pInputShapeCache;
+	/// index of the icons by name/command/URI/sub-dock, private.
+	gpointer pIconIndex;
+	/// surface the dock is drawn on during a hiding transition in Cairo mode, private.
+	cairo_surface_t *pRedirectedSurface;
+	/// TRUE when the redirected texture/surface holds the current image of the dock, so that the hiding effect can be applied on it without drawing the dock again; any invalidation of the window resets it. Private.
+	gboolean bRedirectedImageIsValid;
 };
 
 
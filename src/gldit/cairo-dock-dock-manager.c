@@ -37,6 +37,7 @@
 #include "cairo-dock-applet-manager.h"
 #include "cairo-dock-stack-icon-manager.h"
 #include "cairo-dock-class-icon-manager.h"
+#include "cairo-dock-class-manager.h"  // cairo_dock_invalidate_class_image_buffers
 #include "cairo-dock-backends-manager.h"
 #include "cairo-dock-desktop-manager.h"
 #include "cairo-dock-log.h"
@@ -75,6 +76,7 @@ static GHashTable *s_hDocksTable = NULL;  // table des docks existant.
 static GList *s_pRootDockList = NULL;
 static guint s_iSidPollScreenEdge = 0;
 static int s_iNbPolls = 0;
+static gboolean s_bWaitPointerMotion = FALSE;  // the pointer is idle, we wait for it to move rather than polling it.
 static gboolean s_bQuickHide = FALSE;
 static gboolean s_bKeepAbove = FALSE;
 static GldiShortkey *s_pPopupBinding = NULL;  // option 'pop up on shortkey'
@@ -312,6 +314,7 @@ gboolean cairo_dock_check_unique_subdock_name (Icon *pIcon)
 	{
 		g_free (pIcon->cName);
 		pIcon->cName = cUniqueName;
+		cairo_dock_reindex_icon (pIcon);
 		cd_debug (" cName <- %s", cUniqueName);
 		return TRUE;
 	}
@@ -397,6 +400,8 @@ static void _cairo_dock_draw_one_subdock_icon (G_GNUC_UNUSED const gchar *cDockN
 }
 void cairo_dock_reload_buffers_in_all_docks (gboolean bUpdateIconSize)
 {
+	cairo_dock_invalidate_class_image_buffers (NULL);  // the icons will share their new images.
+	
 	g_list_foreach (s_pRootDockList, (GFunc)_reload_buffer_in_one_dock, GINT_TO_POINTER (bUpdateIconSize));  // we load the root docks first, so that sub-docks can have the correct icon size.
 	
 	// now that all icons in sub-docks are drawn, redraw icons pointing to a sub-dock
@@ -1051,13 +1056,31 @@ static gboolean _cairo_dock_poll_screen_edge (G_GNUC_UNUSED gpointer data)  // t
 	mouse.bUpToDate = FALSE;  // mouse position will be updated by the first hidden dock.
 	g_list_foreach (s_pRootDockList, (GFunc) _cairo_dock_unhide_root_dock_on_mouse_hit, &mouse);
 	
+	if ((! mouse.bUpToDate || mouse.bNoMove)  // no dock to unhide, or the pointer didn't move since the last time.
+	&& gldi_desktop_watch_pointer_motion (TRUE))  // rather than waking up for nothing, wait until it moves again; a delayed unhide doesn't need the polling.
+	{
+		s_bWaitPointerMotion = TRUE;
+		s_iSidPollScreenEdge = 0;
+		return FALSE;
+	}
 	return TRUE;
 }
+static gboolean _on_pointer_moved (G_GNUC_UNUSED gpointer data)
+{
+	if (s_bWaitPointerMotion)  // poll it again while it moves, to know its direction when it reaches the edge.
+	{
+		gldi_desktop_watch_pointer_motion (FALSE);
+		s_bWaitPointerMotion = FALSE;
+		if (s_iSidPollScreenEdge == 0)
+			s_iSidPollScreenEdge = g_timeout_add (MOUSE_POLLING_DT, (GSourceFunc) _cairo_dock_poll_screen_edge, NULL);
+	}
+	return GLDI_NOTIFICATION_LET_PASS;
+}
 static void _start_polling_screen_edge (void)
 {
 	s_iNbPolls ++;
 	cd_debug ("%s (%d)", __func__, s_iNbPolls);
-	if (s_iSidPollScreenEdge == 0)
+	if (s_iSidPollScreenEdge == 0 && ! s_bWaitPointerMotion)
 		s_iSidPollScreenEdge = g_timeout_add (MOUSE_POLLING_DT, (GSourceFunc) _cairo_dock_poll_screen_edge, NULL);
 }
 
@@ -1068,6 +1091,11 @@ static void _stop_polling_screen_edge_now (void)
 		g_source_remove (s_iSidPollScreenEdge);
 		s_iSidPollScreenEdge = 0;
 	}
+	if (s_bWaitPointerMotion)
+	{
+		gldi_desktop_watch_pointer_motion (FALSE);
+		s_bWaitPointerMotion = FALSE;
+	}
 	s_iNbPolls = 0;
 }
 static void _stop_polling_screen_edge (void)
@@ -1271,10 +1299,51 @@ static gboolean _on_new_dialog (G_GNUC_UNUSED gpointer data, CairoDialog *pDialo
 	return GLDI_NOTIFICATION_LET_PASS;
 }
 
+static void _render_dock_into_redirected_surface (CairoDock *pDock, cairo_t *pCairoContext)
+{
+	if (pDock->pRedirectedSurface == NULL)  // created on the first hiding transition, and kept until the dock is resized.
+	{
+		pDock->pRedirectedSurface = cairo_surface_create_similar (cairo_get_target (pCairoContext),
+			CAIRO_CONTENT_COLOR_ALPHA,
+			pDock->container.bIsHorizontal ? pDock->container.iWidth : pDock->container.iHeight,
+			pDock->container.bIsHorizontal ? pDock->container.iHeight : pDock->container.iWidth);
+	}
+	
+	cairo_t *pSurfaceContext = cairo_create (pDock->pRedirectedSurface);
+	cairo_set_operator (pSurfaceContext, CAIRO_OPERATOR_CLEAR);
+	cairo_paint (pSurfaceContext);
+	cairo_set_operator (pSurfaceContext, CAIRO_OPERATOR_OVER);
+	pDock->pRenderer->render (pSurfaceContext, pDock);
+	cairo_destroy (pSurfaceContext);
+	
+	pDock->bRedirectedImageIsValid = TRUE;
+}
+
 static gboolean _render_dock_notification (G_GNUC_UNUSED gpointer pUserData, CairoDock *pDock, cairo_t *pCairoContext)
 {
+	#if GTK_CHECK_VERSION (3, 10, 0)
+	gboolean bHidingOnly = (pDock->fHideOffset > 0 && pDock->fHideOffset < 1 && pDock->iFadeCounter == 0 && g_pHidingBackend != NULL);  // during a hiding transition, only the effect changes from one frame to the next, unless the dock itself changes.
+	#else
+	gboolean bHidingOnly = FALSE;  // we can't know when the window is invalidated, so the image of the dock can't be kept.
+	#endif
 	if (pCairoContext)  // cairo
 	{
+		if (bHidingOnly)  // draw the dock once, and then only apply the effect on its image.
+		{
+			if (! pDock->bRedirectedImageIsValid)
+				_render_dock_into_redirected_surface (pDock, pCairoContext);
+			
+			if (g_pHidingBackend->pre_render)
+				g_pHidingBackend->pre_render (pDock, pDock->fHideOffset, pCairoContext);
+			
+			cairo_set_source_surface (pCairoContext, pDock->pRedirectedSurface, 0., 0.);
+			cairo_paint (pCairoContext);
+			
+			if (g_pHidingBackend->post_render)
+				g_pHidingBackend->post_render (pDock, pDock->fHideOffset, pCairoContext);
+			return GLDI_NOTIFICATION_LET_PASS;
+		}
+		
 		if (pDock->fHideOffset != 0 && g_pHidingBackend != NULL && g_pHidingBackend->pre_render)
 			g_pHidingBackend->pre_render (pDock, pDock->fHideOffset, pCairoContext);
 	
@@ -1293,6 +1362,13 @@ static gboolean _render_dock_notification (G_GNUC_UNUSED gpointer pUserData, Cai
 	}
 	else  // opengl
 	{
+		if (bHidingOnly && pDock->bRedirectedImageIsValid && pDock->iFboId != 0 && g_pHidingBackend->post_render_opengl)  // the dock is still in its redirected texture (the effect has set the flag after drawing it), only apply the effect on it.
+		{
+			glBindFramebufferEXT (GL_FRAMEBUFFER_EXT, pDock->iFboId);  // the effect expects the FBO to be bound, and will switch back to the window.
+			g_pHidingBackend->post_render_opengl (pDock, pDock->fHideOffset);
+			return GLDI_NOTIFICATION_LET_PASS;
+		}
+		
 		if (pDock->fHideOffset != 0 && g_pHidingBackend != NULL && g_pHidingBackend->pre_render_opengl)
 			g_pHidingBackend->pre_render_opengl (pDock, pDock->fHideOffset);
 		
@@ -1907,6 +1983,10 @@ static void init (void)
 		NOTIFICATION_DESKTOP_GEOMETRY_CHANGED,
 		(GldiNotificationFunc) _on_screen_geometry_changed,
 		GLDI_RUN_FIRST, NULL);
+	gldi_object_register_notification (&myDesktopMgr,
+		NOTIFICATION_POINTER_MOVED,
+		(GldiNotificationFunc) _on_pointer_moved,
+		GLDI_RUN_AFTER, NULL);
 	gldi_object_register_notification (&myDialogObjectMgr,
 		NOTIFICATION_NEW,
 		(GldiNotificationFunc) _on_new_dialog,
@@ -2051,6 +2131,7 @@ static void reset_object (GldiObject *obj)
 		g_source_remove (pDock->iSidTestMouseOutside);
 	if (pDock->iSidUpdateDockSize != 0)
 		g_source_remove (pDock->iSidUpdateDockSize);
+	cairo_dock_remove_dock_from_resize_transaction (pDock);
 	
 	// free icons that are still present
 	GList *icons = pDock->icons;
@@ -2072,7 +2153,10 @@ static void reset_object (GldiObject *obj)
 	{
 		Icon *pPointedIcon = cairo_dock_search_icon_pointing_on_dock (pDock, NULL);
 		if (pPointedIcon != NULL)
+		{
 			pPointedIcon->pSubDock = NULL;
+			cairo_dock_reindex_icon (pPointedIcon);
+		}
 	}
 	
 	// unregister it
@@ -2101,6 +2185,9 @@ static void reset_object (GldiObject *obj)
 	if (pDock->pActiveShapeBitmap != NULL)
 		cairo_region_destroy (pDock->pActiveShapeBitmap);
 	
+	cairo_dock_free_input_shape_cache (pDock);
+	cairo_dock_free_icon_index (pDock);
+	
 	if (pDock->pRenderer != NULL && pDock->pRenderer->free_data != NULL)
 	{
 		pDock->pRenderer->free_data (pDock);
@@ -2113,6 +2200,8 @@ static void reset_object (GldiObject *obj)
 		glDeleteFramebuffersEXT (1, &pDock->iFboId);
 	if (pDock->iRedirectedTexture != 0)
 		_cairo_dock_delete_texture (pDock->iRedirectedTexture);
+	if (pDock->pRedirectedSurface != NULL)
+		cairo_surface_destroy (pDock->pRedirectedSurface);
 	g_free (pDock->cDockName);
 }
 
@@ -32,6 +32,7 @@
 #include "cairo-dock-overlay.h"
 #include "cairo-dock-style-manager.h"
 #include "cairo-dock-opengl-path.h"
+#include "cairo-dock-image-buffer.h"  // cairo_dock_release_texture
 
 #include "cairo-dock-draw-opengl.h"
 
@@ -878,7 +879,7 @@ static gboolean _transition_step (Icon *pIcon, gpointer data)
 static void _free_transition_data (gpointer data)
 {
 	GLuint iOriginalTexture = GPOINTER_TO_INT (data);
-	_cairo_dock_delete_texture (iOriginalTexture);
+	cairo_dock_release_texture (iOriginalTexture);  // it may be shared with the other icons of the class.
 }
 void cairo_dock_draw_hidden_appli_icon (Icon *pIcon, GldiContainer *pContainer, gboolean bStateChanged)
 {
@@ -59,16 +59,34 @@ cairo_t *cairo_dock_create_drawing_context_on_container (GldiContainer *pContain
 	return pCairoContext;
 }
 
-void cairo_dock_init_drawing_context_on_container (GldiContainer *pContainer, cairo_t *pCairoContext)
+// use the desktop background behind the container as source, if any.
+static gboolean _set_desktop_bg_source (GldiContainer *pContainer, cairo_t *pCairoContext)
 {
-	if (g_pFakeTransparencyDesktopBg && g_pFakeTransparencyDesktopBg->pSurface)
+	if (g_pFakeTransparencyDesktopBg == NULL)
+		return FALSE;
+	int x, y, iOffsetX, iOffsetY;
+	cairo_surface_t *pSurface;
+	if (pContainer->bIsHorizontal)
 	{
-		if (pContainer->bIsHorizontal)
-			cairo_set_source_surface (pCairoContext, g_pFakeTransparencyDesktopBg->pSurface, - pContainer->iWindowPositionX, - pContainer->iWindowPositionY);
-		else
-			cairo_set_source_surface (pCairoContext, g_pFakeTransparencyDesktopBg->pSurface, - pContainer->iWindowPositionY, - pContainer->iWindowPositionX);
+		x = pContainer->iWindowPositionX;
+		y = pContainer->iWindowPositionY;
+		pSurface = gldi_desktop_background_get_area (g_pFakeTransparencyDesktopBg, x, y, pContainer->iWidth, pContainer->iHeight, &iOffsetX, &iOffsetY);
 	}
 	else
+	{
+		x = pContainer->iWindowPositionY;
+		y = pContainer->iWindowPositionX;
+		pSurface = gldi_desktop_background_get_area (g_pFakeTransparencyDesktopBg, x, y, pContainer->iHeight, pContainer->iWidth, &iOffsetX, &iOffsetY);
+	}
+	if (pSurface == NULL)
+		return FALSE;
+	cairo_set_source_surface (pCairoContext, pSurface, iOffsetX - x, iOffsetY - y);
+	return TRUE;
+}
+
+void cairo_dock_init_drawing_context_on_container (GldiContainer *pContainer, cairo_t *pCairoContext)
+{
+	if (! _set_desktop_bg_source (pContainer, pCairoContext))
 		cairo_set_source_rgba (pCairoContext, 0.0, 0.0, 0.0, 0.0);
 	cairo_set_operator (pCairoContext, CAIRO_OPERATOR_SOURCE);
 	cairo_paint (pCairoContext);
@@ -93,13 +111,8 @@ cairo_t *cairo_dock_create_drawing_context_on_area (GldiContainer *pContainer, G
 	
 	///if (myContainersParam.bUseFakeTransparency)
 	///{
-		if (g_pFakeTransparencyDesktopBg && g_pFakeTransparencyDesktopBg->pSurface)
-		{
-			if (pContainer->bIsHorizontal)
-				cairo_set_source_surface (pCairoContext, g_pFakeTransparencyDesktopBg->pSurface, - pContainer->iWindowPositionX, - pContainer->iWindowPositionY);
-			else
-				cairo_set_source_surface (pCairoContext, g_pFakeTransparencyDesktopBg->pSurface, - pContainer->iWindowPositionY, - pContainer->iWindowPositionX);
-		}
+		if (_set_desktop_bg_source (pContainer, pCairoContext))
+			;  // the source is the desktop background behind the container.
 		/**else
 			cairo_set_source_rgba (pCairoContext, 0.8, 0.8, 0.8, 0.0);
 	}*/
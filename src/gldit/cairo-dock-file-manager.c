@@ -17,13 +17,21 @@
 * along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#define _GNU_SOURCE  // syscall
 #include <stdlib.h>      // atoi
-#include <string.h>      // memset
+#include <string.h>      // memset, strrchr
+#include <unistd.h>      // syscall, close
+#include <sys/syscall.h>  // SYS_pidfd_open
 #include <sys/stat.h>    // stat
 #include <fcntl.h>  // open
 #include <sys/sendfile.h>  // sendfile
 #include <errno.h>  // errno
 
+#include <glib.h>
+#if GLIB_CHECK_VERSION (2, 36, 0)
+#include <glib-unix.h>  // g_unix_fd_add
+#endif
+
 #include "gldi-config.h"
 #include "cairo-dock-dock-factory.h"
 #include "cairo-dock-dock-facility.h"
@@ -542,9 +550,84 @@ gboolean cairo_dock_copy_file (const gchar *cFilePath, const gchar *cDestPath)
  /// PID ///
 ///////////
 
+typedef struct {
+	int iPID;
+	gchar *cProcessName;  // NULL to only watch iPID, else we wait until no process with this name is running.
+	GSourceFunc pCallback;
+	gpointer pUserData;
+	guint iSidPidFd;  // source watching the pidfd of the process, or 0 if the process is polled.
+	} CDProcessWatch;
+
+static GList *s_pPolledProcesses = NULL;  // processes that couldn't be watched with a pidfd; they all share the same timer.
+static guint s_iSidPollProcesses = 0;
+
+static gboolean _process_name_matches (const gchar *cPID, gchar **cNames)
+{
+	gboolean bMatch = FALSE;
+	int i;
+	// the name of the executable (truncated to 15 chars by the kernel).
+	gchar *cPath = g_strdup_printf ("/proc/%s/comm", cPID);
+	gchar *cComm = NULL;
+	if (g_file_get_contents (cPath, &cComm, NULL, NULL))
+	{
+		g_strchomp (cComm);
+		for (i = 0; cNames[i] != NULL && ! bMatch; i ++)
+			bMatch = (*cNames[i] != '\0' && strcmp (cComm, cNames[i]) == 0);
+		g_free (cComm);
+	}
+	g_free (cPath);
+	if (bMatch)
+		return TRUE;
+	
+	// the base name of argv[0], like 'pidof' does (needed for scripts and long names).
+	cPath = g_strdup_printf ("/proc/%s/cmdline", cPID);
+	gchar *cCmdLine = NULL;
+	if (g_file_get_contents (cPath, &cCmdLine, NULL, NULL))  // arguments are separated by '\0', so we only get argv[0]
+	{
+		gchar *cBaseName = strrchr (cCmdLine, '/');
+		cBaseName = (cBaseName ? cBaseName + 1 : cCmdLine);
+		for (i = 0; cNames[i] != NULL && ! bMatch; i ++)
+			bMatch = (*cNames[i] != '\0' && strcmp (cBaseName, cNames[i]) == 0);
+		g_free (cCmdLine);
+	}
+	g_free (cPath);
+	return bMatch;
+}
+
+static int _get_pid_from_proc (const gchar *cProcessName, gboolean *bProcAvailable)
+{
+	GDir *dir = g_dir_open ("/proc", 0, NULL);
+	if (dir == NULL)
+	{
+		*bProcAvailable = FALSE;
+		return -1;
+	}
+	*bProcAvailable = TRUE;
+	
+	int iPID = -1, iCurrentPID;
+	gchar **cNames = g_strsplit (cProcessName, " ", -1);  // 'pidof' accepts several names.
+	const gchar *cFileName;
+	while ((cFileName = g_dir_read_name (dir)) != NULL)
+	{
+		if (! g_ascii_isdigit (*cFileName))
+			continue;
+		iCurrentPID = atoi (cFileName);
+		if (iCurrentPID > iPID && _process_name_matches (cFileName, cNames))  // 'pidof' lists the most recent process first.
+			iPID = iCurrentPID;
+	}
+	g_strfreev (cNames);
+	g_dir_close (dir);
+	return iPID;
+}
+
 int cairo_dock_fm_get_pid (const gchar *cProcessName)
 {
-	int iPID = -1;
+	gboolean bProcAvailable;
+	int iPID = _get_pid_from_proc (cProcessName, &bProcAvailable);
+	if (bProcAvailable)
+		return iPID;
+	
+	// no /proc (e.g. not Linux), use 'pidof' as a fallback.
 	gchar *cCommand = g_strdup_printf ("pidof %s", cProcessName);
 	gchar *cPID = cairo_dock_launch_command_sync (cCommand);
 
@@ -557,30 +640,119 @@ int cairo_dock_fm_get_pid (const gchar *cProcessName)
 	return iPID;
 }
 
-static gboolean _wait_pid (gpointer *pData)
+static inline gboolean _process_is_running (int iPID)
 {
-	gboolean bCheckSameProcess = GPOINTER_TO_INT (pData[0]);
-	gchar *cProcess = pData[1];
+	gchar *cProcDir = g_strdup_printf ("/proc/%d", iPID);
+	gboolean bRunning = g_file_test (cProcDir, G_FILE_TEST_EXISTS);
+	g_free (cProcDir);
+	return bRunning;
+}
 
-	// check if /proc/%d dir exists or the process is running
-	if ((bCheckSameProcess && ! g_file_test (cProcess, G_FILE_TEST_EXISTS))
-		|| (! bCheckSameProcess && cairo_dock_fm_get_pid (cProcess) == -1))
-	{
-		GSourceFunc pCallback = pData[2];
-		gpointer pUserData = pData[3];
+static int _open_pidfd (int iPID)
+{
+	#if defined(SYS_pidfd_open) && GLIB_CHECK_VERSION (2, 36, 0)
+	return syscall (SYS_pidfd_open, iPID, 0);
+	#else
+	(void)iPID;
+	errno = ENOSYS;
+	return -1;
+	#endif
+}
 
-		pCallback (pUserData);
+static void _start_watching_process (CDProcessWatch *pWatch);
 
-		// free allocated ressources just used for this function
-		g_free (cProcess);
-		g_free (pData);
+static void _free_process_watch (CDProcessWatch *pWatch)
+{
+	g_free (pWatch->cProcessName);
+	g_free (pWatch);
+}
 
-		return FALSE;
+static void _on_process_exited (CDProcessWatch *pWatch)
+{
+	if (pWatch->cProcessName != NULL)  // another process with the same name may be running.
+	{
+		int iPID = cairo_dock_fm_get_pid (pWatch->cProcessName);
+		if (iPID != -1)
+		{
+			pWatch->iPID = iPID;
+			_start_watching_process (pWatch);
+			return;
+		}
 	}
+	
+	pWatch->pCallback (pWatch->pUserData);
+	_free_process_watch (pWatch);
+}
 
+static gboolean _poll_processes (G_GNUC_UNUSED gpointer data)
+{
+	GList *pExitedProcesses = NULL;
+	CDProcessWatch *pWatch;
+	GList *p = s_pPolledProcesses, *next_p;
+	while (p != NULL)
+	{
+		pWatch = p->data;
+		next_p = p->next;
+		if (! _process_is_running (pWatch->iPID))
+		{
+			s_pPolledProcesses = g_list_delete_link (s_pPolledProcesses, p);
+			pExitedProcesses = g_list_prepend (pExitedProcesses, pWatch);
+		}
+		p = next_p;
+	}
+	
+	// callbacks may watch new processes, so only call them once the list is up-to-date.
+	for (p = pExitedProcesses; p != NULL; p = p->next)
+		_on_process_exited (p->data);
+	g_list_free (pExitedProcesses);
+	
+	if (s_pPolledProcesses == NULL)
+	{
+		s_iSidPollProcesses = 0;
+		return FALSE;
+	}
 	return TRUE;
 }
 
+static gboolean _on_process_already_exited (CDProcessWatch *pWatch)
+{
+	_on_process_exited (pWatch);
+	return FALSE;
+}
+
+#if GLIB_CHECK_VERSION (2, 36, 0)
+static gboolean _on_pidfd_readable (gint iPidFd, G_GNUC_UNUSED GIOCondition iCondition, CDProcessWatch *pWatch)
+{
+	// the pidfd becomes readable as soon as the process has terminated.
+	close (iPidFd);
+	pWatch->iSidPidFd = 0;
+	_on_process_exited (pWatch);
+	return FALSE;
+}
+#endif
+
+static void _start_watching_process (CDProcessWatch *pWatch)
+{
+	int iPidFd = _open_pidfd (pWatch->iPID);
+	if (iPidFd >= 0)
+	{
+		#if GLIB_CHECK_VERSION (2, 36, 0)
+		pWatch->iSidPidFd = g_unix_fd_add (iPidFd, G_IO_IN, (GUnixFDSourceFunc)_on_pidfd_readable, pWatch);
+		#endif
+		return;
+	}
+	if (errno == ESRCH)  // the process is already over; let the caller get its result before the callback is called.
+	{
+		g_idle_add ((GSourceFunc)_on_process_already_exited, pWatch);
+		return;
+	}
+	
+	// no pidfd support (old kernel or not Linux), poll /proc with a timer shared by all the watched processes.
+	s_pPolledProcesses = g_list_prepend (s_pPolledProcesses, pWatch);
+	if (s_iSidPollProcesses == 0)
+		s_iSidPollProcesses = g_timeout_add_seconds (1, (GSourceFunc)_poll_processes, NULL);
+}
+
 gboolean cairo_dock_fm_monitor_pid (const gchar *cProcessName, gboolean bCheckSameProcess, GSourceFunc pCallback, gboolean bAlwaysLaunch, gpointer pUserData)
 {
 	int iPID = cairo_dock_fm_get_pid (cProcessName);
@@ -591,23 +763,17 @@ gboolean cairo_dock_fm_monitor_pid (const gchar *cProcessName, gboolean bCheckSa
 		return FALSE;
 	}
 
-	gpointer *pData = g_new (gpointer, 4);
-	pData[0] = GINT_TO_POINTER (bCheckSameProcess);
-	if (bCheckSameProcess)
-		pData[1] = g_strdup_printf ("/proc/%d", iPID);
-	else
-		pData[1] = g_strdup (cProcessName);
-	pData[2] = pCallback;
-	pData[3] = pUserData;
-
-	/* It's not easy to be notified when a non child process is stopped...
-	 * We can't use waitpid (not a child process) or monitor /proc/PID dir (or a
-	 * file into it) with g_file_monitor, poll or inotify => it's not working...
-	 * And for apt-get/dpkg, we can't monitor the lock file with fcntl because
-	 * we need root rights to do that.
-	 * Let's just check every 5 seconds if the PID is still running
+	/* We can't use waitpid (not a child process) nor monitor /proc/PID with
+	 * inotify, but since Linux 5.3 a pidfd can be polled to know when a process
+	 * is terminated. Without it, we fall back to checking /proc/PID regularly.
 	 */
-	g_timeout_add_seconds (5, (GSourceFunc)_wait_pid, pData);
+	CDProcessWatch *pWatch = g_new0 (CDProcessWatch, 1);
+	pWatch->iPID = iPID;
+	if (! bCheckSameProcess)
+		pWatch->cProcessName = g_strdup (cProcessName);
+	pWatch->pCallback = pCallback;
+	pWatch->pUserData = pUserData;
+	_start_watching_process (pWatch);
 
 	return TRUE;
 }
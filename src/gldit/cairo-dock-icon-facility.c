@@ -51,6 +51,7 @@ extern gchar *g_cCurrentLaunchersPath;
 extern CairoDockHidingEffect *g_pHidingBackend;
 
 extern CairoDockImageBuffer g_pIconBackgroundBuffer;
+extern CairoDock *g_pMainDock;
 
 
 void gldi_icon_set_appli (Icon *pIcon, GldiWindowActor *pAppli)
@@ -290,6 +291,127 @@ Icon *cairo_dock_get_previous_icon (GList *pIconList, Icon *pIcon)
 	return NULL;
 }
 
+  ////////////////////
+ /// ICONS INDEX ///
+////////////////////
+
+// each dock indexes its icons by name, URI and sub-dock, so that searching an icon in the list of a dock doesn't need to go through all of them. Each key points to the first icon of the list having this key.
+// The index is kept up to date when an icon is inserted, removed or moved, and when one of these fields is modified (see cairo_dock_reindex_icon), so a search can trust it, including when it misses.
+typedef struct {
+	GHashTable *pByName;
+	GHashTable *pByURI;
+	GHashTable *pBySubDock;
+	} CDIconIndex;
+
+static void _index_icon (CDIconIndex *pIndex, Icon *icon)
+{
+	Icon *pOtherIcon;
+	#define _index_key(table, key, copy) do {\
+		if ((key) != NULL) {\
+			pOtherIcon = g_hash_table_lookup (table, key);\
+			if (pOtherIcon == NULL || cairo_dock_compare_icons_order (icon, pOtherIcon) <= 0)\
+				g_hash_table_insert (table, copy, icon); } } while (0)
+	_index_key (pIndex->pByName, icon->cName, g_strdup (icon->cName));
+	_index_key (pIndex->pByURI, icon->cBaseURI, g_strdup (icon->cBaseURI));
+	_index_key (pIndex->pBySubDock, icon->pSubDock, icon->pSubDock);
+	#undef _index_key
+}
+
+static CDIconIndex *_build_icon_index (CairoDock *pDock)
+{
+	CDIconIndex *pIndex = g_new0 (CDIconIndex, 1);
+	// keep a copy of the keys, since the fields of an icon are modified before it's re-indexed.
+	pIndex->pByName = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	pIndex->pByURI = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	pIndex->pBySubDock = g_hash_table_new (g_direct_hash, g_direct_equal);
+	GList *ic;
+	for (ic = g_list_last (pDock->icons); ic != NULL; ic = ic->prev)  // from the end, so that the first icon of the list wins.
+		_index_icon (pIndex, ic->data);
+	return pIndex;
+}
+
+void cairo_dock_free_icon_index (CairoDock *pDock)
+{
+	CDIconIndex *pIndex = pDock->pIconIndex;
+	if (pIndex == NULL)
+		return;
+	g_hash_table_destroy (pIndex->pByName);
+	g_hash_table_destroy (pIndex->pByURI);
+	g_hash_table_destroy (pIndex->pBySubDock);
+	g_free (pIndex);
+	pDock->pIconIndex = NULL;
+}
+
+void cairo_dock_index_icon (CairoDock *pDock, Icon *icon)
+{
+	if (pDock->pIconIndex != NULL)
+		_index_icon (pDock->pIconIndex, icon);
+}
+
+// remove the entries pointing on an icon, whatever their key (the fields of the icon may have changed since it was indexed), and let the next icon having the same key (if any) take its place.
+static void _unindex_icon_from_table (GHashTable *pTable, CairoDock *pDock, Icon *icon, gsize iFieldOffset, gboolean bStringKey)
+{
+	GHashTableIter iter;
+	gpointer key, value, field;
+	GList *ic;
+	Icon *pOtherIcon, *pNextIcon;
+	g_hash_table_iter_init (&iter, pTable);
+	while (g_hash_table_iter_next (&iter, &key, &value))
+	{
+		if (value != icon)
+			continue;
+		pNextIcon = NULL;
+		for (ic = pDock->icons; ic != NULL; ic = ic->next)
+		{
+			pOtherIcon = ic->data;
+			field = G_STRUCT_MEMBER (gpointer, pOtherIcon, iFieldOffset);
+			if (pOtherIcon != icon && field != NULL && (bStringKey ? strcmp (field, key) == 0 : field == key))
+			{
+				pNextIcon = pOtherIcon;
+				break;
+			}
+		}
+		if (pNextIcon != NULL)
+			g_hash_table_iter_replace (&iter, pNextIcon);
+		else
+			g_hash_table_iter_remove (&iter);
+	}
+}
+
+void cairo_dock_unindex_icon (CairoDock *pDock, Icon *icon)
+{
+	CDIconIndex *pIndex = pDock->pIconIndex;
+	if (pIndex == NULL)
+		return;
+	_unindex_icon_from_table (pIndex->pByName, pDock, icon, G_STRUCT_OFFSET (Icon, cName), TRUE);
+	_unindex_icon_from_table (pIndex->pByURI, pDock, icon, G_STRUCT_OFFSET (Icon, cBaseURI), TRUE);
+	_unindex_icon_from_table (pIndex->pBySubDock, pDock, icon, G_STRUCT_OFFSET (Icon, pSubDock), FALSE);
+}
+
+void cairo_dock_reindex_icon (Icon *pIcon)
+{
+	GldiContainer *pContainer = cairo_dock_get_icon_container (pIcon);
+	if (! CAIRO_DOCK_IS_DOCK (pContainer))
+		return;
+	CairoDock *pDock = CAIRO_DOCK (pContainer);
+	cairo_dock_unindex_icon (pDock, pIcon);
+	cairo_dock_index_icon (pDock, pIcon);
+}
+
+// get the index of the dock owning this list, or NULL if the list is not the list of a dock.
+static CDIconIndex *_get_icon_index (GList *pIconList)
+{
+	if (pIconList == NULL)
+		return NULL;
+	GldiContainer *pContainer = cairo_dock_get_icon_container ((Icon*)pIconList->data);
+	if (! CAIRO_DOCK_IS_DOCK (pContainer) || CAIRO_DOCK (pContainer)->icons != pIconList)
+		return NULL;
+	CairoDock *pDock = CAIRO_DOCK (pContainer);
+	if (pDock->pIconIndex == NULL)
+		pDock->pIconIndex = _build_icon_index (pDock);
+	return pDock->pIconIndex;
+}
+
 Icon *cairo_dock_get_icon_with_command (GList *pIconList, const gchar *cCommand)
 {
 	g_return_val_if_fail (cCommand != NULL, NULL);
@@ -307,6 +429,9 @@ Icon *cairo_dock_get_icon_with_command (GList *pIconList, const gchar *cCommand)
 Icon *cairo_dock_get_icon_with_base_uri (GList *pIconList, const gchar *cBaseURI)
 {
 	g_return_val_if_fail (cBaseURI != NULL, NULL);
+	CDIconIndex *pIndex = _get_icon_index (pIconList);
+	if (pIndex != NULL)
+		return g_hash_table_lookup (pIndex->pByURI, cBaseURI);
 	GList* ic;
 	Icon *icon;
 	for (ic = pIconList; ic != NULL; ic = ic->next)
@@ -322,6 +447,9 @@ Icon *cairo_dock_get_icon_with_base_uri (GList *pIconList, const gchar *cBaseURI
 Icon *cairo_dock_get_icon_with_name (GList *pIconList, const gchar *cName)
 {
 	g_return_val_if_fail (cName != NULL, NULL);
+	CDIconIndex *pIndex = _get_icon_index (pIconList);
+	if (pIndex != NULL)
+		return g_hash_table_lookup (pIndex->pByName, cName);
 	GList* ic;
 	Icon *icon;
 	for (ic = pIconList; ic != NULL; ic = ic->next)
@@ -336,6 +464,12 @@ Icon *cairo_dock_get_icon_with_name (GList *pIconList, const gchar *cName)
 
 Icon *cairo_dock_get_icon_with_subdock (GList *pIconList, CairoDock *pSubDock)
 {
+	if (pSubDock != NULL)  // the icons without sub-dock are not indexed.
+	{
+		CDIconIndex *pIndex = _get_icon_index (pIconList);
+		if (pIndex != NULL)
+			return g_hash_table_lookup (pIndex->pBySubDock, pSubDock);
+	}
 	GList* ic;
 	Icon *icon;
 	for (ic = pIconList; ic != NULL; ic = ic->next)
@@ -347,6 +481,90 @@ Icon *cairo_dock_get_icon_with_subdock (GList *pIconList, CairoDock *pSubDock)
 	return NULL;
 }
 
+#define CD_BENCHMARK_SEARCH_DOCK_NAME "_Benchmark_searches_"
+#define CD_BENCHMARK_SEARCH_NB_ROUNDS 20
+void cairo_dock_benchmark_icon_searches (int iNbIcons)
+{
+	g_return_if_fail (iNbIcons > 0 && g_pMainDock != NULL);
+
+	//\_______________ make a dock with some dummy icons having a name, an URI and a sub-dock; it's a sub-dock, so that it's never shown.
+	GList *pIconList = NULL;
+	Icon *icon;
+	int i;
+	for (i = 0; i < iNbIcons; i ++)
+	{
+		icon = cairo_dock_create_dummy_launcher (g_strdup_printf ("icon %d", i), NULL, NULL, NULL, i);
+		icon->cBaseURI = g_strdup_printf ("file:///benchmark/icon-%d", i);
+		pIconList = g_list_prepend (pIconList, icon);
+	}
+	pIconList = g_list_reverse (pIconList);
+	CairoDock *pDock = gldi_subdock_new (CD_BENCHMARK_SEARCH_DOCK_NAME, NULL, g_pMainDock, pIconList);
+	g_return_if_fail (pDock != NULL);
+
+	gchar *pFakeSubDocks = g_new0 (gchar, iNbIcons);  // the searches only compare the pointers, so they don't need to be real docks.
+	GList *ic;
+	for (ic = pDock->icons, i = 0; ic != NULL; ic = ic->next, i ++)
+	{
+		icon = ic->data;
+		icon->pSubDock = (CairoDock*)&pFakeSubDocks[i];
+		cairo_dock_reindex_icon (icon);
+	}
+
+	//\_______________ search each icon by name, URI and sub-dock, in the list of the dock (indexed) and in a copy of it (not indexed).
+	gchar **cNames = g_new (gchar*, iNbIcons);
+	gchar **cURIs = g_new (gchar*, iNbIcons);
+	for (ic = pDock->icons, i = 0; ic != NULL; ic = ic->next, i ++)
+	{
+		icon = ic->data;
+		cNames[i] = icon->cName;
+		cURIs[i] = icon->cBaseURI;
+	}
+	GList *pLists[2] = {pDock->icons, g_list_copy (pDock->icons)};
+	const gchar *cModes[2] = {"indexed", "linear"};
+	Icon *pFoundIcons[2][3];
+	int iNbMismatches = 0;
+	gint64 t, iDuration[2] = {0, 0};
+	int m, r;
+	for (r = 0; r < CD_BENCHMARK_SEARCH_NB_ROUNDS; r ++)
+	{
+		for (i = 0; i < iNbIcons; i ++)
+		{
+			for (m = 0; m < 2; m ++)
+			{
+				t = g_get_monotonic_time ();
+				pFoundIcons[m][0] = cairo_dock_get_icon_with_name (pLists[m], cNames[i]);
+				pFoundIcons[m][1] = cairo_dock_get_icon_with_base_uri (pLists[m], cURIs[i]);
+				pFoundIcons[m][2] = cairo_dock_get_icon_with_subdock (pLists[m], (CairoDock*)&pFakeSubDocks[i]);
+				iDuration[m] += g_get_monotonic_time () - t;
+			}
+			if (memcmp (pFoundIcons[0], pFoundIcons[1], sizeof (pFoundIcons[0])) != 0)
+				iNbMismatches ++;
+		}
+	}
+	for (m = 0; m < 2; m ++)
+	{
+		g_print ("{\"icons\":%d, \"mode\":\"%s\", \"searches\":%d, \"time_us\":%" G_GINT64_FORMAT ", \"ns_per_search\":%.1f, \"mismatches\":%d}\n",
+			iNbIcons,
+			cModes[m],
+			3 * iNbIcons * CD_BENCHMARK_SEARCH_NB_ROUNDS,
+			iDuration[m],
+			1e3 * iDuration[m] / (3. * iNbIcons * CD_BENCHMARK_SEARCH_NB_ROUNDS),
+			iNbMismatches);
+	}
+	g_list_free (pLists[1]);
+	g_free (cNames);
+	g_free (cURIs);
+
+	//\_______________ the sub-docks are fake, don't let the icons destroy them.
+	for (ic = pDock->icons; ic != NULL; ic = ic->next)
+	{
+		icon = ic->data;
+		icon->pSubDock = NULL;
+	}
+	gldi_object_unref (GLDI_OBJECT (pDock));
+	g_free (pFakeSubDocks);
+}
+
 static gboolean _has_dialog (CairoDialog *pDialog, Icon *pIcon)
 {
 	return (pDialog->pIcon == pIcon);
@@ -468,31 +686,65 @@ void cairo_dock_normalize_icons_order (GList *pIconList, CairoDockIconGroup iGro
 	cd_message ("%s (%d)", __func__, iGroup);
 	int iOrder = 1;
 	CairoDockIconGroup iGroupOrder = cairo_dock_get_group_order (iGroup);
-	GString *sDesktopFilePath = g_string_new ("");
 	GList* ic;
 	Icon *icon;
+	gldi_theme_icons_begin_order_batch ();
 	for (ic = pIconList; ic != NULL; ic = ic->next)
 	{
 		icon = ic->data;
 		if (cairo_dock_get_icon_order (icon) != iGroupOrder)
 			continue;
 		
-		icon->fOrder = iOrder ++;
-		if (icon->cDesktopFileName != NULL)
+		if (icon->fOrder != iOrder)  // only write the icons that actually change.
 		{
-			g_string_printf (sDesktopFilePath, "%s/%s", g_cCurrentLaunchersPath, icon->cDesktopFileName);
-			cairo_dock_update_conf_file (sDesktopFilePath->str,
-				G_TYPE_DOUBLE, "Desktop Entry", "Order", icon->fOrder,
-				G_TYPE_INVALID);
+			icon->fOrder = iOrder;
+			gldi_theme_icon_write_order_in_conf_file (icon, icon->fOrder);
 		}
-		else if (CAIRO_DOCK_IS_APPLET (icon))
+		iOrder ++;
+	}
+	gldi_theme_icons_commit_order_batch ();
+}
+
+// spread evenly the icons of the group of 'pIcon' whose order is in the same unit interval as its order; the other icons keep their order, so usually only a few icons have to be updated.
+static gboolean _spread_icons_order (GList *pIconList, Icon *pIcon)
+{
+	CairoDockIconGroup iGroupOrder = cairo_dock_get_icon_order (pIcon);
+	double fLowerOrder = floor (pIcon->fOrder);
+	GList *pFirst = NULL, *ic;
+	Icon *icon;
+	int n = 0;
+	for (ic = pIconList; ic != NULL; ic = ic->next)  // the list is sorted, so these icons are consecutive.
+	{
+		icon = ic->data;
+		if (cairo_dock_get_icon_order (icon) != iGroupOrder || icon->fOrder < fLowerOrder)
+			continue;
+		if (icon->fOrder >= fLowerOrder + 1)
+			break;
+		if (pFirst == NULL)
+			pFirst = ic;
+		n ++;
+	}
+	if (n == 0 || 1. / n < CAIRO_DOCK_MIN_ORDER_GAP)  // not enough room (would need a lot of icons), renumber the whole group.
+		return FALSE;
+	
+	int i;
+	double fOrder;
+	gldi_theme_icons_begin_order_batch ();
+	for (ic = pFirst, i = 0; i < n; ic = ic->next)
+	{
+		icon = ic->data;
+		if (cairo_dock_get_icon_order (icon) != iGroupOrder)
+			continue;
+		fOrder = fLowerOrder + (double)i / n;
+		if (icon->fOrder != fOrder)
 		{
-			cairo_dock_update_conf_file (icon->pModuleInstance->cConfFilePath,
-				G_TYPE_DOUBLE, "Icon", "order", icon->fOrder,
-				G_TYPE_INVALID);
+			icon->fOrder = fOrder;
+			gldi_theme_icon_write_order_in_conf_file (icon, icon->fOrder);
 		}
+		i ++;
 	}
-	g_string_free (sDesktopFilePath, TRUE);
+	gldi_theme_icons_commit_order_batch ();
+	return TRUE;
 }
 
 void cairo_dock_move_icon_after_icon (CairoDock *pDock, Icon *icon1, Icon *icon2)  // move icon1 after icon2,or at the beginning of the dock/group if icon2 is NULL.
@@ -500,12 +752,14 @@ void cairo_dock_move_icon_after_icon (CairoDock *pDock, Icon *icon1, Icon *icon2
 	//g_print ("%s (%s, %.2f, %x)\n", __func__, icon1->cName, icon1->fOrder, icon2);
 	if ((icon2 != NULL) && fabs (cairo_dock_get_icon_order (icon1) - cairo_dock_get_icon_order (icon2)) > 1)
 		return ;
+	gldi_theme_icons_begin_order_batch ();  // the order of icon1 may be written again below, if the icons around it are respaced.
+	
 	//\_________________ On change l'ordre de l'icone.
 	gboolean bForceUpdate = FALSE;
 	if (icon2 != NULL)
 	{
 		Icon *pNextIcon = cairo_dock_get_next_icon (pDock->icons, icon2);
-		if (pNextIcon != NULL && fabs (pNextIcon->fOrder - icon2->fOrder) < 1e-2)
+		if (pNextIcon != NULL && fabs (pNextIcon->fOrder - icon2->fOrder) < 2 * CAIRO_DOCK_MIN_ORDER_GAP)  // no more room between the 2 icons.
 		{
 			bForceUpdate = TRUE;
 		}
@@ -528,10 +782,12 @@ void cairo_dock_move_icon_after_icon (CairoDock *pDock, Icon *icon1, Icon *icon2
 	gldi_theme_icon_write_order_in_conf_file (icon1, icon1->fOrder);
 	
 	//\_________________ On change sa place dans la liste.
+	cairo_dock_unindex_icon (pDock, icon1);
 	pDock->icons = g_list_remove (pDock->icons, icon1);
 	pDock->icons = g_list_insert_sorted (pDock->icons,
 		icon1,
 		(GCompareFunc) cairo_dock_compare_icons_order);
+	cairo_dock_index_icon (pDock, icon1);
 
 	//\_________________ On recalcule la largeur max, qui peut avoir ete influencee par le changement d'ordre.
 	cairo_dock_trigger_update_dock_size (pDock);
@@ -546,8 +802,9 @@ void cairo_dock_move_icon_after_icon (CairoDock *pDock, Icon *icon1, Icon *icon2
 		cairo_dock_redraw_subdock_content (pDock);
 	}
 	
-	if (bForceUpdate)
+	if (bForceUpdate && ! _spread_icons_order (pDock->icons, icon1))
 		cairo_dock_normalize_icons_order (pDock->icons, icon1->iGroup);
+	gldi_theme_icons_commit_order_batch ();
 	
 	//\_________________ Notify everybody.
 	gldi_object_notify (pDock, NOTIFICATION_ICON_MOVED, icon1, pDock);
@@ -569,6 +826,7 @@ void gldi_icon_set_name (Icon *pIcon, const gchar *cIconName)  // fonction propo
 	{
 		g_free (pIcon->cName);
 		pIcon->cName = g_strdup (cIconName);
+		cairo_dock_reindex_icon (pIcon);
 	}
 	
 	g_free (cUniqueName);
@@ -650,6 +908,7 @@ cairo_t *cairo_dock_begin_draw_icon_cairo (Icon *pIcon, gint iRenderingMode, cai
 void cairo_dock_end_draw_icon_cairo (Icon *pIcon)
 {
 	cairo_dock_end_draw_image_buffer_cairo (&pIcon->image);
+	cairo_dock_mark_icon_image_changed (pIcon);
 }
 
 gboolean cairo_dock_begin_draw_icon (Icon *pIcon, gint iRenderingMode)
@@ -680,6 +939,7 @@ gboolean cairo_dock_begin_draw_icon (Icon *pIcon, gint iRenderingMode)
 void cairo_dock_end_draw_icon (Icon *pIcon)
 {
 	cairo_dock_end_draw_image_buffer_opengl (&pIcon->image, pIcon->pContainer);
+	cairo_dock_mark_icon_image_changed (pIcon);
 }
 
 
@@ -702,7 +962,10 @@ void gldi_theme_icon_write_container_name_in_conf_file (Icon *pIcon, const gchar
 	}
 }
 
-void gldi_theme_icon_write_order_in_conf_file (Icon *pIcon, double fOrder)
+static gint s_iOrderBatchDepth = 0;
+static GHashTable *s_pPendingOrders = NULL;  // icon -> order to write at the end of the batch.
+
+static void _write_order_in_conf_file (Icon *pIcon, double fOrder)
 {
 	if (GLDI_OBJECT_IS_USER_ICON (pIcon))
 	{
@@ -721,6 +984,45 @@ void gldi_theme_icon_write_order_in_conf_file (Icon *pIcon, double fOrder)
 	}
 }
 
+void gldi_theme_icon_write_order_in_conf_file (Icon *pIcon, double fOrder)
+{
+	if (s_iOrderBatchDepth > 0)  // write it once at the end of the batch.
+	{
+		if (s_pPendingOrders == NULL)
+			s_pPendingOrders = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, g_free);
+		gdouble *pOrder = g_new (gdouble, 1);
+		*pOrder = fOrder;
+		g_hash_table_insert (s_pPendingOrders, pIcon, pOrder);
+		return;
+	}
+	_write_order_in_conf_file (pIcon, fOrder);
+}
+
+void gldi_theme_icons_begin_order_batch (void)
+{
+	s_iOrderBatchDepth ++;
+}
+
+void gldi_theme_icons_commit_order_batch (void)
+{
+	g_return_if_fail (s_iOrderBatchDepth > 0);
+	s_iOrderBatchDepth --;
+	if (s_iOrderBatchDepth > 0 || s_pPendingOrders == NULL)
+		return;
+	
+	GHashTable *pPendingOrders = s_pPendingOrders;
+	s_pPendingOrders = NULL;
+	GHashTableIter iter;
+	gpointer pIcon, pOrder;
+	g_hash_table_iter_init (&iter, pPendingOrders);
+	while (g_hash_table_iter_next (&iter, &pIcon, &pOrder))
+	{
+		_write_order_in_conf_file (pIcon, *(gdouble*)pOrder);
+	}
+	cd_debug ("%d orders written", g_hash_table_size (pPendingOrders));
+	g_hash_table_destroy (pPendingOrders);
+}
+
 
 
 gboolean gldi_icon_launch_command (Icon *pIcon)
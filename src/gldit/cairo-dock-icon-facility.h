@@ -228,6 +228,20 @@ Icon *cairo_dock_get_icon_with_name (GList *pIconList, const gchar *cName);
 */
 Icon *cairo_dock_get_icon_with_subdock (GList *pIconList, CairoDock *pSubDock);
 
+/** Update the index of the dock of an icon after its name, URI or sub-dock has been modified directly, so that the searches above find it with its new value. It must be called each time one of these fields is modified while the icon is inside a dock (\ref gldi_icon_set_name does it).
+*@param pIcon the icon.
+*/
+void cairo_dock_reindex_icon (Icon *pIcon);
+
+/** Measure the searches of icons by name, URI and sub-dock in a dock with a given number of icons, with the index of the dock and with a linear scan of the list, and print the results as JSON objects.
+*@param iNbIcons number of icons in the dock.
+*/
+void cairo_dock_benchmark_icon_searches (int iNbIcons);
+
+void cairo_dock_index_icon (CairoDock *pDock, Icon *icon);
+void cairo_dock_unindex_icon (CairoDock *pDock, Icon *icon);
+void cairo_dock_free_icon_index (CairoDock *pDock);
+
 Icon *gldi_icons_get_without_dialog (GList *pIconList);
 
 #define gldi_icons_get_any_without_dialog(...) gldi_icons_get_without_dialog (g_pMainDock?g_pMainDock->icons:NULL);
@@ -260,6 +274,9 @@ void cairo_dock_compute_icon_area (Icon *icon, GldiContainer *pContainer, GdkRec
 
 
 
+/// Smallest difference between the orders of 2 icons; when there is no more room between 2 icons, the orders around them are spread again.
+#define CAIRO_DOCK_MIN_ORDER_GAP 1e-6
+
 void cairo_dock_normalize_icons_order (GList *pIconList, CairoDockIconGroup iGroup);
 
 void cairo_dock_move_icon_after_icon (CairoDock *pDock, Icon *icon1, Icon *icon2);
@@ -334,6 +351,14 @@ void gldi_theme_icon_write_container_name_in_conf_file (Icon *pIcon, const gchar
 
 void gldi_theme_icon_write_order_in_conf_file (Icon *pIcon, double fOrder);
 
+/** Start a batch of order changes: until \ref gldi_theme_icons_commit_order_batch is called, \ref gldi_theme_icon_write_order_in_conf_file only remembers the new order, and each conf file is then written once. Batches can be nested.
+*/
+void gldi_theme_icons_begin_order_batch (void);
+
+/** Write the orders changed since \ref gldi_theme_icons_begin_order_batch into the conf files.
+*/
+void gldi_theme_icons_commit_order_batch (void);
+
 
 gboolean gldi_icon_launch_command (Icon *pIcon);
 
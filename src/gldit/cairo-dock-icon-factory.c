@@ -32,17 +32,21 @@
 #include "cairo-dock-utils.h"  // cairo_dock_cut_string
 #include "cairo-dock-applications-manager.h"  // myTaskbarParam.iAppliMaxNameLength
 #include "cairo-dock-separator-manager.h"  // GLDI_OBJECT_IS_SEPARATOR_ICON
+#include "cairo-dock-launcher-manager.h"  // GLDI_OBJECT_IS_LAUNCHER_ICON
+#include "cairo-dock-applet-manager.h"  // GLDI_OBJECT_IS_APPLET_ICON
 #include "cairo-dock-dock-facility.h"  // cairo_dock_update_dock_size
 #include "cairo-dock-backends-manager.h"  // cairo_dock_get_icon_container_renderer
 #include "cairo-dock-icon-facility.h"
 #include "cairo-dock-data-renderer.h"
 #include "cairo-dock-overlay.h"
+#include "cairo-dock-class-manager.h"  // cairo_dock_invalidate_class_image_buffers
 #include "cairo-dock-icon-factory.h"
 
 extern CairoDockImageBuffer g_pIconBackgroundBuffer;
 //extern gboolean g_bUseOpenGL;
 
 const gchar *s_cRendererNames[4] = {NULL, "Emblem", "Stack", "Box"};  // c'est juste pour realiser la transition entre le chiffre en conf, et un nom (limitation du panneau de conf). On garde le numero pour savoir rapidement sur laquelle on set.
+static guint s_iImageVersion = 0;  // global, so that 2 icons never share the same version.
 
 
 Icon *gldi_icon_new (void)
@@ -97,6 +101,7 @@ void cairo_dock_load_icon_image (Icon *icon, G_GNUC_UNUSED GldiContainer *pConta
 		cd_warning ("/!\\ Icon %s is not inside a container !!!", icon->cName);  // it's ok if this happens, but it should be rare, and I'd like to know when, so be noisy.
 		return;
 	}
+	cairo_dock_mark_icon_image_changed (icon);
 	GldiModuleInstance *pInstance = icon->pModuleInstance;  // this is the only function where we destroy/create the icon's surface, so we must handle the cairo-context here.
 	if (pInstance && pInstance->pDrawContext != NULL)
 	{
@@ -116,13 +121,16 @@ void cairo_dock_load_icon_image (Icon *icon, G_GNUC_UNUSED GldiContainer *pConta
 	//\______________ keep the current buffer on the icon so that the 'load' can use it (for instance, applis may draw emblems).
 	cairo_surface_t *pPrevSurface = icon->image.pSurface;
 	GLuint iPrevTexture = icon->image.iTexture;
+	guint iPrevRefs = (pPrevSurface != NULL ? cairo_surface_get_reference_count (pPrevSurface) : 0);  // a shared buffer can be loaded again, with a new reference.
 	
 	//\______________ load the image buffer (surface + texture).
 	if (icon->iface.load_image)
 		icon->iface.load_image (icon);
 	
 	//\______________ if nothing has changed or no image was loaded, set a default image.
-	if ((icon->image.pSurface == pPrevSurface || icon->image.pSurface == NULL)
+	gboolean bSharedAgain = (pPrevSurface != NULL && icon->image.pSurface == pPrevSurface && cairo_surface_get_reference_count (pPrevSurface) > iPrevRefs);
+	if (! bSharedAgain
+	&& (icon->image.pSurface == pPrevSurface || icon->image.pSurface == NULL)
 	&& (icon->image.iTexture == iPrevTexture || icon->image.iTexture == 0))
 	{
 		gchar *cIconPath = cairo_dock_search_image_s_path (CAIRO_DOCK_DEFAULT_ICON_NAME);
@@ -153,6 +161,7 @@ void cairo_dock_load_icon_image (Icon *icon, G_GNUC_UNUSED GldiContainer *pConta
 		}
 		else if (icon->image.pSurface != NULL)
 		{
+			cairo_dock_unshare_image_buffer (&icon->image);
 			cairo_t *pCairoIconBGContext = cairo_create (icon->image.pSurface);
 			cairo_set_operator (pCairoIconBGContext, CAIRO_OPERATOR_DEST_OVER);
 			cairo_dock_apply_image_buffer_surface_at_size (&g_pIconBackgroundBuffer, pCairoIconBGContext,
@@ -162,11 +171,15 @@ void cairo_dock_load_icon_image (Icon *icon, G_GNUC_UNUSED GldiContainer *pConta
 		}
 	}
 	
+	//\______________ the applis of its class take their image from it.
+	if (icon->cClass != NULL && (CAIRO_DOCK_ICON_TYPE_IS_LAUNCHER (icon) || CAIRO_DOCK_ICON_TYPE_IS_APPLET (icon)))
+		cairo_dock_invalidate_class_image_buffers (icon->cClass);
+	
 	//\______________ free the previous buffers.
 	if (pPrevSurface != NULL)
 		cairo_surface_destroy (pPrevSurface);
 	if (iPrevTexture != 0)
-		_cairo_dock_delete_texture (iPrevTexture);
+		cairo_dock_release_texture (iPrevTexture);
 	
 	if (pInstance && icon->image.pSurface != NULL)
 	{
@@ -193,8 +206,10 @@ void cairo_dock_load_icon_text (Icon *icon)
 	}
 	
 	int iWidth, iHeight;
-	cairo_surface_t *pSurface = cairo_dock_create_surface_from_text ((cTruncatedName != NULL ? cTruncatedName : icon->cName),
+	cairo_surface_t *pSurface = cairo_dock_create_surface_from_text_cached ((cTruncatedName != NULL ? cTruncatedName : icon->cName),
 		&myIconsParam.iconTextDescription,
+		1.,
+		0,
 		&iWidth,
 		&iHeight);
 	cairo_dock_load_image_buffer_from_surface (&icon->label, pSurface, iWidth, iHeight);
@@ -215,14 +230,17 @@ void cairo_dock_load_icon_quickinfo (Icon *icon)
 		if (iHeight / (myIconsParam.quickInfoTextDescription.iSize * fMaxScale) > 5)  // if the icon is very height (the text occupies less than 20% of the icon)
 			fMaxScale = MIN ((double)iHeight / (myIconsParam.quickInfoTextDescription.iSize * 5), MAX (1., 16./myIconsParam.quickInfoTextDescription.iSize) * fMaxScale);  // let's make it use 20% of the icon's height, limited to 16px
 		int w, h;
-		cairo_surface_t *pSurface = cairo_dock_create_surface_from_text_full (icon->cQuickInfo,
+		cairo_surface_t *pSurface = cairo_dock_create_surface_from_text_cached (icon->cQuickInfo,
 			&myIconsParam.quickInfoTextDescription,
 			fMaxScale,
 			iWidth,  // limit the text to the width of the icon
 			&w, &h);
 		CairoOverlay *pOverlay = cairo_dock_add_overlay_from_surface (icon, pSurface, w, h, CAIRO_OVERLAY_BOTTOM, (gpointer)"quick-info");  // the constant string "quick-info" is used as a unique identifier for all quick-infos; the surface is taken by the overlay.
 		if (pOverlay)
+		{
 			cairo_dock_set_overlay_scale (pOverlay, 0);
+			cairo_dock_pack_overlay_in_atlas (pOverlay);  // quick-infos are small and are replaced rather than redrawn.
+		}
 	}
 }
 
@@ -265,6 +283,9 @@ static gboolean _load_icon_buffer_idle (Icon *pIcon)
 		cairo_dock_load_icon_quickinfo (pIcon);
 		
 		cairo_dock_redraw_icon (pIcon);
+		
+		if (CAIRO_DOCK_IS_DOCK (pContainer) && CAIRO_DOCK (pContainer)->iRefCount != 0)  // the icon pointing on the sub-dock may display this icon; it's only redrawn if it actually does.
+			cairo_dock_trigger_redraw_subdock_content (CAIRO_DOCK (pContainer));
 		//g_print ("icon-factory: do 1 main loop iteration\n");
 		//gtk_main_iteration_do (FALSE);  /// "unforseen consequences" : if _redraw_subdock_content_idle is planned just after, the container-icon stays blank in opengl only. couldn't figure why exactly :-/
 	}
@@ -285,11 +306,77 @@ void cairo_dock_trigger_load_icon_buffers (Icon *pIcon)
  /// CONTAINER ICONS ///
 ///////////////////////
 
+#define CD_SUBDOCK_PREVIEW_MAX_ICONS 4  // the container renderers draw at most the 4 first icons.
+
+typedef struct {
+	CairoIconContainerRenderer *pRenderer;
+	gint iWidth, iHeight;
+	guint iVersion;  // version of the pointing icon's image, once the content was drawn on it.
+	gint iNbIcons;
+	Icon *pIcons[CD_SUBDOCK_PREVIEW_MAX_ICONS];  // only compared, never dereferenced.
+	guint iVersions[CD_SUBDOCK_PREVIEW_MAX_ICONS];
+	gpointer pImages[CD_SUBDOCK_PREVIEW_MAX_ICONS];
+	gint iPositions[CD_SUBDOCK_PREVIEW_MAX_ICONS];  // position in the sub-dock (separators included)
+	gboolean bHasNext;  // whether the last of these icons is followed by another one (the stack view depends on it).
+	} CDSubdockPreview;
+
+void cairo_dock_mark_icon_image_changed (Icon *pIcon)
+{
+	pIcon->iImageVersion = ++ s_iImageVersion;
+}
+
+static CairoIconContainerRenderer *_get_subdock_content_renderer (Icon *pIcon)
+{
+	return cairo_dock_get_icon_container_renderer (pIcon->cClass != NULL ? "Stack" : s_cRendererNames[pIcon->iSubdockViewType]);
+}
+
+static void _get_subdock_preview (Icon *pIcon, CairoIconContainerRenderer *pRenderer, CDSubdockPreview *pPreview)
+{
+	memset (pPreview, 0, sizeof (CDSubdockPreview));
+	pPreview->pRenderer = pRenderer;
+	cairo_dock_get_icon_extent (pIcon, &pPreview->iWidth, &pPreview->iHeight);
+	pPreview->iVersion = pIcon->iImageVersion;
+	
+	Icon *icon;
+	GList *ic;
+	int i = 0;
+	for (ic = pIcon->pSubDock->icons; ic != NULL; ic = ic->next, i ++)
+	{
+		icon = ic->data;
+		if (GLDI_OBJECT_IS_SEPARATOR_ICON (icon))
+			continue;
+		pPreview->pIcons[pPreview->iNbIcons] = icon;
+		pPreview->iVersions[pPreview->iNbIcons] = icon->iImageVersion;
+		pPreview->pImages[pPreview->iNbIcons] = (icon->image.iTexture != 0 ? GUINT_TO_POINTER (icon->image.iTexture) : (gpointer)icon->image.pSurface);
+		pPreview->iPositions[pPreview->iNbIcons] = i;
+		pPreview->iNbIcons ++;
+		if (pPreview->iNbIcons == CD_SUBDOCK_PREVIEW_MAX_ICONS)
+			break;
+	}
+	pPreview->bHasNext = (ic != NULL && ic->next != NULL);
+}
+
+gboolean cairo_dock_subdock_content_has_changed (Icon *pIcon)
+{
+	CDSubdockPreview *pLastPreview = pIcon->pSubdockPreview;
+	if (pLastPreview == NULL || pIcon->pSubDock == NULL || pIcon->bDamaged)
+		return TRUE;
+	CDSubdockPreview preview;
+	_get_subdock_preview (pIcon, _get_subdock_content_renderer (pIcon), &preview);
+	return (memcmp (&preview, pLastPreview, sizeof (CDSubdockPreview)) != 0);
+}
+
+void cairo_dock_invalidate_subdock_content (Icon *pIcon)
+{
+	g_free (pIcon->pSubdockPreview);
+	pIcon->pSubdockPreview = NULL;
+}
+
 void cairo_dock_draw_subdock_content_on_icon (Icon *pIcon, CairoDock *pDock)
 {
 	g_return_if_fail (pIcon != NULL && pIcon->pSubDock != NULL && (pIcon->image.pSurface != NULL || pIcon->image.iTexture != 0));
 	
-	CairoIconContainerRenderer *pRenderer = cairo_dock_get_icon_container_renderer (pIcon->cClass != NULL ? "Stack" : s_cRendererNames[pIcon->iSubdockViewType]);
+	CairoIconContainerRenderer *pRenderer = _get_subdock_content_renderer (pIcon);
 	if (pRenderer == NULL)
 		return;
 	cd_debug ("%s (%s)", __func__, pIcon->cName);
@@ -327,6 +414,13 @@ void cairo_dock_draw_subdock_content_on_icon (Icon *pIcon, CairoDock *pDock)
 		cairo_dock_end_draw_icon_cairo (pIcon);
 		cairo_destroy (pCairoContext);
 	}
+	else
+		return;
+	
+	//\______________ remember what we drew, to not draw it again if it doesn't change.
+	if (pIcon->pSubdockPreview == NULL)
+		pIcon->pSubdockPreview = g_new (CDSubdockPreview, 1);
+	_get_subdock_preview (pIcon, pRenderer, pIcon->pSubdockPreview);
 }
 
 
@@ -175,7 +175,9 @@ struct _Icon {
 	gint iThumbnailWidth, iThumbnailHeight;
 	
 	gboolean bIsLaunching;  // a mere recopy of gldi_class_is_starting()
-	gpointer reserved[4];
+	guint iImageVersion;  // changes each time the image of the icon is modified.
+	gpointer pSubdockPreview;  // state of the sub-dock the last time its content was drawn on the icon.
+	gpointer reserved[2];
 };
 
 typedef void (*CairoIconContainerLoadFunc) (void);
@@ -296,13 +298,34 @@ void cairo_dock_load_icon_buffers (Icon *pIcon, GldiContainer *pContainer);
 void cairo_dock_trigger_load_icon_buffers (Icon *pIcon);
 
 
+/** Mark the image of an icon as modified, so that the icons that display it (for instance the icon pointing on its sub-dock) know they have to redraw it.
+*@param pIcon the icon.
+*/
+void cairo_dock_mark_icon_image_changed (Icon *pIcon);
+
 void cairo_dock_draw_subdock_content_on_icon (Icon *pIcon, CairoDock *pDock);
 
+/** Say if the content of the sub-dock of an icon has changed since it was last drawn on the icon. Only the icons that are actually displayed on the icon are taken into account.
+*@param pIcon the icon pointing on the sub-dock.
+*@return TRUE if the sub-dock content needs to be drawn again.
+*/
+gboolean cairo_dock_subdock_content_has_changed (Icon *pIcon);
+
+/** Force the next drawing of the sub-dock content on an icon.
+*@param pIcon the icon pointing on the sub-dock.
+*/
+void cairo_dock_invalidate_subdock_content (Icon *pIcon);
+
 #define cairo_dock_set_subdock_content_renderer(pIcon, view) (pIcon)->iSubdockViewType = view
 
 
 void gldi_icon_detach (Icon *pIcon);
 
+/** Insert an icon inside a container. To insert several icons in a row, wrap the insertions in \ref cairo_dock_begin_resize_transaction / \ref cairo_dock_commit_resize_transaction, so that the docks are resized only once.
+*@param pIcon the icon, not yet inside a container.
+*@param pContainer the container.
+*@param bAnimateIcon whether to animate the insertion.
+*/
 void gldi_icon_insert_in_container (Icon *pIcon, GldiContainer *pContainer, gboolean bAnimateIcon);
 
 
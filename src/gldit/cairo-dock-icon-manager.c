@@ -72,6 +72,14 @@ static GtkIconTheme *s_pIconTheme = NULL;
 static gboolean s_bUseLocalIcons = FALSE;
 static gboolean s_bUseDefaultTheme = TRUE;
 static guint s_iSidReloadTheme = 0;
+static GHashTable *s_hPreloadedImages = NULL;  // icon -> CDIconImageJob, while the images of some icons are loaded in parallel.
+
+typedef struct {
+	gchar *cIconPath;
+	int iWidth, iHeight;
+	cairo_surface_t *pSurface;  // filled by a worker thread
+	gboolean bImageSurface;  // TRUE if it has been loaded by a worker thread.
+	} CDIconImageJob;
 
 static void _cairo_dock_unload_icon_textures (void);
 static void _cairo_dock_unload_icon_theme (void);
@@ -941,7 +949,12 @@ static void _load_image (Icon *icon)
 	int iHeight = cairo_dock_icon_get_allocated_height (icon);
 	cairo_surface_t *pSurface = NULL;
 	
-	if (icon->cFileName)
+	CDIconImageJob *pJob = (s_hPreloadedImages != NULL ? g_hash_table_lookup (s_hPreloadedImages, icon) : NULL);
+	if (pJob != NULL && pJob->pSurface != NULL && pJob->iWidth == iWidth && pJob->iHeight == iHeight)  // already loaded by a worker thread (see gldi_icons_load_images).
+	{
+		pSurface = cairo_surface_reference (pJob->pSurface);
+	}
+	else if (icon->cFileName)
 	{
 		gchar *cIconPath = cairo_dock_search_icon_s_path (icon->cFileName, MAX (iWidth, iHeight));
 		if (cIconPath != NULL && *cIconPath != '\0')
@@ -952,6 +965,116 @@ static void _load_image (Icon *icon)
 	}
 	cairo_dock_load_image_buffer_from_surface (&icon->image, pSurface, iWidth, iHeight);
 }
+
+static void _free_icon_image_job (CDIconImageJob *pJob)
+{
+	g_free (pJob->cIconPath);
+	if (pJob->pSurface != NULL)
+		cairo_surface_destroy (pJob->pSurface);
+	g_free (pJob);
+}
+
+static void _load_icon_image_job (CDIconImageJob *pJob, gpointer bInWorker)
+{
+	if (bInWorker)
+	{
+		cairo_dock_use_image_surfaces_in_this_thread ();
+		pJob->bImageSurface = TRUE;
+	}
+	pJob->pSurface = cairo_dock_create_surface_from_image_simple (pJob->cIconPath,
+		pJob->iWidth,
+		pJob->iHeight);
+}
+
+void gldi_icons_load_images (GList *pIcons, int iNbThreads)
+{
+	//\_______________ find the images of the icons that wait to be loaded; the icon theme can only be used in the main thread.
+	GHashTable *pJobsTable = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);  // "<w>x<h>:<path>" -> job, so that an image shared by several icons is loaded once.
+	GPtrArray *pJobs = g_ptr_array_new_with_free_func ((GDestroyNotify) _free_icon_image_job);
+	s_hPreloadedImages = g_hash_table_new (NULL, NULL);
+	CDIconImageJob *pJob;
+	Icon *icon;
+	GList *ic;
+	int iWidth, iHeight;
+	gchar *cIconPath, *cKey;
+	for (ic = pIcons; ic != NULL; ic = ic->next)
+	{
+		icon = ic->data;
+		if (icon->iface.load_image != _load_image || icon->cFileName == NULL || icon->iSidLoadImage == 0)  // only the generic loading is done in parallel.
+			continue;
+		iWidth = cairo_dock_icon_get_allocated_width (icon);
+		iHeight = cairo_dock_icon_get_allocated_height (icon);
+		if (iWidth <= 0 || iHeight <= 0)
+			continue;
+		cIconPath = cairo_dock_search_icon_s_path (icon->cFileName, MAX (iWidth, iHeight));
+		if (cIconPath == NULL || *cIconPath != '/')
+		{
+			g_free (cIconPath);
+			continue;
+		}
+		cKey = g_strdup_printf ("%dx%d:%s", iWidth, iHeight, cIconPath);
+		pJob = g_hash_table_lookup (pJobsTable, cKey);
+		if (pJob == NULL)
+		{
+			pJob = g_new0 (CDIconImageJob, 1);
+			pJob->cIconPath = cIconPath;
+			pJob->iWidth = iWidth;
+			pJob->iHeight = iHeight;
+			g_hash_table_insert (pJobsTable, cKey, pJob);
+			g_ptr_array_add (pJobs, pJob);
+		}
+		else
+		{
+			g_free (cIconPath);
+			g_free (cKey);
+		}
+		g_hash_table_insert (s_hPreloadedImages, icon, pJob);
+	}
+	g_hash_table_destroy (pJobsTable);
+	
+	//\_______________ load the images in parallel.
+	guint i;
+	GThreadPool *pPool = (iNbThreads > 1 && pJobs->len > 1 ? g_thread_pool_new ((GFunc)_load_icon_image_job, GINT_TO_POINTER (1), iNbThreads, TRUE, NULL) : NULL);
+	for (i = 0; i < pJobs->len; i ++)
+	{
+		pJob = g_ptr_array_index (pJobs, i);
+		if (pPool == NULL || ! g_thread_pool_push (pPool, pJob, NULL))
+			_load_icon_image_job (pJob, NULL);
+	}
+	if (pPool != NULL)
+		g_thread_pool_free (pPool, FALSE, TRUE);  // wait for all the images to be loaded.
+	
+	//\_______________ in cairo, copy them into surfaces of the screen, which are faster to draw.
+	cairo_surface_t *pSurface;
+	cairo_t *pCairoContext;
+	for (i = 0; i < pJobs->len; i ++)
+	{
+		pJob = g_ptr_array_index (pJobs, i);
+		if (g_bUseOpenGL || ! pJob->bImageSurface || pJob->pSurface == NULL)
+			continue;
+		pSurface = cairo_dock_create_blank_surface (pJob->iWidth, pJob->iHeight);
+		pCairoContext = cairo_create (pSurface);
+		cairo_set_source_surface (pCairoContext, pJob->pSurface, 0, 0);
+		cairo_paint (pCairoContext);
+		cairo_destroy (pCairoContext);
+		cairo_surface_destroy (pJob->pSurface);
+		pJob->pSurface = pSurface;
+	}
+	
+	//\_______________ load the icons now rather than on idle, they take their image from the jobs.
+	for (ic = pIcons; ic != NULL; ic = ic->next)
+	{
+		icon = ic->data;
+		if (icon->iSidLoadImage == 0 || icon->pContainer == NULL)  // not waiting to be loaded.
+			continue;
+		cairo_dock_load_icon_buffers (icon, icon->pContainer);
+		if (CAIRO_DOCK_IS_DOCK (icon->pContainer) && CAIRO_DOCK (icon->pContainer)->iRefCount != 0)  // the icon pointing on the sub-dock may display this icon.
+			cairo_dock_trigger_redraw_subdock_content (CAIRO_DOCK (icon->pContainer));
+	}
+	g_hash_table_destroy (s_hPreloadedImages);
+	s_hPreloadedImages = NULL;
+	g_ptr_array_free (pJobs, TRUE);
+}
 static void init_object (GldiObject *obj, G_GNUC_UNUSED gpointer attr)
 {
 	Icon *icon = (Icon*)obj;
@@ -987,6 +1110,7 @@ static void reset_object (GldiObject *obj)
 	
 	if (icon->iSidRedrawSubdockContent != 0)
 		g_source_remove (icon->iSidRedrawSubdockContent);
+	cairo_dock_invalidate_subdock_content (icon);
 	if (icon->iSidLoadImage != 0)  // remove timers after any function that could trigger one (for instance, cairo_dock_deinhibite_class calls cairo_dock_trigger_load_icon_buffers)
 		g_source_remove (icon->iSidLoadImage);
 	if (icon->iSidDoubleClickDelay != 0)
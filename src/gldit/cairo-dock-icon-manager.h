@@ -114,6 +114,12 @@ typedef enum {
 */
 void gldi_icons_foreach (GldiIconFunc pFunction, gpointer pUserData);
 
+/** Load the images of some icons that wait to be loaded, now rather than on idle. The image files are read and scaled by worker threads.
+*@param pIcons a list of icons, already inserted in their container.
+*@param iNbThreads maximum number of threads to use (1 to load the images in the main thread).
+*/
+void gldi_icons_load_images (GList *pIcons, int iNbThreads);
+
 
 void cairo_dock_hide_show_launchers_on_other_desktops (void);
 
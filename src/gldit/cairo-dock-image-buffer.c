@@ -38,6 +38,9 @@ extern CairoDockGLConfig g_openglConfig;
 extern GldiContainer *g_pPrimaryContainer;
 extern gboolean g_bEasterEggs;
 
+static cairo_user_data_key_t s_SharedSurfaceKey;  // marks the surfaces that have been shared by several image buffers
+static GHashTable *s_pSharedTextures = NULL;  // texture -> number of image buffers holding it, for the textures that are shared
+
 
 gchar *cairo_dock_search_image_s_path (const gchar *cImageFile)
 {
@@ -189,6 +192,65 @@ CairoDockImageBuffer *cairo_dock_create_image_buffer (const gchar *cImageFile, i
 	return pImage;
 }
 
+static void _reference_texture (GLuint iTexture)
+{
+	if (s_pSharedTextures == NULL)
+		s_pSharedTextures = g_hash_table_new (g_direct_hash, g_direct_equal);
+	gint iNbRefs = GPOINTER_TO_INT (g_hash_table_lookup (s_pSharedTextures, GUINT_TO_POINTER (iTexture)));
+	g_hash_table_insert (s_pSharedTextures, GUINT_TO_POINTER (iTexture), GINT_TO_POINTER (MAX (iNbRefs, 1) + 1));  // not in the table <=> held once.
+}
+
+static inline gboolean _texture_is_shared (GLuint iTexture)
+{
+	return (s_pSharedTextures != NULL && g_hash_table_lookup (s_pSharedTextures, GUINT_TO_POINTER (iTexture)) != NULL);
+}
+
+static inline gboolean _surface_is_shared (cairo_surface_t *pSurface)
+{
+	return (cairo_surface_get_user_data (pSurface, &s_SharedSurfaceKey) != NULL && cairo_surface_get_reference_count (pSurface) > 1);
+}
+
+void cairo_dock_release_texture (GLuint iTexture)
+{
+	if (iTexture == 0)
+		return;
+	gint iNbRefs = (s_pSharedTextures != NULL ? GPOINTER_TO_INT (g_hash_table_lookup (s_pSharedTextures, GUINT_TO_POINTER (iTexture))) : 0);
+	if (iNbRefs > 2)
+		g_hash_table_insert (s_pSharedTextures, GUINT_TO_POINTER (iTexture), GINT_TO_POINTER (iNbRefs - 1));
+	else if (iNbRefs == 2)  // the last holder owns it alone now.
+		g_hash_table_remove (s_pSharedTextures, GUINT_TO_POINTER (iTexture));
+	else
+		_cairo_dock_delete_texture (iTexture);
+}
+
+void cairo_dock_share_image_buffer (CairoDockImageBuffer *pImage, const CairoDockImageBuffer *pSharedImage)
+{
+	memcpy (pImage, pSharedImage, sizeof (CairoDockImageBuffer));
+	if (pImage->pSurface != NULL)
+	{
+		cairo_surface_reference (pImage->pSurface);
+		cairo_surface_set_user_data (pImage->pSurface, &s_SharedSurfaceKey, GINT_TO_POINTER (1), NULL);
+	}
+	if (pImage->iTexture != 0)
+		_reference_texture (pImage->iTexture);
+}
+
+void cairo_dock_unshare_image_buffer (CairoDockImageBuffer *pImage)
+{
+	if (pImage->pSurface != NULL && _surface_is_shared (pImage->pSurface))
+	{
+		int w = pImage->iWidth, h = pImage->iHeight;  // not the size of the surface, which is not an image surface in cairo mode.
+		cairo_surface_t *pSurface = cairo_dock_duplicate_surface (pImage->pSurface, w, h, w, h);
+		cairo_surface_destroy (pImage->pSurface);
+		pImage->pSurface = pSurface;
+	}
+	if (pImage->iTexture != 0 && pImage->pSurface != NULL && _texture_is_shared (pImage->iTexture))  // a shared texture is never drawn, so it's still the same as the surface.
+	{
+		cairo_dock_release_texture (pImage->iTexture);
+		pImage->iTexture = cairo_dock_create_texture_from_surface (pImage->pSurface);
+	}
+}
+
 void cairo_dock_unload_image_buffer (CairoDockImageBuffer *pImage)
 {
 	if (pImage->pSurface != NULL)
@@ -197,7 +259,7 @@ void cairo_dock_unload_image_buffer (CairoDockImageBuffer *pImage)
 	}
 	if (pImage->iTexture != 0)
 	{
-		_cairo_dock_delete_texture (pImage->iTexture);
+		cairo_dock_release_texture (pImage->iTexture);
 	}
 	memset (pImage, 0, sizeof (CairoDockImageBuffer));
 }
@@ -483,6 +545,7 @@ cairo_t *cairo_dock_begin_draw_image_buffer_cairo (CairoDockImageBuffer *pImage,
 	cairo_t *ctx = pCairoContext;
 	if (! ctx)
 	{
+		cairo_dock_unshare_image_buffer (pImage);
 		ctx = cairo_create (pImage->pSurface);
 	}
 	if (iRenderingMode != 1)
@@ -501,6 +564,7 @@ void cairo_dock_end_draw_image_buffer_cairo (CairoDockImageBuffer *pImage)
 
 gboolean cairo_dock_begin_draw_image_buffer_opengl (CairoDockImageBuffer *pImage, GldiContainer *pContainer, gint iRenderingMode)
 {
+	cairo_dock_unshare_image_buffer (pImage);
 	int iWidth, iHeight;
 	/// TODO: test without FBO and dock when iRenderingMode == 2
 	if (CAIRO_DOCK_IS_DESKLET (pContainer))
@@ -109,6 +109,22 @@ gboolean cairo_dock_image_buffer_next_frame_no_loop (CairoDockImageBuffer *pImag
 
 #define cairo_dock_image_buffer_rewind(pImage) gettimeofday (&pImage->time, NULL)
 
+/** Make an ImageBuffer use the same surface and texture as another one, instead of a copy of them. The buffers are reference-counted, and an ImageBuffer gets its own copy of them as soon as it is drawn (see \ref cairo_dock_unshare_image_buffer).
+*@param pImage an ImageBuffer, empty.
+*@param pSharedImage the ImageBuffer to share.
+*/
+void cairo_dock_share_image_buffer (CairoDockImageBuffer *pImage, const CairoDockImageBuffer *pSharedImage);
+
+/** Give its own copy of the surface and the texture to an ImageBuffer that shares them, so that it can be drawn without altering the other ones. The begin_draw functions do it already; call it before drawing directly on its surface.
+*@param pImage an ImageBuffer.
+*/
+void cairo_dock_unshare_image_buffer (CairoDockImageBuffer *pImage);
+
+/** Release a texture of an ImageBuffer; it's only deleted if no other ImageBuffer shares it.
+*@param iTexture a texture.
+*/
+void cairo_dock_release_texture (GLuint iTexture);
+
 /** Reset an ImageBuffer's ressources. It can be used to load another image then.
 *@param pImage an ImageBuffer.
 */
@@ -235,6 +235,7 @@ static GKeyFile* reload_object (GldiObject *obj, gboolean bReloadConf, GKeyFile
 	
 	//\__________________ get parameters
 	_get_launcher_params (icon, pKeyFile);
+	cairo_dock_reindex_icon (icon);  // its name may have changed.
 	
 	//\_____________ reload icon's buffers
 	GldiContainer *pNewContainer = cairo_dock_get_icon_container (icon);
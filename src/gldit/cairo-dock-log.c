@@ -25,6 +25,7 @@
 */
 
 #include <stdio.h>
+#include <stdlib.h>  // atexit
 #include <string.h>
 #include <stdarg.h>
 #include <unistd.h>
@@ -97,6 +98,302 @@ const char *_cd_log_level_to_string (const GLogLevelFlags loglevel)
   return "";
 }
 
+#define CD_LOG_RING_SIZE 1024  // must be a power of 2
+#define CD_LOG_RATE_LIMIT 20  // max number of messages per second and per call site
+#define CD_LOG_SEVERE_LEVELS (G_LOG_LEVEL_ERROR | G_LOG_LEVEL_CRITICAL | G_LOG_LEVEL_WARNING)  // written synchronously through g_log, never rate-limited nor dropped; only debug/info/message go through the ring.
+#define CD_LOG_MESSAGE_FLUSH_TIMEOUT 500000  // us
+
+typedef struct {
+	gint iSequence;  // position of the slot in the queue; tells whether the slot is free or filled.
+	GLogLevelFlags iLevel;
+	const char *cFile;
+	const char *cFunc;
+	int iLine;
+	gint64 iTime;
+	guint iThreadID;
+	gchar *cMessage;
+	} CDLogEntry;
+
+// ring buffer: multiple producers (any thread can log), one consumer (the writer thread).
+static CDLogEntry s_pLogRing[CD_LOG_RING_SIZE];
+static gint s_iEnqueuePos = 0;
+static gint s_iDequeuePos = 0;  // only used by the writer thread, and by the flush when the writer is not running.
+static gint s_iNbDroppedMessages = 0;
+static gboolean s_bAsyncLog = FALSE;
+static gboolean s_bJsonOutput = FALSE;
+// writer thread
+static GThread *s_pWriterThread = NULL;
+static GMutex s_WriterMutex;
+static GCond s_WriterCond;
+static gint s_bWriterSleeping = FALSE;
+static gint s_iNbThreads = 0;
+static GPrivate s_ThreadID;
+static GPrivate s_bMessageWritten;  // set while a message that was already written goes through g_log.
+
+
+static guint _get_thread_id (void)
+{
+	guint iThreadID = GPOINTER_TO_UINT (g_private_get (&s_ThreadID));
+	if (iThreadID == 0)
+	{
+		iThreadID = g_atomic_int_add (&s_iNbThreads, 1) + 1;  // the first thread to log (the main thread) has the ID 1.
+		g_private_set (&s_ThreadID, GUINT_TO_POINTER (iThreadID));
+	}
+	return iThreadID;
+}
+
+static gboolean _callsite_is_rate_limited (CDLogCallsite *pCallsite, gint *iNbSuppressed)
+{
+	*iNbSuppressed = 0;
+	if (pCallsite == NULL)
+		return FALSE;
+	gint iCurrentSecond = (gint)(g_get_monotonic_time () / G_USEC_PER_SEC);
+	gint iWindow = g_atomic_int_get (&pCallsite->iWindow);
+	if (iWindow != iCurrentSecond && g_atomic_int_compare_and_exchange (&pCallsite->iWindow, iWindow, iCurrentSecond))  // new window
+	{
+		g_atomic_int_set (&pCallsite->iCount, 0);
+		do
+			*iNbSuppressed = g_atomic_int_get (&pCallsite->iNbSuppressed);
+		while (! g_atomic_int_compare_and_exchange (&pCallsite->iNbSuppressed, *iNbSuppressed, 0));
+	}
+	if (g_atomic_int_add (&pCallsite->iCount, 1) >= CD_LOG_RATE_LIMIT)
+	{
+		g_atomic_int_inc (&pCallsite->iNbSuppressed);
+		return TRUE;
+	}
+	return FALSE;
+}
+
+static const gchar *_cd_log_level_to_name (GLogLevelFlags loglevel)
+{
+	switch (loglevel)
+	{
+		case G_LOG_LEVEL_CRITICAL: return "critical";
+		case G_LOG_LEVEL_ERROR: return "error";
+		case G_LOG_LEVEL_WARNING: return "warning";
+		case G_LOG_LEVEL_MESSAGE: return "message";
+		case G_LOG_LEVEL_INFO: return "info";
+		case G_LOG_LEVEL_DEBUG: return "debug";
+		default: return "fatal";
+	}
+}
+
+static void _append_json_string (GString *sLine, const gchar *cKey, const gchar *cValue)
+{
+	g_string_append_printf (sLine, ",\"%s\":\"", cKey);
+	const gchar *c;
+	for (c = cValue; c != NULL && *c != '\0'; c ++)
+	{
+		switch (*c)
+		{
+			case '"': g_string_append (sLine, "\\\""); break;
+			case '\\': g_string_append (sLine, "\\\\"); break;
+			case '\n': g_string_append (sLine, "\\n"); break;
+			case '\t': g_string_append (sLine, "\\t"); break;
+			default:
+				if ((guchar)*c < 0x20)
+					g_string_append_printf (sLine, "\\u%04x", (guchar)*c);
+				else
+					g_string_append_c (sLine, *c);
+		}
+	}
+	g_string_append_c (sLine, '"');
+}
+
+static void _write_entry (CDLogEntry *pEntry)
+{
+	if (s_bJsonOutput)
+	{
+		GString *sLine = g_string_new ("");
+		g_string_append_printf (sLine, "{\"ts\":%" G_GINT64_FORMAT ".%06d,\"tid\":%u", pEntry->iTime / G_USEC_PER_SEC, (int)(pEntry->iTime % G_USEC_PER_SEC), pEntry->iThreadID);
+		_append_json_string (sLine, "level", _cd_log_level_to_name (pEntry->iLevel));
+		if (pEntry->cFile != NULL)
+		{
+			_append_json_string (sLine, "file", pEntry->cFile);
+			_append_json_string (sLine, "func", pEntry->cFunc);
+			g_string_append_printf (sLine, ",\"line\":%d", pEntry->iLine);
+		}
+		_append_json_string (sLine, "msg", pEntry->cMessage);
+		g_print ("%s}\n", sLine->str);
+		g_string_free (sLine, TRUE);
+	}
+	else if (pEntry->cFile == NULL)  // message that didn't go through our macros (Glib, Gtk, etc)
+	{
+		g_print ("%s\n", pEntry->cMessage);
+	}
+	else  // print everything in one go, so that messages from different threads are not mixed.
+	{
+		if (s_bUseColors)
+			g_print ("%s\033[0;37m(%s:%s:%d) \033[%cm \n  %s\n", _cd_log_level_to_string (pEntry->iLevel), pEntry->cFile, pEntry->cFunc, pEntry->iLine, s_iLogColor, pEntry->cMessage);
+		else
+			g_print ("%s(%s:%s:%d)\n  %s\n", _cd_log_level_to_string (pEntry->iLevel), pEntry->cFile, pEntry->cFunc, pEntry->iLine, pEntry->cMessage);
+	}
+}
+
+static gboolean _dequeue_entry (CDLogEntry *pEntry)
+{
+	CDLogEntry *pSlot = &s_pLogRing[s_iDequeuePos & (CD_LOG_RING_SIZE - 1)];
+	gint iSequence = g_atomic_int_get (&pSlot->iSequence);
+	if ((gint)((guint)iSequence - (guint)(s_iDequeuePos + 1)) < 0)  // slot not filled yet => queue is empty
+		return FALSE;
+	*pEntry = *pSlot;
+	pSlot->cMessage = NULL;
+	g_atomic_int_set (&pSlot->iSequence, s_iDequeuePos + CD_LOG_RING_SIZE);  // release the slot for the next round.
+	g_atomic_int_inc (&s_iDequeuePos);
+	return TRUE;
+}
+
+static void _drain_queue (void)
+{
+	CDLogEntry entry;
+	while (_dequeue_entry (&entry))
+	{
+		_write_entry (&entry);
+		g_free (entry.cMessage);
+	}
+	gint iNbDropped = g_atomic_int_get (&s_iNbDroppedMessages);
+	if (iNbDropped != 0 && g_atomic_int_compare_and_exchange (&s_iNbDroppedMessages, iNbDropped, 0))
+		g_print ("%s%d log messages were dropped (log buffer full)\n", _cd_log_level_to_string (G_LOG_LEVEL_WARNING), iNbDropped);
+}
+
+static inline gboolean _queue_is_empty (void)
+{
+	return (g_atomic_int_get (&s_iEnqueuePos) == g_atomic_int_get (&s_iDequeuePos));
+}
+
+static gpointer _writer_thread (G_GNUC_UNUSED gpointer data)
+{
+	while (TRUE)
+	{
+		_drain_queue ();
+		
+		g_mutex_lock (&s_WriterMutex);
+		g_atomic_int_set (&s_bWriterSleeping, TRUE);
+		g_cond_broadcast (&s_WriterCond);  // wake up anybody waiting for the queue to be flushed.
+		if (_queue_is_empty ())  // check again now that producers know we're going to sleep, so that we don't miss a message.
+			g_cond_wait (&s_WriterCond, &s_WriterMutex);
+		g_atomic_int_set (&s_bWriterSleeping, FALSE);
+		g_mutex_unlock (&s_WriterMutex);
+	}
+	return NULL;
+}
+
+static void _wake_up_writer (void)
+{
+	if (g_atomic_int_get (&s_bWriterSleeping))
+	{
+		g_mutex_lock (&s_WriterMutex);
+		g_cond_broadcast (&s_WriterCond);
+		g_mutex_unlock (&s_WriterMutex);
+	}
+}
+
+static gboolean _enqueue_entry (GLogLevelFlags loglevel, const char *file, const char *func, int line, gchar *cMessage)
+{
+	CDLogEntry *pSlot;
+	gint iPos = g_atomic_int_get (&s_iEnqueuePos);
+	while (TRUE)
+	{
+		pSlot = &s_pLogRing[iPos & (CD_LOG_RING_SIZE - 1)];
+		gint iDiff = (gint)((guint)g_atomic_int_get (&pSlot->iSequence) - (guint)iPos);
+		if (iDiff == 0)  // the slot is free, try to reserve it.
+		{
+			if (g_atomic_int_compare_and_exchange (&s_iEnqueuePos, iPos, iPos + 1))
+				break;
+		}
+		else if (iDiff < 0)  // the queue is full
+		{
+			return FALSE;
+		}
+		iPos = g_atomic_int_get (&s_iEnqueuePos);  // another thread took the slot, try the next one.
+	}
+	pSlot->iLevel = loglevel;
+	pSlot->cFile = file;
+	pSlot->cFunc = func;
+	pSlot->iLine = line;
+	pSlot->iTime = g_get_real_time ();
+	pSlot->iThreadID = _get_thread_id ();
+	pSlot->cMessage = cMessage;
+	g_atomic_int_set (&pSlot->iSequence, iPos + 1);  // publish the slot.
+	return TRUE;
+}
+
+static void _cd_log_message (GLogLevelFlags loglevel, const char *file, const char *func, int line, gchar *cMessage)
+{
+	if (s_bAsyncLog && _enqueue_entry (loglevel, file, func, line, cMessage))
+	{
+		_wake_up_writer ();
+	}
+	else if (s_bAsyncLog)  // the writer can't keep up; don't block the caller, just count the lost messages.
+	{
+		g_atomic_int_inc (&s_iNbDroppedMessages);
+		g_free (cMessage);
+	}
+	else
+	{
+		CDLogEntry entry = {0, loglevel, file, func, line, g_get_real_time (), _get_thread_id (), cMessage};
+		_write_entry (&entry);
+		g_free (cMessage);
+	}
+}
+
+void cd_log_flush (void)
+{
+	if (! s_bAsyncLog)
+		return;
+	gint64 iEndTime = g_get_monotonic_time () + CD_LOG_MESSAGE_FLUSH_TIMEOUT;
+	g_mutex_lock (&s_WriterMutex);
+	while (! _queue_is_empty () || ! g_atomic_int_get (&s_bWriterSleeping))
+	{
+		g_cond_broadcast (&s_WriterCond);
+		if (! g_cond_wait_until (&s_WriterCond, &s_WriterMutex, iEndTime))
+			break;
+	}
+	g_mutex_unlock (&s_WriterMutex);
+}
+
+void cd_log_location_full (CDLogCallsite *pCallsite,
+	const GLogLevelFlags loglevel,
+	const char *file,
+	const char *func,
+	const int line,
+	const char *format,
+	...)
+{
+	va_list args;
+
+	if (loglevel > s_gLogLevel)
+		return;
+	
+	gboolean bSevere = ((loglevel & CD_LOG_SEVERE_LEVELS) != 0);
+	gint iNbSuppressed = 0;
+	if (! bSevere && _callsite_is_rate_limited (pCallsite, &iNbSuppressed))  // warnings and errors are never suppressed.
+		return;
+	
+	va_start (args, format);
+	gchar *cMessage = g_strdup_vprintf (format, args);
+	va_end (args);
+	if (iNbSuppressed != 0)
+	{
+		gchar *tmp = cMessage;
+		cMessage = g_strdup_printf ("%s (%d similar messages were suppressed)", tmp, iNbSuppressed);
+		g_free (tmp);
+	}
+	
+	if (bSevere)  // write it now, after the pending messages, and let Glib decide whether it's fatal (G_DEBUG=fatal-warnings, etc).
+	{
+		cd_log_flush ();
+		CDLogEntry entry = {0, loglevel, file, func, line, g_get_real_time (), _get_thread_id (), cMessage};
+		_write_entry (&entry);
+		g_private_set (&s_bMessageWritten, GINT_TO_POINTER (1));
+		g_log (G_LOG_DOMAIN, loglevel, "%s", cMessage);  // error messages are always fatal
+		g_private_set (&s_bMessageWritten, NULL);
+		g_free (cMessage);
+		return;
+	}
+	_cd_log_message (loglevel, file, func, line, cMessage);
+}
+
 void cd_log_location(const GLogLevelFlags loglevel,
                      const char *file,
                      const char *func,
@@ -108,14 +405,11 @@ void cd_log_location(const GLogLevelFlags loglevel,
 
   if (loglevel > s_gLogLevel)
     return;
-  g_print("%s", _cd_log_level_to_string (loglevel));
-  if (s_bUseColors)
-    g_print("\033[0;37m(%s:%s:%d) \033[%cm \n  ", file, func, line, s_iLogColor);
-  else
-    g_print("(%s:%s:%d)\n  ", file, func, line);
   va_start(args, format);
-  g_logv(G_LOG_DOMAIN, loglevel, format, args);
+  gchar *cMessage = g_strdup_vprintf (format, args);
   va_end(args);
+  cd_log_location_full (NULL, loglevel, file, func, line, "%s", cMessage);
+  g_free (cMessage);
 }
 
 static void cairo_dock_log_handler(G_GNUC_UNUSED const gchar *log_domain,
@@ -123,9 +417,18 @@ static void cairo_dock_log_handler(G_GNUC_UNUSED const gchar *log_domain,
                                    const gchar *message,
                                    G_GNUC_UNUSED gpointer user_data)
 {
-  if (log_level > s_gLogLevel)
+  if ((log_level & G_LOG_LEVEL_MASK) > s_gLogLevel)
+    return;
+  if (g_private_get (&s_bMessageWritten))  // already written by cd_log_location_full.
     return;
-  g_print("%s\n", message);
+  if (log_level & (G_LOG_FLAG_FATAL | CD_LOG_SEVERE_LEVELS))  // we may abort, and it must not be lost: write it now.
+  {
+    cd_log_flush ();
+    CDLogEntry entry = {0, log_level & G_LOG_LEVEL_MASK, NULL, NULL, 0, g_get_real_time (), _get_thread_id (), (gchar*)message};
+    _write_entry (&entry);
+    return;
+  }
+  _cd_log_message (log_level & G_LOG_LEVEL_MASK, NULL, NULL, 0, g_strdup (message));
 }
 
 
@@ -134,6 +437,20 @@ void cd_log_init (gboolean bBlackTerminal)
 	g_log_set_default_handler(cairo_dock_log_handler, NULL);
 	s_iLogColor = (bBlackTerminal ? '1' : '0');
 	s_bUseColors = isatty (1);  // use colors iif our output is associated with a terminal (otherwise it's probably redirected into log file, color characters will be annoying).
+	
+	// start the writer thread, so that logging never blocks the main loop on the output.
+	if (s_pWriterThread == NULL)
+	{
+		int i;
+		for (i = 0; i < CD_LOG_RING_SIZE; i ++)
+			s_pLogRing[i].iSequence = i;
+		s_pWriterThread = g_thread_try_new ("cd-log", _writer_thread, NULL, NULL);
+		if (s_pWriterThread != NULL)
+		{
+			s_bAsyncLog = TRUE;
+			atexit (cd_log_flush);  // don't lose the last messages.
+		}
+	}
 }
 
 void cd_log_set_level (GLogLevelFlags loglevel)
@@ -165,3 +482,8 @@ void cd_log_force_use_color (void)
 {
 	bForceColors = TRUE;
 }
+
+void cd_log_set_json_output (gboolean bJsonOutput)
+{
+	s_bJsonOutput = bJsonOutput;
+}
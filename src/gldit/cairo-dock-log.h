@@ -31,8 +31,25 @@
 G_BEGIN_DECLS
 
 /*
- * internal function
+ * internal state of a call site, used to rate-limit its debug/info/messages.
  */
+typedef struct {
+	gint iWindow;
+	gint iCount;
+	gint iNbSuppressed;
+} CDLogCallsite;
+
+/*
+ * internal functions
+ */
+void cd_log_location_full (CDLogCallsite *pCallsite,
+                     const GLogLevelFlags loglevel,
+                     const char *file,
+                     const char *func,
+                     const int line,
+                     const char *format,
+                     ...);
+
 void cd_log_location(const GLogLevelFlags loglevel,
                      const char *file,
                      const char *func,
@@ -40,8 +57,13 @@ void cd_log_location(const GLogLevelFlags loglevel,
                      const char *format,
                      ...);
 
+#define _cd_log_at_callsite(loglevel, ...) do {                        \
+  static CDLogCallsite _cd_log_callsite;                               \
+  cd_log_location_full (&_cd_log_callsite, loglevel, __FILE__, __PRETTY_FUNCTION__, __LINE__,__VA_ARGS__); \
+  } while (0)
+
 /**
- * Initialize the log system.
+ * Initialize the log system. Debug, info and messages are then written by a separate thread, so that logging never blocks the caller; warnings, criticals and errors are still written at once, through g_log.
  */
 void cd_log_init(gboolean bBlackTerminal);
 
@@ -60,36 +82,47 @@ void cd_log_set_level_from_name (const gchar *cVerbosity);
  */
 void cd_log_force_use_color (void);
 
+/**
+ * Write the log messages as JSON objects, one per line, with a timestamp and the ID of the thread that emitted it.
+ */
+void cd_log_set_json_output (gboolean bJsonOutput);
+
+/**
+ * Wait until all the pending log messages have been written.
+ */
+void cd_log_flush (void);
+
 
 /* Write an error message on the terminal. Error messages are used to indicate the cause of the program stop.
 *@param ... the message format and parameters, in a 'printf' style.
 */
 #define cd_error(...)                                                  \
-  cd_log_location(G_LOG_LEVEL_ERROR, __FILE__, __PRETTY_FUNCTION__, __LINE__,__VA_ARGS__)
+  _cd_log_at_callsite(G_LOG_LEVEL_ERROR, __VA_ARGS__)
 
 /* Write a critical message on the terminal. Critical messages should be as clear as possible to be useful for end-users.
 *@param ... the message format and parameters, in a 'printf' style.
 */
 #define cd_critical(...)                                               \
-  cd_log_location(G_LOG_LEVEL_CRITICAL, __FILE__, __PRETTY_FUNCTION__, __LINE__,__VA_ARGS__)
+  _cd_log_at_callsite(G_LOG_LEVEL_CRITICAL, __VA_ARGS__)
 
 /* Write a warning message on the terminal. Warnings should be as clear as possible to be useful for end-users.
 *@param ... the message format and parameters, in a 'printf' style.
 */
 #define cd_warning(...)                                                \
-  cd_log_location(G_LOG_LEVEL_WARNING, __FILE__, __PRETTY_FUNCTION__, __LINE__,__VA_ARGS__)
+  _cd_log_at_callsite(G_LOG_LEVEL_WARNING, __VA_ARGS__)
 
 /* Write a message on the terminal. Messages are used to trace the sequence of functions, and may be used by users for a quick debug.
 *@param ... the message format and parameters, in a 'printf' style.
 */
 #define cd_message(...)                                                \
-  cd_log_location(G_LOG_LEVEL_MESSAGE, __FILE__, __PRETTY_FUNCTION__, __LINE__,__VA_ARGS__)
+  _cd_log_at_callsite(G_LOG_LEVEL_MESSAGE, __VA_ARGS__)
 
 /* Write a debug message on the terminal. Debug message are only useful for developpers.
+* Like all the messages below the error level, they are limited to a few per second for a given call site.
 *@param ... the message format and parameters, in a 'printf' style.
 */
 #define cd_debug(...)                                                  \
-  cd_log_location(G_LOG_LEVEL_DEBUG, __FILE__, __PRETTY_FUNCTION__, __LINE__,__VA_ARGS__)
+  _cd_log_at_callsite(G_LOG_LEVEL_DEBUG, __VA_ARGS__)
 
 G_END_DECLS
 #endif 	    /* !CAIRO_DOCK_LOG_H_ */
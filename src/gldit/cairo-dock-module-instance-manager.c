@@ -598,6 +598,7 @@ static GKeyFile* reload_object (GldiObject *obj, gboolean bReadConfig, GKeyFile
 				g_free (pIcon->cName);
 				pIcon->cName = pMinimalConfig->cLabel;
 				pMinimalConfig->cLabel = NULL;  // we won't need it any more, so skip a duplication.
+				cairo_dock_reindex_icon (pIcon);
 				g_free (pIcon->cFileName);
 				pIcon->cFileName = pMinimalConfig->cIconFileName;
 				pMinimalConfig->cIconFileName = NULL;  // idem
@@ -719,6 +720,7 @@ static GKeyFile* reload_object (GldiObject *obj, gboolean bReadConfig, GKeyFile
 	{
 		gldi_object_unref (GLDI_OBJECT(pIcon->pSubDock));
 		pIcon->pSubDock = NULL;
+		cairo_dock_reindex_icon (pIcon);
 	}  // no need to destroy the dock where the applet was, it will be done automatically
 
 	if (! bReadConfig && cairo_dock_get_icon_data_renderer (pIcon) != NULL)  // reload the data-renderer at the new size
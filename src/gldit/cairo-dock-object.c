@@ -28,6 +28,10 @@
  * GLDI_OBJECT_IS_xxx obj->mgr == pMgr || mgr->parent->mrg == pMgr || ...
  * */
 
+// public (data)
+gulong g_iNbNotifications = 0;
+gulong g_iNbNotificationCallbacks = 0;
+
 
 void gldi_object_set_manager (GldiObject *pObject, GldiObjectManager *pMgr)
 {
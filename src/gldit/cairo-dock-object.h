@@ -157,6 +157,10 @@ Note: it is safe to remove the callback when it is called, but not another one.
 void gldi_object_remove_notification (gpointer pObject, GldiNotificationType iNotifType, GldiNotificationFunc pFunction, gpointer pUserData);
 
 
+/// Number of notifications broadcast so far, and number of callbacks they have called; they can be compared before and after some actions, to see how many callbacks these actions trigger.
+extern gulong g_iNbNotifications;
+extern gulong g_iNbNotificationCallbacks;
+
 #define __notify(pNotificationRecordList, bStop, ...) do {\
 	GldiNotificationRecord *pNotificationRecord;\
 	GSList *pElement = pNotificationRecordList, *pNextElement;\
@@ -164,6 +168,7 @@ void gldi_object_remove_notification (gpointer pObject, GldiNotificationType iNo
 		pNotificationRecord = pElement->data;\
 		pNextElement = pElement->next;\
 		bStop = pNotificationRecord->pFunction (pNotificationRecord->pUserData, ##__VA_ARGS__);\
+		g_iNbNotificationCallbacks ++;\
 		pElement = pNextElement; }\
 	} while (0)
 
@@ -185,6 +190,7 @@ void gldi_object_remove_notification (gpointer pObject, GldiNotificationType iNo
 #define gldi_object_notify(pObject, iNotifType, ...) \
 	__extension__ ({\
 	gboolean _bStop = FALSE;\
+	g_iNbNotifications ++;\
 	GldiObject *_obj = GLDI_OBJECT (pObject);\
 	while (_obj && !_bStop) {\
 		_bStop = __notify_on_object (_obj, iNotifType, ##__VA_ARGS__);\
@@ -18,7 +18,9 @@
 */
 
 #include <math.h>
+#include <string.h>
 #include <pango/pango.h>
+#include <pango/pangocairo.h>
 #include <cairo.h>
 #include <GL/gl.h>
 
@@ -36,6 +38,25 @@ extern GldiContainer *g_pPrimaryContainer;
 
 extern CairoDockGLConfig g_openglConfig;
 
+#define CD_GLYPH_ATLAS_SIZE 512
+
+typedef struct {
+	GLfloat u, v, du, dv;  // area in the atlas
+	gint iWidth;  // advance
+	} CDGlyph;
+
+struct _CairoDockGLFontAtlas {
+	PangoLayout *pLayout;
+	GHashTable *pGlyphs;  // gunichar -> CDGlyph
+	GLuint iTexture;
+	gint iLineHeight;
+	gint iCursorX, iCursorY, iRowHeight;  // position of the next glyph in the atlas
+	GArray *pVertices;  // pending quads: 2 floats per vertex
+	GArray *pCoords;  // 2 floats per vertex
+	GArray *pColors;  // 4 floats per vertex, only when batching
+	gboolean bBatching;
+	};
+
 
 GLuint cairo_dock_create_texture_from_text_simple (const gchar *cText, const gchar *cFontDescription, cairo_t* pSourceContext, int *iWidth, int *iHeight)
 {
@@ -254,6 +275,340 @@ CairoDockGLFont *cairo_dock_load_textured_font_from_image (const gchar *cImagePa
 	return pFont;
 }
 
+  ///////////////////
+ /// GLYPH ATLAS ///
+///////////////////
+
+static void _reset_glyph_atlas (CairoDockGLFontAtlas *pAtlas)
+{
+	g_hash_table_remove_all (pAtlas->pGlyphs);
+	pAtlas->iCursorX = 1;  // keep 1 transparent pixel around each glyph, so that the linear filtering doesn't bleed on the neighbours.
+	pAtlas->iCursorY = 1;
+	pAtlas->iRowHeight = 0;
+}
+
+CairoDockGLFont *cairo_dock_load_glyph_font (const gchar *cFontDescription)
+{
+	g_return_val_if_fail (cFontDescription != NULL, NULL);
+	CairoDockGLFontAtlas *pAtlas = g_new0 (CairoDockGLFontAtlas, 1);
+	guchar *pBlankData = g_new0 (guchar, CD_GLYPH_ATLAS_SIZE * CD_GLYPH_ATLAS_SIZE * 4);
+	pAtlas->iTexture = cairo_dock_create_texture_from_raw_data (pBlankData, CD_GLYPH_ATLAS_SIZE, CD_GLYPH_ATLAS_SIZE);
+	g_free (pBlankData);
+	if (pAtlas->iTexture == 0)
+	{
+		g_free (pAtlas);
+		return NULL;
+	}
+	
+	PangoContext *pContext = pango_font_map_create_context (pango_cairo_font_map_get_default ());
+	pAtlas->pLayout = pango_layout_new (pContext);
+	g_object_unref (pContext);
+	PangoFontDescription *fd = pango_font_description_from_string (cFontDescription);
+	pango_layout_set_font_description (pAtlas->pLayout, fd);
+	pango_font_description_free (fd);
+	
+	PangoRectangle log;
+	pango_layout_set_text (pAtlas->pLayout, "Ag", -1);
+	pango_layout_get_pixel_extents (pAtlas->pLayout, NULL, &log);
+	pAtlas->iLineHeight = MAX (1, log.height);
+	
+	pAtlas->pGlyphs = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, g_free);
+	pAtlas->pVertices = g_array_new (FALSE, FALSE, sizeof (GLfloat));
+	pAtlas->pCoords = g_array_new (FALSE, FALSE, sizeof (GLfloat));
+	pAtlas->pColors = g_array_new (FALSE, FALSE, sizeof (GLfloat));
+	_reset_glyph_atlas (pAtlas);
+	
+	CairoDockGLFont *pFont = g_new0 (CairoDockGLFont, 1);
+	pFont->pAtlas = pAtlas;
+	pFont->iCharWidth = log.width / 2.;
+	pFont->iCharHeight = pAtlas->iLineHeight;
+	return pFont;
+}
+
+static void _free_glyph_atlas (CairoDockGLFontAtlas *pAtlas)
+{
+	_cairo_dock_delete_texture (pAtlas->iTexture);
+	g_object_unref (pAtlas->pLayout);
+	g_hash_table_destroy (pAtlas->pGlyphs);
+	g_array_free (pAtlas->pVertices, TRUE);
+	g_array_free (pAtlas->pCoords, TRUE);
+	g_array_free (pAtlas->pColors, TRUE);
+	g_free (pAtlas);
+}
+
+// rasterize a glyph with Pango (which takes care of the font fallback) and copy it into the atlas. Returns NULL if the atlas is full.
+static CDGlyph *_load_glyph (CairoDockGLFontAtlas *pAtlas, gunichar c)
+{
+	gchar buf[8];
+	int n = g_unichar_to_utf8 (c, buf);
+	pango_layout_set_text (pAtlas->pLayout, buf, n);
+	PangoRectangle log;
+	pango_layout_get_pixel_extents (pAtlas->pLayout, NULL, &log);
+	int w = MAX (1, log.width), h = pAtlas->iLineHeight;
+	
+	if (pAtlas->iCursorX + w + 1 > CD_GLYPH_ATLAS_SIZE)  // next row
+	{
+		pAtlas->iCursorX = 1;
+		pAtlas->iCursorY += pAtlas->iRowHeight + 1;
+		pAtlas->iRowHeight = 0;
+	}
+	if (pAtlas->iCursorY + h + 1 > CD_GLYPH_ATLAS_SIZE || w + 2 > CD_GLYPH_ATLAS_SIZE)
+		return NULL;
+	
+	cairo_surface_t *pSurface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, w, h);
+	cairo_t *pCairoContext = cairo_create (pSurface);
+	cairo_translate (pCairoContext, -log.x, 0);  // all glyphs share the same baseline.
+	cairo_set_source_rgb (pCairoContext, 1., 1., 1.);  // white, so that it can be colorized with glColor.
+	pango_cairo_show_layout (pCairoContext, pAtlas->pLayout);
+	cairo_destroy (pCairoContext);
+	cairo_surface_flush (pSurface);
+	
+	glBindTexture (GL_TEXTURE_2D, pAtlas->iTexture);
+	glPixelStorei (GL_UNPACK_ROW_LENGTH, cairo_image_surface_get_stride (pSurface) / 4);
+	glTexSubImage2D (GL_TEXTURE_2D,
+		0,
+		pAtlas->iCursorX, pAtlas->iCursorY,
+		w, h,
+		GL_BGRA,
+		GL_UNSIGNED_BYTE,
+		cairo_image_surface_get_data (pSurface));
+	glPixelStorei (GL_UNPACK_ROW_LENGTH, 0);
+	cairo_surface_destroy (pSurface);
+	
+	CDGlyph *pGlyph = g_new (CDGlyph, 1);
+	pGlyph->u = (GLfloat) pAtlas->iCursorX / CD_GLYPH_ATLAS_SIZE;
+	pGlyph->v = (GLfloat) pAtlas->iCursorY / CD_GLYPH_ATLAS_SIZE;
+	pGlyph->du = (GLfloat) w / CD_GLYPH_ATLAS_SIZE;
+	pGlyph->dv = (GLfloat) h / CD_GLYPH_ATLAS_SIZE;
+	pGlyph->iWidth = w;
+	g_hash_table_insert (pAtlas->pGlyphs, GUINT_TO_POINTER (c), pGlyph);
+	
+	pAtlas->iCursorX += w + 1;
+	pAtlas->iRowHeight = MAX (pAtlas->iRowHeight, h);
+	return pGlyph;
+}
+
+static inline CDGlyph *_get_glyph (CairoDockGLFontAtlas *pAtlas, gunichar c)
+{
+	CDGlyph *pGlyph = g_hash_table_lookup (pAtlas->pGlyphs, GUINT_TO_POINTER (c));
+	if (pGlyph == NULL)
+		pGlyph = _load_glyph (pAtlas, c);
+	return pGlyph;
+}
+
+// get the next character of an UTF-8 string, skipping invalid bytes.
+static inline gunichar _next_char (const gchar **str)
+{
+	gunichar c = g_utf8_get_char_validated (*str, -1);
+	if (c == (gunichar)-1 || c == (gunichar)-2)
+	{
+		(*str) ++;
+		return 0;
+	}
+	*str = g_utf8_next_char (*str);
+	return c;
+}
+
+static void _flush_glyphs (CairoDockGLFontAtlas *pAtlas);
+
+// compute the size of a text, loading its glyphs on the way; if the atlas is full, the pending glyphs are drawn and the atlas is started again, so that the whole text fits in it.
+static void _get_glyph_text_extent (const gchar *cText, CairoDockGLFontAtlas *pAtlas, int *iWidth, int *iHeight)
+{
+	int w = 0, wmax = 0, h = pAtlas->iLineHeight;
+	gboolean bReset = FALSE;
+	const gchar *str = cText;
+	gunichar c;
+	CDGlyph *pGlyph;
+	while (*str != '\0')
+	{
+		c = _next_char (&str);
+		if (c == 0)
+			continue;
+		if (c == '\n')
+		{
+			h += pAtlas->iLineHeight + 1;
+			wmax = MAX (wmax, w);
+			w = 0;
+			continue;
+		}
+		pGlyph = _get_glyph (pAtlas, c);
+		if (pGlyph == NULL && ! bReset)
+		{
+			_flush_glyphs (pAtlas);
+			_reset_glyph_atlas (pAtlas);
+			bReset = TRUE;  // only once, in case the text alone doesn't fit.
+			pGlyph = _get_glyph (pAtlas, c);
+		}
+		if (pGlyph != NULL)
+			w += pGlyph->iWidth;
+	}
+	*iWidth = MAX (wmax, w);
+	*iHeight = h;
+}
+
+static void _flush_glyphs (CairoDockGLFontAtlas *pAtlas)
+{
+	int n = pAtlas->pVertices->len / 2;
+	if (n != 0)
+	{
+		_cairo_dock_enable_texture ();
+		_cairo_dock_set_blend_pbuffer ();  // rend mieux pour les textes
+		glBindTexture (GL_TEXTURE_2D, pAtlas->iTexture);
+		
+		glEnableClientState (GL_TEXTURE_COORD_ARRAY);
+		glEnableClientState (GL_VERTEX_ARRAY);
+		glTexCoordPointer (2, GL_FLOAT, 2 * sizeof(GLfloat), pAtlas->pCoords->data);
+		glVertexPointer (2, GL_FLOAT, 2 * sizeof(GLfloat), pAtlas->pVertices->data);
+		if (pAtlas->bBatching)
+		{
+			glEnableClientState (GL_COLOR_ARRAY);
+			glColorPointer (4, GL_FLOAT, 4 * sizeof(GLfloat), pAtlas->pColors->data);
+		}
+		
+		glDrawArrays (GL_QUADS, 0, n);
+		
+		if (pAtlas->bBatching)
+		{
+			glDisableClientState (GL_COLOR_ARRAY);
+			glColor4f (1., 1., 1., 1.);  // the current color is undefined after using a color array.
+		}
+		glDisableClientState (GL_TEXTURE_COORD_ARRAY);
+		glDisableClientState (GL_VERTEX_ARRAY);
+		_cairo_dock_disable_texture ();
+	}
+	g_array_set_size (pAtlas->pVertices, 0);
+	g_array_set_size (pAtlas->pCoords, 0);
+	g_array_set_size (pAtlas->pColors, 0);
+}
+
+// add the quads of a text in the pending vertices, with the transformation (x + zx * X, y + zy * Y); the text occupies [0;w]x[0;h] before the transformation, the first line being on top. Returns FALSE if a glyph couldn't be loaded because the atlas is full.
+static gboolean _add_glyphs (const gchar *cText, CairoDockGLFontAtlas *pAtlas, double x, double y, double zx, double zy, int iTextHeight, const GLfloat *pColor)
+{
+	double X = 0, Y = iTextHeight - pAtlas->iLineHeight;  // bottom of the first line
+	double h = pAtlas->iLineHeight;
+	const gchar *str = cText;
+	gunichar c;
+	CDGlyph *pGlyph;
+	while (*str != '\0')
+	{
+		c = _next_char (&str);
+		if (c == 0)
+			continue;
+		if (c == '\n')
+		{
+			X = 0;
+			Y -= h + 1;
+			continue;
+		}
+		pGlyph = _get_glyph (pAtlas, c);
+		if (pGlyph == NULL)
+			return FALSE;
+		
+		GLfloat v[8] = {
+			x + zx * X, y + zy * (Y + h),
+			x + zx * (X + pGlyph->iWidth), y + zy * (Y + h),
+			x + zx * (X + pGlyph->iWidth), y + zy * Y,
+			x + zx * X, y + zy * Y};
+		GLfloat t[8] = {
+			pGlyph->u, pGlyph->v,
+			pGlyph->u + pGlyph->du, pGlyph->v,
+			pGlyph->u + pGlyph->du, pGlyph->v + pGlyph->dv,
+			pGlyph->u, pGlyph->v + pGlyph->dv};
+		g_array_append_vals (pAtlas->pVertices, v, 8);
+		g_array_append_vals (pAtlas->pCoords, t, 8);
+		if (pColor != NULL)
+		{
+			int i;
+			for (i = 0; i < 4; i ++)
+				g_array_append_vals (pAtlas->pColors, pColor, 4);
+		}
+		X += pGlyph->iWidth;
+	}
+	return TRUE;
+}
+
+static void _draw_glyphs (const gchar *cText, CairoDockGLFontAtlas *pAtlas, double x, double y, double zx, double zy, const GLfloat *pColor)
+{
+	if (pColor == NULL && pAtlas->bBatching)  // drawn with the current color, so it can't join the batch: draw the batch first.
+	{
+		_flush_glyphs (pAtlas);
+		pAtlas->bBatching = FALSE;
+		_draw_glyphs (cText, pAtlas, x, y, zx, zy, NULL);
+		pAtlas->bBatching = TRUE;
+		return;
+	}
+	int w, h;
+	_get_glyph_text_extent (cText, pAtlas, &w, &h);
+	guint iNbVertices = pAtlas->pVertices->len;
+	if (! _add_glyphs (cText, pAtlas, x, y, zx, zy, h, pColor))  // the atlas is full: draw what is pending, and start a new atlas (the glyphs will be loaded again on demand).
+	{
+		g_array_set_size (pAtlas->pVertices, iNbVertices);
+		g_array_set_size (pAtlas->pCoords, iNbVertices);
+		g_array_set_size (pAtlas->pColors, pColor != NULL ? 2 * iNbVertices : 0);
+		_flush_glyphs (pAtlas);
+		_reset_glyph_atlas (pAtlas);
+		_add_glyphs (cText, pAtlas, x, y, zx, zy, h, pColor);  // if it still doesn't fit, we draw what could be loaded.
+	}
+	if (! pAtlas->bBatching)
+		_flush_glyphs (pAtlas);
+}
+
+void cairo_dock_begin_gl_text_batch (CairoDockGLFont *pFont)
+{
+	g_return_if_fail (pFont != NULL);
+	if (pFont->pAtlas == NULL)
+		return;
+	_flush_glyphs (pFont->pAtlas);
+	pFont->pAtlas->bBatching = TRUE;
+}
+
+void cairo_dock_add_gl_text_to_batch (const gchar *cText, CairoDockGLFont *pFont, double x, double y, int iWidth, int iHeight, gboolean bCentered, const double *pColor)
+{
+	g_return_if_fail (pFont != NULL && cText != NULL);
+	if (pFont->pAtlas == NULL || ! pFont->pAtlas->bBatching)  // no batch, draw it now.
+	{
+		glPushMatrix ();
+		glColor3f (pColor[0], pColor[1], pColor[2]);
+		cairo_dock_draw_gl_text_at_position_in_area ((const guchar *)cText, pFont, x, y, iWidth, iHeight, bCentered);
+		glColor3f (1., 1., 1.);
+		glPopMatrix ();
+		return;
+	}
+	CairoDockGLFontAtlas *pAtlas = pFont->pAtlas;
+	int w, h;
+	_get_glyph_text_extent (cText, pAtlas, &w, &h);
+	if (w == 0)
+		return;
+	double zx, zy;
+	if (fabs ((double)iWidth/w) < fabs ((double)iHeight/h))
+	{
+		zx = (double)iWidth/w;
+		zy = (iWidth*iHeight > 0 ? zx : -zx);
+	}
+	else
+	{
+		zy = (double)iHeight/h;
+		zx = (iWidth*iHeight > 0 ? zy : -zy);
+	}
+	if (bCentered)
+	{
+		x -= zx * w/2;
+		y -= zy * h/2;
+	}
+	GLfloat color[4] = {pColor[0], pColor[1], pColor[2], 1.};
+	_draw_glyphs (cText, pAtlas, x, y, zx, zy, color);
+}
+
+void cairo_dock_end_gl_text_batch (CairoDockGLFont *pFont)
+{
+	g_return_if_fail (pFont != NULL);
+	if (pFont->pAtlas == NULL)
+		return;
+	_flush_glyphs (pFont->pAtlas);
+	pFont->pAtlas->bBatching = FALSE;
+}
+
+
 void cairo_dock_free_gl_font (CairoDockGLFont *pFont)
 {
 	if (pFont == NULL)
@@ -262,6 +617,8 @@ void cairo_dock_free_gl_font (CairoDockGLFont *pFont)
 		glDeleteLists (pFont->iListBase, pFont->iNbChars);
 	if (pFont->iTexture != 0)
 		_cairo_dock_delete_texture (pFont->iTexture);
+	if (pFont->pAtlas != NULL)
+		_free_glyph_atlas (pFont->pAtlas);
 	g_free (pFont);
 }
 
@@ -274,6 +631,11 @@ void cairo_dock_get_gl_text_extent (const gchar *cText, CairoDockGLFont *pFont,
 		*iHeight = 0;
 		return ;
 	}
+	if (pFont->pAtlas != NULL)
+	{
+		_get_glyph_text_extent (cText, pFont->pAtlas, iWidth, iHeight);
+		return ;
+	}
 	int i, w=0, wmax=0, h=pFont->iCharHeight;
 	for (i = 0; cText[i] != '\0'; i ++)
 	{
@@ -295,7 +657,11 @@ void cairo_dock_get_gl_text_extent (const gchar *cText, CairoDockGLFont *pFont,
 void cairo_dock_draw_gl_text (const guchar *cText, CairoDockGLFont *pFont)
 {
 	int n = strlen ((char *) cText);
-	if (pFont->iListBase != 0)
+	if (pFont->pAtlas != NULL)
+	{
+		_draw_glyphs ((const gchar *) cText, pFont->pAtlas, 0, 0, 1, 1, NULL);
+	}
+	else if (pFont->iListBase != 0)
 	{
 		if (pFont->iCharBase == 0 && strchr ((char *) cText, '\n') == NULL)  // version optimisee ou on a charge tous les caracteres.
 		{
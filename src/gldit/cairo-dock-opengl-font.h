@@ -33,8 +33,10 @@ G_BEGIN_DECLS
 *@file cairo-dock-opengl-font.h This class provides different ways to draw text directly in OpenGL.
 * \ref cairo_dock_create_texture_from_text_simple lets you draw any text in any font, by creating a texture from a Pango font description. This is a convenient function but not very fast.
 * For a more efficient way, you load a font into a CairoDockGLFont with either :
+* \ref cairo_dock_load_glyph_font to load any font; its glyphs are rendered on demand into a texture, so any UTF-8 text can be drawn.
 * \ref cairo_dock_load_textured_font to load a subset of a Mono font into textures.
 * You then use \ref cairo_dock_draw_gl_text_at_position to draw the text.
+* Several texts can be drawn at once with a glyph font, by placing them between \ref cairo_dock_begin_gl_text_batch and \ref cairo_dock_end_gl_text_batch.
 */
 
 /** Create a texture from a text. The text is drawn in white, so that you can later colorize it with a mere glColor.
@@ -47,6 +49,8 @@ G_BEGIN_DECLS
 */
 GLuint cairo_dock_create_texture_from_text_simple (const gchar *cText, const gchar *cFontDescription, cairo_t* pSourceContext, int *iWidth, int *iHeight);
 
+typedef struct _CairoDockGLFontAtlas CairoDockGLFontAtlas;
+
 /// Structure used to load a font for OpenGL text rendering.
 struct _CairoDockGLFont {
 	GLuint iListBase;
@@ -57,6 +61,8 @@ struct _CairoDockGLFont {
 	gint iNbChars;
 	gdouble iCharWidth;
 	gdouble iCharHeight;
+	/// glyphs of a glyph font, NULL otherwise.
+	CairoDockGLFontAtlas *pAtlas;
 };
 
 /* Load a font into bitmaps. You can load any characters of font with this function. The drawback is that each character is a bitmap, that is to say you can't zoom them.
@@ -67,6 +73,12 @@ struct _CairoDockGLFont {
 */
 //CairoDockGLFont *cairo_dock_load_bitmap_font (const gchar *cFontDescription, int first, int count);
 
+/** Load a font whose glyphs will be rendered on demand into a texture. Any character can be drawn with it (the text is in UTF-8), and each text is drawn in 1 call.
+*@param cFontDescription a description of the font, for instance "Monospace Bold 12"
+*@return a newly allocated opengl font.
+*/
+CairoDockGLFont *cairo_dock_load_glyph_font (const gchar *cFontDescription);
+
 /** Load a font into textures. You can then render your text like a normal texture (zoom, etc). The drawback is that only a mono font can be used with this function.
 *@param cFontDescription a description of the font, for instance "Monospace Bold 12"
 *@param first first character to load.
@@ -129,5 +141,28 @@ void cairo_dock_draw_gl_text_in_area (const guchar *cText, CairoDockGLFont *pFon
 void cairo_dock_draw_gl_text_at_position_in_area (const guchar *cText, CairoDockGLFont *pFont, int x, int y, int iWidth, int iHeight, gboolean bCentered);
 
 
+/** Start a batch of texts for a glyph font: the texts added with \ref cairo_dock_add_gl_text_to_batch are drawn all at once by \ref cairo_dock_end_gl_text_batch. The current model view must not change in-between. Does nothing for the other fonts.
+*@param pFont the font.
+*/
+void cairo_dock_begin_gl_text_batch (CairoDockGLFont *pFont);
+
+/** Add a text to the current batch. It is like \ref cairo_dock_draw_gl_text_at_position_in_area, but the model view is not altered. If no batch has been started, the text is drawn immediately.
+*@param cText the text
+*@param pFont the font.
+*@param x x position of the left bottom corner of the text.
+*@param y y position of the left bottom corner of the text.
+*@param iWidth iWidth of the area.
+*@param iHeight iHeight of the area
+*@param bCentered whether the text is centered on the given position or not.
+*@param pColor RGB color of the text.
+*/
+void cairo_dock_add_gl_text_to_batch (const gchar *cText, CairoDockGLFont *pFont, double x, double y, int iWidth, int iHeight, gboolean bCentered, const double *pColor);
+
+/** Draw all the texts of the current batch.
+*@param pFont the font.
+*/
+void cairo_dock_end_gl_text_batch (CairoDockGLFont *pFont);
+
+
 G_END_DECLS
 #endif
@@ -158,7 +158,8 @@ gboolean gldi_gl_container_make_current (GldiContainer *pContainer)
 
 static void _apply_desktop_background (GldiContainer *pContainer)
 {
-	if (! g_pFakeTransparencyDesktopBg || g_pFakeTransparencyDesktopBg->iTexture == 0)
+	GLuint iTexture = (g_pFakeTransparencyDesktopBg ? gldi_desktop_background_get_texture (g_pFakeTransparencyDesktopBg) : 0);
+	if (iTexture == 0)
 		return ;
 	
 	glPushMatrix ();
@@ -169,7 +170,7 @@ static void _apply_desktop_background (GldiContainer *pContainer)
 	_cairo_dock_enable_texture ();
 	_cairo_dock_set_blend_source ();
 	_cairo_dock_set_alpha (1.);
-	glBindTexture (GL_TEXTURE_2D, g_pFakeTransparencyDesktopBg->iTexture);
+	glBindTexture (GL_TEXTURE_2D, iTexture);
 	
 	double x, y, w, h, W, H;
 	W = gldi_desktop_get_width();
@@ -39,6 +39,32 @@ extern gboolean g_bUseOpenGL;
 
 // private
 #define CD_DEFAULT_SCALE 0.5
+#define CD_OVERLAY_ATLAS_SIZE 512  // size of an atlas page (a power of 2, for old graphic cards).
+#define CD_OVERLAY_ATLAS_MAX_IMAGE_SIZE 128  // bigger images keep their own texture.
+#define CD_OVERLAY_ATLAS_PADDING 1  // transparent gap around each image, so that linear filtering doesn't pick the pixels of its neighbours.
+
+typedef struct {
+	GLuint iTexture;
+	gint iNbSlots;  // number of overlays currently in the page
+	GList *pShelves;  // rows of images of similar heights
+	gint iUsedHeight;
+	GList *pFreeSlots;  // areas that have been released, and can be reused by an image that fits in them
+	} CairoOverlayAtlasPage;
+
+typedef struct {
+	gint y;
+	gint iHeight;
+	gint iUsedWidth;
+	} CairoOverlayAtlasShelf;
+
+struct _CairoOverlayAtlasSlot {
+	CairoOverlayAtlasPage *pPage;
+	gint x, y;  // position of the image in the page
+	gint iWidth, iHeight;  // size of the image
+	gint iAreaWidth, iAreaHeight;  // size of the area reserved in the page, which can be bigger when the slot is reused.
+	};
+
+static GList *s_pAtlasPages = NULL;
 
 
 CairoOverlay *gldi_overlay_new (CairoOverlayAttr *attr)
@@ -140,6 +166,188 @@ void cairo_dock_remove_overlay_at_position (Icon *pIcon, CairoOverlayPosition iP
 	}
 }
 
+  /////////////
+ /// ATLAS ///
+/////////////
+
+static CairoOverlayAtlasPage *_new_atlas_page (void)
+{
+	CairoOverlayAtlasPage *pPage = g_new0 (CairoOverlayAtlasPage, 1);
+	guchar *pBlankData = g_new0 (guchar, CD_OVERLAY_ATLAS_SIZE * CD_OVERLAY_ATLAS_SIZE * 4);  // fully transparent, for the paddings.
+	pPage->iTexture = cairo_dock_create_texture_from_raw_data (pBlankData, CD_OVERLAY_ATLAS_SIZE, CD_OVERLAY_ATLAS_SIZE);
+	g_free (pBlankData);
+	s_pAtlasPages = g_list_append (s_pAtlasPages, pPage);
+	return pPage;
+}
+
+static void _free_atlas_page (CairoOverlayAtlasPage *pPage)
+{
+	s_pAtlasPages = g_list_remove (s_pAtlasPages, pPage);
+	glDeleteTextures (1, &pPage->iTexture);
+	g_list_foreach (pPage->pShelves, (GFunc)g_free, NULL);
+	g_list_free (pPage->pShelves);
+	g_list_foreach (pPage->pFreeSlots, (GFunc)g_free, NULL);
+	g_list_free (pPage->pFreeSlots);
+	g_free (pPage);
+}
+
+static CairoOverlayAtlasSlot *_alloc_in_atlas_page (CairoOverlayAtlasPage *pPage, int w, int h)
+{
+	// first try to reuse the smallest released area where the image fits (overlays are often of the same size, and quick-infos change their width often).
+	CairoOverlayAtlasSlot *pSlot, *pBestSlot = NULL;
+	GList *s;
+	for (s = pPage->pFreeSlots; s != NULL; s = s->next)
+	{
+		pSlot = s->data;
+		if (pSlot->iAreaWidth >= w && pSlot->iAreaHeight >= h
+		&& (pBestSlot == NULL || pSlot->iAreaWidth * pSlot->iAreaHeight < pBestSlot->iAreaWidth * pBestSlot->iAreaHeight))
+			pBestSlot = pSlot;
+	}
+	if (pBestSlot != NULL)
+	{
+		pPage->pFreeSlots = g_list_remove (pPage->pFreeSlots, pBestSlot);
+		pBestSlot->iWidth = w;
+		pBestSlot->iHeight = h;
+		pPage->iNbSlots ++;
+		return pBestSlot;
+	}
+	
+	// then look for a shelf with enough room, and not too high to avoid wasting space.
+	int wp = w + 2 * CD_OVERLAY_ATLAS_PADDING, hp = h + 2 * CD_OVERLAY_ATLAS_PADDING;
+	CairoOverlayAtlasShelf *pShelf = NULL;
+	for (s = pPage->pShelves; s != NULL; s = s->next)
+	{
+		CairoOverlayAtlasShelf *sh = s->data;
+		if (sh->iHeight >= hp && sh->iHeight <= hp * 3 / 2 && CD_OVERLAY_ATLAS_SIZE - sh->iUsedWidth >= wp)
+		{
+			pShelf = sh;
+			break;
+		}
+	}
+	
+	// else open a new shelf.
+	if (pShelf == NULL)
+	{
+		if (CD_OVERLAY_ATLAS_SIZE - pPage->iUsedHeight < hp)  // the page is full.
+			return NULL;
+		pShelf = g_new0 (CairoOverlayAtlasShelf, 1);
+		pShelf->y = pPage->iUsedHeight;
+		pShelf->iHeight = hp;
+		pPage->iUsedHeight += hp;
+		pPage->pShelves = g_list_prepend (pPage->pShelves, pShelf);
+	}
+	
+	pSlot = g_new0 (CairoOverlayAtlasSlot, 1);
+	pSlot->pPage = pPage;
+	pSlot->x = pShelf->iUsedWidth + CD_OVERLAY_ATLAS_PADDING;
+	pSlot->y = pShelf->y + CD_OVERLAY_ATLAS_PADDING;
+	pSlot->iWidth = pSlot->iAreaWidth = w;
+	pSlot->iHeight = pSlot->iAreaHeight = h;
+	pShelf->iUsedWidth += wp;
+	pPage->iNbSlots ++;
+	return pSlot;
+}
+
+static CairoOverlayAtlasSlot *_alloc_atlas_slot (int w, int h)
+{
+	CairoOverlayAtlasSlot *pSlot = NULL;
+	GList *p;
+	for (p = s_pAtlasPages; p != NULL && pSlot == NULL; p = p->next)
+	{
+		pSlot = _alloc_in_atlas_page (p->data, w, h);
+	}
+	if (pSlot == NULL)
+	{
+		CairoOverlayAtlasPage *pPage = _new_atlas_page ();
+		if (pPage->iTexture != 0)
+			pSlot = _alloc_in_atlas_page (pPage, w, h);
+		else
+			_free_atlas_page (pPage);
+	}
+	return pSlot;
+}
+
+static void _free_atlas_slot (CairoOverlayAtlasSlot *pSlot)
+{
+	CairoOverlayAtlasPage *pPage = pSlot->pPage;
+	pPage->iNbSlots --;
+	if (pPage->iNbSlots == 0)  // nobody uses this page anymore, free it to give the memory back.
+	{
+		g_free (pSlot);
+		_free_atlas_page (pPage);
+	}
+	else
+	{
+		pPage->pFreeSlots = g_list_prepend (pPage->pFreeSlots, pSlot);
+	}
+}
+
+gboolean cairo_dock_pack_overlay_in_atlas (CairoOverlay *pOverlay)
+{
+	cairo_surface_t *pSurface = pOverlay->image.pSurface;
+	if (pOverlay->pAtlasSlot != NULL)
+		return TRUE;
+	if (! g_bUseOpenGL || pOverlay->image.iTexture == 0 || pSurface == NULL || cairo_dock_image_buffer_is_animated (&pOverlay->image))
+		return FALSE;
+	int w = cairo_image_surface_get_width (pSurface);
+	int h = cairo_image_surface_get_height (pSurface);
+	if (w <= 0 || h <= 0 || w > CD_OVERLAY_ATLAS_MAX_IMAGE_SIZE || h > CD_OVERLAY_ATLAS_MAX_IMAGE_SIZE)
+		return FALSE;
+	
+	CairoOverlayAtlasSlot *pSlot = _alloc_atlas_slot (w, h);
+	if (pSlot == NULL)
+		return FALSE;
+	
+	// copy the image into the page.
+	cairo_surface_flush (pSurface);
+	glBindTexture (GL_TEXTURE_2D, pSlot->pPage->iTexture);
+	if (pSlot->iAreaWidth != w || pSlot->iAreaHeight != h)  // reused area: clear what the previous image left around the new one.
+	{
+		guchar *pBlankData = g_new0 (guchar, pSlot->iAreaWidth * pSlot->iAreaHeight * 4);
+		glTexSubImage2D (GL_TEXTURE_2D,
+			0,
+			pSlot->x, pSlot->y,
+			pSlot->iAreaWidth, pSlot->iAreaHeight,
+			GL_BGRA,
+			GL_UNSIGNED_BYTE,
+			pBlankData);
+		g_free (pBlankData);
+	}
+	glPixelStorei (GL_UNPACK_ROW_LENGTH, cairo_image_surface_get_stride (pSurface) / 4);
+	glTexSubImage2D (GL_TEXTURE_2D,
+		0,
+		pSlot->x, pSlot->y,
+		w, h,
+		GL_BGRA,
+		GL_UNSIGNED_BYTE,
+		cairo_image_surface_get_data (pSurface));
+	glPixelStorei (GL_UNPACK_ROW_LENGTH, 0);
+	glBindTexture (GL_TEXTURE_2D, 0);
+	
+	// the overlay doesn't need its own texture anymore.
+	glDeleteTextures (1, &pOverlay->image.iTexture);
+	pOverlay->image.iTexture = 0;
+	pOverlay->pAtlasSlot = pSlot;
+	return TRUE;
+}
+
+static void _unpack_overlay_from_atlas (CairoOverlay *pOverlay)
+{
+	_free_atlas_slot (pOverlay->pAtlasSlot);
+	pOverlay->pAtlasSlot = NULL;
+}
+
+CairoDockImageBuffer *cairo_dock_get_overlay_image_buffer (CairoOverlay *pOverlay)
+{
+	if (pOverlay->pAtlasSlot != NULL)  // the caller may draw on the image, so give it its own texture back.
+	{
+		_unpack_overlay_from_atlas (pOverlay);
+		pOverlay->image.iTexture = cairo_dock_create_texture_from_surface (pOverlay->image.pSurface);
+	}
+	return &pOverlay->image;
+}
+
+
   /////////////////////
  /// ICON OVERLAYS ///
 /////////////////////
@@ -206,6 +414,20 @@ static void _get_overlay_position_and_size (CairoOverlay *pOverlay, int w, int h
 		break;
 	}
 }
+static inline void _align_overlay_on_grid (Icon *pIcon, int wo, int ho, double *x, double *y)
+{
+	if (pIcon->fScale == 1)  // place the overlay on the grid to avoid scale blur (only when the icon is at rest, otherwise it makes the movement jerky).
+	{
+		if (wo & 1)
+			*x = floor (*x) + .5;
+		else
+			*x = round (*x);
+		if (ho & 1)
+			*y = floor (*y) + .5;
+		else
+			*y = round (*y);
+	}
+}
 void cairo_dock_draw_icon_overlays_cairo (Icon *pIcon, double fRatio, cairo_t *pCairoContext)
 {
 	if (pIcon->pOverlays == NULL)
@@ -273,35 +495,55 @@ void cairo_dock_draw_icon_overlays_opengl (Icon *pIcon, double fRatio)
 	CairoOverlay *p;
 	int wo, ho;  // actual size at which the overlay will be rendered.
 	double x, y;  // position of the overlay relatively to the icon center.
-	for (ov = pIcon->pOverlays; ov != NULL; ov = ov->next)
+	CairoOverlayAtlasSlot *pSlot;
+	CairoOverlayAtlasPage *pBatchPage = NULL;  // page of the current batch of quads, if any.
+	double u0, v0, u1, v1;
+	glPushMatrix ();
+	glRotatef (-pIcon->fOrientation/G_PI*180., 0., 0., 1.);
+	for (ov = pIcon->pOverlays; ov != NULL; ov = ov->next)  // draw in the order of the list, to keep the stacking of the overlays.
 	{
 		p = ov->data;
-		if (! p->image.iTexture)
+		pSlot = p->pAtlasSlot;
+		if (pSlot == NULL && ! p->image.iTexture)
 			continue;
-		glPushMatrix ();
 		
-		_get_overlay_position_and_size (p, w, h, z, &x, &y, &wo, &ho);
-		if (pIcon->fScale == 1)  // place the overlay on the grid to avoid scale blur (only when the icon is at rest, otherwise it makes the movement jerky).
+		// consecutive overlays packed in the same atlas page are drawn with one bind and one batch of quads.
+		if (pBatchPage != NULL && (pSlot == NULL || pSlot->pPage != pBatchPage))
 		{
-			if (wo & 1)
-				x = floor (x) + .5;
-			else
-				x = round (x);
-			if (ho & 1)
-				y = floor (y) + .5;
-			else
-				y = round (y);
+			glEnd ();
+			pBatchPage = NULL;
 		}
 		
-		// translate to the overlay center.
-		glRotatef (-pIcon->fOrientation/G_PI*180., 0., 0., 1.);
-		glTranslatef (x, y, 0.);
+		_get_overlay_position_and_size (p, w, h, z, &x, &y, &wo, &ho);
+		_align_overlay_on_grid (pIcon, wo, ho, &x, &y);
 		
-		// draw.
-		_cairo_dock_apply_texture_at_size (p->image.iTexture, wo, ho);
+		if (pSlot == NULL)
+		{
+			glPushMatrix ();
+			glTranslatef (x, y, 0.);  // translate to the overlay center.
+			_cairo_dock_apply_texture_at_size (p->image.iTexture, wo, ho);
+			glPopMatrix ();
+			continue;
+		}
 		
-		glPopMatrix ();
+		if (pBatchPage == NULL)
+		{
+			pBatchPage = pSlot->pPage;
+			glBindTexture (GL_TEXTURE_2D, pBatchPage->iTexture);
+			glBegin (GL_QUADS);
+		}
+		u0 = (double)pSlot->x / CD_OVERLAY_ATLAS_SIZE;
+		v0 = (double)pSlot->y / CD_OVERLAY_ATLAS_SIZE;
+		u1 = (double)(pSlot->x + pSlot->iWidth) / CD_OVERLAY_ATLAS_SIZE;
+		v1 = (double)(pSlot->y + pSlot->iHeight) / CD_OVERLAY_ATLAS_SIZE;
+		glTexCoord2f (u0, v0); glVertex3f (x - .5*wo, y + .5*ho, 0.);
+		glTexCoord2f (u1, v0); glVertex3f (x + .5*wo, y + .5*ho, 0.);
+		glTexCoord2f (u1, v1); glVertex3f (x + .5*wo, y - .5*ho, 0.);
+		glTexCoord2f (u0, v1); glVertex3f (x - .5*wo, y - .5*ho, 0.);
 	}
+	if (pBatchPage != NULL)
+		glEnd ();
+	glPopMatrix ();
 	_cairo_dock_disable_texture ();
 }
 
@@ -349,6 +591,7 @@ static void cairo_dock_print_overlay_on_icon (Icon *pIcon, CairoOverlay *pOverla
 	}
 	else if (pIcon->image.pSurface != NULL && pOverlay->image.pSurface != NULL)
 	{
+		cairo_dock_unshare_image_buffer (&pIcon->image);
 		cairo_t *pCairoContext = cairo_create (pIcon->image.pSurface);
 		g_return_if_fail (cairo_status (pCairoContext) == CAIRO_STATUS_SUCCESS);
 		
@@ -432,6 +675,9 @@ static void init_object (GldiObject *obj, gpointer attr)
 	if (cattr->data != NULL)
 	{
 		cairo_dock_add_overlay_to_icon (cattr->pIcon, pOverlay, cattr->iPosition, cattr->data);
+		
+		if (cattr->cImageFile != NULL)  // emblems are never drawn on, so they can share a texture (the image buffer is given back its own texture if someone asks for it).
+			cairo_dock_pack_overlay_in_atlas (pOverlay);
 	}
 }
 
@@ -447,6 +693,8 @@ static void reset_object (GldiObject *obj)
 	}
 	
 	// free data
+	if (pOverlay->pAtlasSlot != NULL)
+		_unpack_overlay_from_atlas (pOverlay);
 	cairo_dock_unload_image_buffer (&pOverlay->image);
 }
 
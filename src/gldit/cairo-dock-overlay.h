@@ -42,6 +42,7 @@ G_BEGIN_DECLS
 
 // manager
 typedef struct _CairoOverlayAttr CairoOverlayAttr;
+typedef struct _CairoOverlayAtlasSlot CairoOverlayAtlasSlot;
 
 #ifndef _MANAGER_DEF_
 extern GldiObjectManager myOverlayObjectMgr;
@@ -91,6 +92,8 @@ struct _CairoOverlay {
 	Icon *pIcon;
 	/// data used to identify an overlay
 	gpointer data;
+	/// location of the image in the shared overlays texture, or NULL if the overlay has its own texture.
+	CairoOverlayAtlasSlot *pAtlasSlot;
 } ;
 
 
@@ -134,10 +137,17 @@ CairoOverlay *cairo_dock_add_overlay_from_texture (Icon *pIcon, GLuint iTexture,
  */
 #define cairo_dock_set_overlay_scale(pOverlay, _fScale) (pOverlay)->fScale = _fScale
 
-/** Get the image buffer of an overlay (only useful if you need to redraw the overlay).
+/** Get the image buffer of an overlay (only useful if you need to redraw the overlay). If the overlay was packed into the shared texture, it gets its own texture back.
  *@param pOverlay the overlay
+ *@return the image buffer.
  */
-#define cairo_dock_get_overlay_image_buffer(pOverlay) (&(pOverlay)->image)
+CairoDockImageBuffer *cairo_dock_get_overlay_image_buffer (CairoOverlay *pOverlay);
+
+/** Pack the image of an overlay into a texture shared with other small overlays, so that they can be drawn without switching textures, and without allocating a texture for each of them. Only use it on an overlay that you won't draw on; overlays loaded from an image are packed automatically.
+ *@param pOverlay the overlay
+ *@return TRUE if the overlay has been packed (it's not possible for big or animated images, or without OpenGL).
+ */
+gboolean cairo_dock_pack_overlay_in_atlas (CairoOverlay *pOverlay);
 
 
 /** Remove an overlay from an icon, given its position and data.
@@ -272,6 +272,7 @@ static GKeyFile* reload_object (GldiObject *obj, gboolean bReloadConf, GKeyFile
 		if (icon->pSubDock != NULL)
 			gldi_dock_rename (icon->pSubDock, icon->cName);  // also updates sub-icon's container name
 	}
+	cairo_dock_reindex_icon (icon);  // its name was read again.
 	
 	icon->iSubdockViewType = g_key_file_get_integer (pKeyFile, "Desktop Entry", "render", NULL);  // on a besoin d'un entier dans le panneau de conf pour pouvoir degriser des options selon le rendu choisi. De plus c'est utile aussi pour Animated Icons...
 	
@@ -175,6 +175,13 @@ static void _cairo_dock_calculate_constrainted_size (double *fImageWidth, double
 }
 
 
+static GPrivate s_bImageSurfacesOnly;  // set in the worker threads, which can't use the primary container.
+
+void cairo_dock_use_image_surfaces_in_this_thread (void)
+{
+	g_private_set (&s_bImageSurfacesOnly, GINT_TO_POINTER (1));
+}
+
 static inline cairo_t *_get_source_context (void)
 {
 	cairo_t *pSourceContext = NULL;
@@ -189,7 +196,7 @@ static inline cairo_t *_get_source_context (void)
 cairo_surface_t *cairo_dock_create_blank_surface (int iWidth, int iHeight)
 {
 	cairo_t *pSourceContext = NULL;
-	if (! g_bUseOpenGL)
+	if (! g_bUseOpenGL && g_private_get (&s_bImageSurfacesOnly) == NULL)
 		pSourceContext = _get_source_context ();
 	cairo_surface_t *pSurface;
 	if (pSourceContext != NULL && cairo_status (pSourceContext) == CAIRO_STATUS_SUCCESS)
@@ -728,40 +735,49 @@ cairo_surface_t * cairo_dock_rotate_surface (cairo_surface_t *pSurface, double f
 }
 
 
-cairo_surface_t *cairo_dock_create_surface_from_text_full (const gchar *cText, GldiTextDescription *pTextDescription, double fMaxScale, int iMaxWidth, int *iTextWidth, int *iTextHeight)
+// snapshot of the global style, to draw a text outside of the main thread.
+typedef struct {
+	cairo_pattern_t *pBgPattern;
+	cairo_pattern_t *pLinePattern;
+	cairo_pattern_t *pTextPattern;
+	gdouble fCornerRadius;
+	} CDTextStyleColors;
+
+static void _setup_text_layout (PangoLayout *pLayout, const gchar *cText, GldiTextDescription *pTextDescription, double fMaxScale, int iMaxLineWidth)
 {
-	g_return_val_if_fail (cText != NULL && pTextDescription != NULL, NULL);
-	cairo_t *pSourceContext = _get_source_context ();
-	g_return_val_if_fail (pSourceContext != NULL && cairo_status (pSourceContext) == CAIRO_STATUS_SUCCESS, NULL);
-	
-	//\_________________ get the font description
 	PangoFontDescription *pDesc = gldi_text_description_get_description (pTextDescription);
 	if (!pDesc)
 		cd_debug ("no text desc for '%s'", cText);
 	int iSize = gldi_text_description_get_size (pTextDescription);
 	pango_font_description_set_absolute_size (pDesc, fMaxScale * iSize * PANGO_SCALE);
-	
-	//\_________________ create a layout
-	PangoLayout *pLayout = pango_cairo_create_layout (pSourceContext);
-	pango_layout_set_font_description (pLayout, pDesc);
+	pango_layout_set_font_description (pLayout, pDesc);  // the layout makes a copy
+	pango_font_description_set_absolute_size (pDesc, iSize * PANGO_SCALE);
 	
 	if (pTextDescription->bUseMarkup)
 		pango_layout_set_markup (pLayout, cText, -1);
 	else
 		pango_layout_set_text (pLayout, cText, -1);
 	
-	//\_________________ handle max width
-	if (pTextDescription->fMaxRelativeWidth != 0)
-	{
-		int iMaxLineWidth = pTextDescription->fMaxRelativeWidth * gldi_desktop_get_width() / g_desktopGeometry.iNbScreens;  // use the mean screen width since the text might be placed anywhere on the X screen.
+	if (iMaxLineWidth != 0)
 		pango_layout_set_width (pLayout, iMaxLineWidth * PANGO_SCALE);  // PANGO_WRAP_WORD by default
-	}
+}
+
+static inline int _get_max_line_width (GldiTextDescription *pTextDescription)
+{
+	return (pTextDescription->fMaxRelativeWidth != 0 ? pTextDescription->fMaxRelativeWidth * gldi_desktop_get_width() / g_desktopGeometry.iNbScreens : 0);  // use the mean screen width since the text might be placed anywhere on the X screen.
+}
+
+// draw a layout into a new surface. If pColors is not NULL, the default colors are taken from it and the surface is a mere image, so that it can be done outside of the main thread.
+static cairo_surface_t *_create_surface_from_layout (PangoLayout *pLayout, GldiTextDescription *pTextDescription, double fMaxScale, int iMaxWidth, CDTextStyleColors *pColors, int *iTextWidth, int *iTextHeight)
+{
 	PangoRectangle log;
 	pango_layout_get_pixel_extents (pLayout, NULL, &log);
+	int iSize = gldi_text_description_get_size (pTextDescription);
 	
 	//\_________________ load the layout into a surface
 	gboolean bDrawBackground = ! pTextDescription->bNoDecorations;
-	double fRadius = (pTextDescription->bUseDefaultColors ? MIN (myStyleParam.iCornerRadius * .75, iSize/2) : fMaxScale * MAX (pTextDescription->iMargin, MIN (6, iSize/2)));  // permet d'avoir un rayon meme si on n'a pas de marge.
+	double fCornerRadius = (pColors ? pColors->fCornerRadius : myStyleParam.iCornerRadius);
+	double fRadius = (pTextDescription->bUseDefaultColors ? MIN (fCornerRadius * .75, iSize/2) : fMaxScale * MAX (pTextDescription->iMargin, MIN (6, iSize/2)));  // permet d'avoir un rayon meme si on n'a pas de marge.
 	int iOutlineMargin = 2*pTextDescription->iMargin * fMaxScale + (pTextDescription->bOutlined ? 2 : 0);  // outlined => +1 tout autour des lettres.
 	double fZoomX = ((iMaxWidth != 0 && log.width + iOutlineMargin > iMaxWidth) ? (double)iMaxWidth / (log.width + iOutlineMargin) : 1.);
 	double fLineWidth = 1;
@@ -775,9 +791,9 @@ cairo_surface_t *cairo_dock_create_surface_from_text_full (const gchar *cText, G
 	}
 	*iTextHeight = log.height + iOutlineMargin + 2*fLineWidth;
 	
-	cairo_surface_t* pNewSurface = cairo_dock_create_blank_surface (
-		*iTextWidth,
-		*iTextHeight);
+	cairo_surface_t* pNewSurface = (pColors ?
+		cairo_image_surface_create (CAIRO_FORMAT_ARGB32, *iTextWidth, *iTextHeight) :
+		cairo_dock_create_blank_surface (*iTextWidth, *iTextHeight));
 	cairo_t* pCairoContext = cairo_create (pNewSurface);
 	
 	//\_________________ draw the background
@@ -788,16 +804,20 @@ cairo_surface_t *cairo_dock_create_surface_from_text_full (const gchar *cText, G
 		double fFrameHeight = *iTextHeight - fLineWidth;
 		cairo_dock_draw_rounded_rectangle (pCairoContext, fRadius, fLineWidth, fFrameWidth, fFrameHeight);
 		
-		if (pTextDescription->bUseDefaultColors)
-			gldi_style_colors_set_bg_color (pCairoContext);
-		else
+		if (! pTextDescription->bUseDefaultColors)
 			gldi_color_set_cairo (pCairoContext, &pTextDescription->fBackgroundColor);
+		else if (pColors)
+			cairo_set_source (pCairoContext, pColors->pBgPattern);
+		else
+			gldi_style_colors_set_bg_color (pCairoContext);
 		cairo_fill_preserve (pCairoContext);
 		
-		if (pTextDescription->bUseDefaultColors)
-			gldi_style_colors_set_line_color (pCairoContext);
-		else
+		if (! pTextDescription->bUseDefaultColors)
 			gldi_color_set_cairo (pCairoContext, &pTextDescription->fLineColor);
+		else if (pColors)
+			cairo_set_source (pCairoContext, pColors->pLinePattern);
+		else
+			gldi_style_colors_set_line_color (pCairoContext);
 		cairo_set_line_width (pCairoContext, fLineWidth);
 		cairo_stroke (pCairoContext);
 		
@@ -836,10 +856,12 @@ cairo_surface_t *cairo_dock_create_surface_from_text_full (const gchar *cText, G
 	}
 
 	//\_________________ On remplit l'interieur du texte.
-	if (pTextDescription->bUseDefaultColors)
-		gldi_style_colors_set_text_color (pCairoContext);
-	else
+	if (! pTextDescription->bUseDefaultColors)
 		gldi_color_set_cairo_rgb (pCairoContext, &pTextDescription->fColorStart);
+	else if (pColors)
+		cairo_set_source (pCairoContext, pColors->pTextPattern);
+	else
+		gldi_style_colors_set_text_color (pCairoContext);
 	cairo_move_to (pCairoContext, 0, 0);
 	if (fZoomX != 1)
 		cairo_scale (pCairoContext, fZoomX, 1.);
@@ -851,14 +873,402 @@ cairo_surface_t *cairo_dock_create_surface_from_text_full (const gchar *cText, G
 	
 	*iTextWidth = *iTextWidth/** / fMaxScale*/;
 	*iTextHeight = *iTextHeight/** / fMaxScale*/;
+	return pNewSurface;
+}
+
+cairo_surface_t *cairo_dock_create_surface_from_text_full (const gchar *cText, GldiTextDescription *pTextDescription, double fMaxScale, int iMaxWidth, int *iTextWidth, int *iTextHeight)
+{
+	g_return_val_if_fail (cText != NULL && pTextDescription != NULL, NULL);
+	cairo_t *pSourceContext = _get_source_context ();
+	g_return_val_if_fail (pSourceContext != NULL && cairo_status (pSourceContext) == CAIRO_STATUS_SUCCESS, NULL);
+	
+	//\_________________ create a layout
+	PangoLayout *pLayout = pango_cairo_create_layout (pSourceContext);
+	_setup_text_layout (pLayout, cText, pTextDescription, fMaxScale, _get_max_line_width (pTextDescription));
+	
+	//\_________________ draw it
+	cairo_surface_t* pNewSurface = _create_surface_from_layout (pLayout, pTextDescription, fMaxScale, iMaxWidth, NULL, iTextWidth, iTextHeight);
 	
 	g_object_unref (pLayout);
-	pango_font_description_set_absolute_size (pDesc, iSize * PANGO_SCALE);
 	cairo_destroy (pSourceContext);
 	return pNewSurface;
 }
 
 
+  //////////////////////////
+ /// TEXT SURFACE CACHE ///
+//////////////////////////
+
+#define CD_TEXT_CACHE_MAX_ENTRIES 256
+#define CD_TEXT_CACHE_MAX_SIZE (4 * 1024 * 1024)  // in bytes of pixels
+
+typedef struct {
+	gchar *cText;
+	PangoFontDescription *fd;
+	gint iSize;
+	gboolean bNoDecorations;
+	gboolean bUseDefaultColors;
+	GldiColor fColorStart;
+	GldiColor fBackgroundColor;
+	GldiColor fLineColor;
+	gboolean bOutlined;
+	gint iMargin;
+	gboolean bUseMarkup;
+	gint iMaxLineWidth;  // resolved from fMaxRelativeWidth, so that a change of the screen's width gives a new key
+	gdouble fMaxScale;
+	gint iMaxWidth;
+	} CDTextSurfaceKey;
+
+typedef struct {
+	CDTextSurfaceKey key;
+	cairo_surface_t *pSurface;
+	gint iWidth;
+	gint iHeight;
+	GList link;  // position in the LRU queue
+	} CDTextSurfaceEntry;
+
+static GHashTable *s_pTextSurfaceCache = NULL;  // CDTextSurfaceKey* -> CDTextSurfaceEntry*
+static GQueue s_TextSurfaceLRU = G_QUEUE_INIT;  // most recently used first
+static gsize s_iTextCacheSize = 0;
+static int s_iTextCacheStyleStamp = 0;
+static guint s_iNbTextCacheHits = 0;
+static guint s_iNbTextCacheMisses = 0;
+
+static guint _hash_color (const GldiColor *pColor)
+{
+	return (guint)(pColor->rgba.red * 255) | (guint)(pColor->rgba.green * 255) << 8 | (guint)(pColor->rgba.blue * 255) << 16 | (guint)(pColor->rgba.alpha * 255) << 24;
+}
+
+static guint _text_key_hash (gconstpointer data)
+{
+	const CDTextSurfaceKey *pKey = data;
+	guint h = g_str_hash (pKey->cText);
+	h = h * 31 + (pKey->fd ? pango_font_description_hash (pKey->fd) : 0);
+	h = h * 31 + pKey->iSize;
+	h = h * 31 + (pKey->bNoDecorations | pKey->bUseDefaultColors << 1 | pKey->bOutlined << 2 | pKey->bUseMarkup << 3);
+	if (! pKey->bUseDefaultColors)
+		h = h * 31 + (_hash_color (&pKey->fColorStart) ^ _hash_color (&pKey->fBackgroundColor) ^ _hash_color (&pKey->fLineColor));
+	h = h * 31 + pKey->iMargin;
+	h = h * 31 + pKey->iMaxLineWidth;
+	h = h * 31 + (guint)(pKey->fMaxScale * 1000);
+	h = h * 31 + pKey->iMaxWidth;
+	return h;
+}
+
+static gboolean _text_key_equal (gconstpointer a, gconstpointer b)
+{
+	const CDTextSurfaceKey *k1 = a, *k2 = b;
+	if (k1->iSize != k2->iSize
+	|| k1->bNoDecorations != k2->bNoDecorations
+	|| k1->bUseDefaultColors != k2->bUseDefaultColors
+	|| k1->bOutlined != k2->bOutlined
+	|| k1->iMargin != k2->iMargin
+	|| k1->bUseMarkup != k2->bUseMarkup
+	|| k1->iMaxLineWidth != k2->iMaxLineWidth
+	|| k1->fMaxScale != k2->fMaxScale
+	|| k1->iMaxWidth != k2->iMaxWidth)
+		return FALSE;
+	if (! k1->bUseDefaultColors  // the default colors are the same for everybody, and covered by the style stamp.
+	&& (! gdk_rgba_equal (&k1->fColorStart.rgba, &k2->fColorStart.rgba)
+		|| ! gdk_rgba_equal (&k1->fBackgroundColor.rgba, &k2->fBackgroundColor.rgba)
+		|| ! gdk_rgba_equal (&k1->fLineColor.rgba, &k2->fLineColor.rgba)))
+		return FALSE;
+	if ((k1->fd == NULL) != (k2->fd == NULL) || (k1->fd && ! pango_font_description_equal (k1->fd, k2->fd)))
+		return FALSE;
+	return (strcmp (k1->cText, k2->cText) == 0);
+}
+
+static void _fill_text_key (CDTextSurfaceKey *pKey, const gchar *cText, GldiTextDescription *pTextDescription, double fMaxScale, int iMaxWidth)
+{
+	pKey->cText = (gchar*)cText;
+	pKey->fd = gldi_text_description_get_description (pTextDescription);
+	pKey->iSize = gldi_text_description_get_size (pTextDescription);
+	pKey->bNoDecorations = pTextDescription->bNoDecorations;
+	pKey->bUseDefaultColors = pTextDescription->bUseDefaultColors;
+	pKey->fColorStart = pTextDescription->fColorStart;
+	pKey->fBackgroundColor = pTextDescription->fBackgroundColor;
+	pKey->fLineColor = pTextDescription->fLineColor;
+	pKey->bOutlined = pTextDescription->bOutlined;
+	pKey->iMargin = pTextDescription->iMargin;
+	pKey->bUseMarkup = pTextDescription->bUseMarkup;
+	pKey->iMaxLineWidth = _get_max_line_width (pTextDescription);
+	pKey->fMaxScale = fMaxScale;
+	pKey->iMaxWidth = iMaxWidth;
+}
+
+static void _free_text_entry (CDTextSurfaceEntry *pEntry)
+{
+	s_iTextCacheSize -= 4 * pEntry->iWidth * pEntry->iHeight;
+	cairo_surface_destroy (pEntry->pSurface);
+	g_free (pEntry->key.cText);
+	if (pEntry->key.fd)
+		pango_font_description_free (pEntry->key.fd);
+	g_free (pEntry);
+}
+
+static void _remove_text_entry (CDTextSurfaceEntry *pEntry)
+{
+	g_queue_unlink (&s_TextSurfaceLRU, &pEntry->link);
+	g_hash_table_remove (s_pTextSurfaceCache, &pEntry->key);  // frees the entry
+}
+
+void cairo_dock_reset_text_surface_cache (void)
+{
+	if (s_pTextSurfaceCache == NULL)
+		return;
+	cd_debug ("text cache: %d entries, %u hits / %u misses", g_queue_get_length (&s_TextSurfaceLRU), s_iNbTextCacheHits, s_iNbTextCacheMisses);
+	while (s_TextSurfaceLRU.head != NULL)
+		_remove_text_entry (s_TextSurfaceLRU.head->data);
+}
+
+static void _copy_text_key (CDTextSurfaceKey *pDest, const CDTextSurfaceKey *pKey)
+{
+	*pDest = *pKey;
+	pDest->cText = g_strdup (pKey->cText);
+	pDest->fd = (pKey->fd ? pango_font_description_copy (pKey->fd) : NULL);
+}
+
+static void _check_text_cache (void)
+{
+	if (s_pTextSurfaceCache == NULL)
+		s_pTextSurfaceCache = g_hash_table_new_full (_text_key_hash, _text_key_equal, NULL, (GDestroyNotify)_free_text_entry);
+	
+	//\_________________ a change of the global style invalidates the surfaces drawn with the default colors (and the corner radius).
+	int iStamp = gldi_style_colors_get_stamp ();
+	if (iStamp != s_iTextCacheStyleStamp)
+	{
+		cairo_dock_reset_text_surface_cache ();
+		s_iTextCacheStyleStamp = iStamp;
+	}
+}
+
+static CDTextSurfaceEntry *_lookup_text_cache (const CDTextSurfaceKey *pKey)
+{
+	_check_text_cache ();
+	CDTextSurfaceEntry *pEntry = g_hash_table_lookup (s_pTextSurfaceCache, pKey);
+	if (pEntry != NULL)
+	{
+		s_iNbTextCacheHits ++;
+		g_queue_unlink (&s_TextSurfaceLRU, &pEntry->link);
+		g_queue_push_head_link (&s_TextSurfaceLRU, &pEntry->link);
+	}
+	else
+		s_iNbTextCacheMisses ++;
+	return pEntry;
+}
+
+static void _add_to_text_cache (const CDTextSurfaceKey *pKey, cairo_surface_t *pSurface, int iWidth, int iHeight)
+{
+	gsize iSize = 4 * iWidth * iHeight;
+	if (iSize > CD_TEXT_CACHE_MAX_SIZE / 4)  // too big to be worth keeping (long dialog texts...)
+		return;
+	
+	CDTextSurfaceEntry *pEntry = g_new0 (CDTextSurfaceEntry, 1);
+	_copy_text_key (&pEntry->key, pKey);
+	pEntry->pSurface = cairo_surface_reference (pSurface);
+	pEntry->iWidth = iWidth;
+	pEntry->iHeight = iHeight;
+	pEntry->link.data = pEntry;
+	g_hash_table_insert (s_pTextSurfaceCache, &pEntry->key, pEntry);
+	g_queue_push_head_link (&s_TextSurfaceLRU, &pEntry->link);
+	s_iTextCacheSize += iSize;
+	
+	//\_________________ evict the least recently used surfaces; the ones still in use stay alive through their own reference.
+	while (s_TextSurfaceLRU.length > CD_TEXT_CACHE_MAX_ENTRIES || s_iTextCacheSize > CD_TEXT_CACHE_MAX_SIZE)
+		_remove_text_entry (s_TextSurfaceLRU.tail->data);
+}
+
+cairo_surface_t *cairo_dock_create_surface_from_text_cached (const gchar *cText, GldiTextDescription *pTextDescription, double fMaxScale, int iMaxWidth, int *iTextWidth, int *iTextHeight)
+{
+	g_return_val_if_fail (cText != NULL && pTextDescription != NULL, NULL);
+	
+	//\_________________ look for the text in the cache.
+	CDTextSurfaceKey key;
+	_fill_text_key (&key, cText, pTextDescription, fMaxScale, iMaxWidth);
+	CDTextSurfaceEntry *pEntry = _lookup_text_cache (&key);
+	if (pEntry != NULL)
+	{
+		*iTextWidth = pEntry->iWidth;
+		*iTextHeight = pEntry->iHeight;
+		return cairo_surface_reference (pEntry->pSurface);
+	}
+	
+	//\_________________ not found, draw it and keep it.
+	cairo_surface_t *pSurface = cairo_dock_create_surface_from_text_full (cText, pTextDescription, fMaxScale, iMaxWidth, iTextWidth, iTextHeight);
+	if (pSurface != NULL)
+		_add_to_text_cache (&key, pSurface, *iTextWidth, *iTextHeight);
+	return pSurface;
+}
+
+void cairo_dock_get_text_surface_cache_stats (guint *iNbHits, guint *iNbMisses, guint *iNbEntries)
+{
+	if (iNbHits)
+		*iNbHits = s_iNbTextCacheHits;
+	if (iNbMisses)
+		*iNbMisses = s_iNbTextCacheMisses;
+	if (iNbEntries)
+		*iNbEntries = g_queue_get_length (&s_TextSurfaceLRU);
+}
+
+
+  //////////////////////////
+ /// ASYNC TEXT SURFACE ///
+//////////////////////////
+
+typedef struct {
+	CDTextSurfaceKey key;  // also used to find an identical text being drawn
+	GldiTextDescription description;  // private copy, used by the thread
+	CDTextStyleColors colors;
+	cairo_font_options_t *pFontOptions;
+	int iStyleStamp;
+	// result
+	cairo_surface_t *pSurface;
+	gint iWidth, iHeight;
+	// main thread only
+	GList *pRequests;
+	} CDTextJob;
+
+struct _CairoDockTextSurfaceRequest {
+	CairoDockTextSurfaceReadyFunc pCallback;
+	gpointer data;
+	CDTextJob *pJob;
+	};
+
+static GThreadPool *s_pTextThreadPool = NULL;
+static GHashTable *s_pPendingTextJobs = NULL;  // CDTextSurfaceKey* -> CDTextJob*, texts being drawn
+
+static void _snapshot_style_colors (CDTextStyleColors *pColors)
+{
+	cairo_surface_t *pSurface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, 1, 1);
+	cairo_t *pCairoContext = cairo_create (pSurface);
+	gldi_style_colors_set_bg_color (pCairoContext);
+	pColors->pBgPattern = cairo_pattern_reference (cairo_get_source (pCairoContext));
+	gldi_style_colors_set_line_color (pCairoContext);
+	pColors->pLinePattern = cairo_pattern_reference (cairo_get_source (pCairoContext));
+	gldi_style_colors_set_text_color (pCairoContext);
+	pColors->pTextPattern = cairo_pattern_reference (cairo_get_source (pCairoContext));
+	cairo_destroy (pCairoContext);
+	cairo_surface_destroy (pSurface);
+	pColors->fCornerRadius = myStyleParam.iCornerRadius;
+}
+
+static void _free_text_job (CDTextJob *pJob)
+{
+	g_free (pJob->key.cText);
+	if (pJob->key.fd)
+		pango_font_description_free (pJob->key.fd);
+	if (pJob->description.fd)
+		pango_font_description_free (pJob->description.fd);
+	cairo_pattern_destroy (pJob->colors.pBgPattern);
+	cairo_pattern_destroy (pJob->colors.pLinePattern);
+	cairo_pattern_destroy (pJob->colors.pTextPattern);
+	if (pJob->pFontOptions)
+		cairo_font_options_destroy (pJob->pFontOptions);
+	if (pJob->pSurface)
+		cairo_surface_destroy (pJob->pSurface);
+	g_free (pJob);
+}
+
+static gboolean _on_text_job_done (CDTextJob *pJob)  // main thread
+{
+	g_hash_table_remove (s_pPendingTextJobs, &pJob->key);
+	if (pJob->pSurface != NULL && pJob->iStyleStamp == gldi_style_colors_get_stamp ())  // don't keep a text drawn with a previous style.
+	{
+		_check_text_cache ();
+		if (g_hash_table_lookup (s_pTextSurfaceCache, &pJob->key) == NULL)  // it may have been drawn synchronously in the meantime.
+			_add_to_text_cache (&pJob->key, pJob->pSurface, pJob->iWidth, pJob->iHeight);
+	}
+	
+	// a callback may cancel another request of this job, so take them one by one from the job's list.
+	CairoDockTextSurfaceRequest *pRequest;
+	while (pJob->pRequests != NULL)
+	{
+		pRequest = pJob->pRequests->data;
+		pJob->pRequests = g_list_delete_link (pJob->pRequests, pJob->pRequests);
+		pRequest->pJob = NULL;  // being answered, it can't be cancelled anymore.
+		pRequest->pCallback (pJob->pSurface ? cairo_surface_reference (pJob->pSurface) : NULL, pJob->iWidth, pJob->iHeight, pRequest->data);
+		g_free (pRequest);
+	}
+	
+	_free_text_job (pJob);
+	return FALSE;
+}
+
+static void _draw_text_job (CDTextJob *pJob, G_GNUC_UNUSED gpointer data)  // worker thread
+{
+	PangoContext *pContext = pango_font_map_create_context (pango_cairo_font_map_get_default ());  // the default font map is per-thread.
+	if (pJob->pFontOptions)
+		pango_cairo_context_set_font_options (pContext, pJob->pFontOptions);
+	PangoLayout *pLayout = pango_layout_new (pContext);
+	g_object_unref (pContext);
+	
+	_setup_text_layout (pLayout, pJob->key.cText, &pJob->description, pJob->key.fMaxScale, pJob->key.iMaxLineWidth);
+	pJob->pSurface = _create_surface_from_layout (pLayout, &pJob->description, pJob->key.fMaxScale, pJob->key.iMaxWidth, &pJob->colors, &pJob->iWidth, &pJob->iHeight);
+	g_object_unref (pLayout);
+	
+	g_idle_add ((GSourceFunc)_on_text_job_done, pJob);
+}
+
+CairoDockTextSurfaceRequest *cairo_dock_create_surface_from_text_async (const gchar *cText, GldiTextDescription *pTextDescription, double fMaxScale, int iMaxWidth, CairoDockTextSurfaceReadyFunc pCallback, gpointer data)
+{
+	g_return_val_if_fail (cText != NULL && pTextDescription != NULL && pCallback != NULL, NULL);
+	
+	//\_________________ the same text may already be available, or being drawn.
+	CDTextSurfaceKey key;
+	_fill_text_key (&key, cText, pTextDescription, fMaxScale, iMaxWidth);
+	CDTextSurfaceEntry *pEntry = _lookup_text_cache (&key);
+	if (pEntry != NULL)
+	{
+		pCallback (cairo_surface_reference (pEntry->pSurface), pEntry->iWidth, pEntry->iHeight, data);
+		return NULL;
+	}
+	
+	if (s_pTextThreadPool == NULL)
+	{
+		s_pTextThreadPool = g_thread_pool_new ((GFunc)_draw_text_job, NULL, 1, FALSE, NULL);  // 1 thread is enough, and keeps the order of the texts.
+		s_pPendingTextJobs = g_hash_table_new (_text_key_hash, _text_key_equal);
+	}
+	CairoDockTextSurfaceRequest *pRequest = g_new0 (CairoDockTextSurfaceRequest, 1);
+	pRequest->pCallback = pCallback;
+	pRequest->data = data;
+	
+	CDTextJob *pJob = g_hash_table_lookup (s_pPendingTextJobs, &key);
+	if (pJob != NULL)  // an identical text is being drawn, share its surface.
+	{
+		pRequest->pJob = pJob;
+		pJob->pRequests = g_list_append (pJob->pRequests, pRequest);
+		return pRequest;
+	}
+	
+	//\_________________ make a new job; everything the thread needs from the main thread is copied now.
+	pJob = g_new0 (CDTextJob, 1);
+	_copy_text_key (&pJob->key, &key);
+	pJob->description = *pTextDescription;
+	pJob->description.cFont = NULL;
+	pJob->description.fd = (pTextDescription->fd ? pango_font_description_copy (pTextDescription->fd) : NULL);
+	_snapshot_style_colors (&pJob->colors);
+	const cairo_font_options_t *pFontOptions = gdk_screen_get_font_options (gdk_screen_get_default ());
+	pJob->pFontOptions = (pFontOptions ? cairo_font_options_copy (pFontOptions) : NULL);
+	pJob->iStyleStamp = gldi_style_colors_get_stamp ();
+	pRequest->pJob = pJob;
+	pJob->pRequests = g_list_append (NULL, pRequest);
+	
+	g_hash_table_insert (s_pPendingTextJobs, &pJob->key, pJob);
+	g_thread_pool_push (s_pTextThreadPool, pJob, NULL);
+	return pRequest;
+}
+
+void cairo_dock_cancel_text_surface_request (CairoDockTextSurfaceRequest *pRequest)
+{
+	g_return_if_fail (pRequest != NULL);
+	CDTextJob *pJob = pRequest->pJob;
+	if (pJob == NULL)  // its callback is being called.
+		return;
+	pJob->pRequests = g_list_remove (pJob->pRequests, pRequest);  // the job itself goes on, its surface will go into the cache.
+	g_free (pRequest);
+}
+
+
 cairo_surface_t * cairo_dock_duplicate_surface (cairo_surface_t *pSurface, double fWidth, double fHeight, double fDesiredWidth, double fDesiredHeight)
 {
 	g_return_val_if_fail (pSurface != NULL, NULL);
@@ -100,6 +100,10 @@ cairo_surface_t *cairo_dock_create_surface_from_pixbuf (GdkPixbuf *pixbuf, doubl
 */
 cairo_surface_t *cairo_dock_create_blank_surface (int iWidth, int iHeight);
 
+/** Make the surfaces created by the current thread mere image surfaces. It has to be called by a worker thread before it creates any surface, since only the main thread can use the containers.
+*/
+void cairo_dock_use_image_surfaces_in_this_thread (void);
+
 /** Create a surface from any image.
 *@param cImagePath complete path to the image.
 *@param fMaxScale maximum zoom of the icon.
@@ -176,6 +180,48 @@ cairo_surface_t *cairo_dock_create_surface_from_text_full (const gchar *cText, G
 */
 #define cairo_dock_create_surface_from_text(cText, pLabelDescription, iTextWidthPtr, iTextHeightPtr) cairo_dock_create_surface_from_text_full (cText, pLabelDescription, 1., 0, iTextWidthPtr, iTextHeightPtr) 
 
+/** Same as \ref cairo_dock_create_surface_from_text_full, but the surface is looked up in a cache first, and kept in it once drawn. The cache is bounded, the least recently used texts are dropped first, and it is invalidated when the global style changes. Use it for texts that are drawn again and again (labels, quick-infos).
+*@param cText the text.
+*@param pLabelDescription description of the text rendering.
+*@param fMaxScale maximum zoom of the text.
+*@param iMaxWidth maximum authorized width for the surface; it will be zoomed in to fits this limit. 0 for no limit.
+*@param iTextWidth will be filled the width of the resulting surface.
+*@param iTextHeight will be filled the height of the resulting surface.
+*@return a reference on the surface, to be released with cairo_surface_destroy. The surface may be shared, so it must not be drawn on.
+*/
+cairo_surface_t *cairo_dock_create_surface_from_text_cached (const gchar *cText, GldiTextDescription *pLabelDescription, double fMaxScale, int iMaxWidth, int *iTextWidth, int *iTextHeight);
+
+/** Empty the cache of text surfaces. Surfaces still in use are not destroyed.
+*/
+void cairo_dock_reset_text_surface_cache (void);
+
+/** Get some statistics about the cache of text surfaces.
+*@param iNbHits will be filled with the number of texts found in the cache, or NULL
+*@param iNbMisses will be filled with the number of texts that had to be drawn, or NULL
+*@param iNbEntries will be filled with the current number of surfaces in the cache, or NULL
+*/
+void cairo_dock_get_text_surface_cache_stats (guint *iNbHits, guint *iNbMisses, guint *iNbEntries);
+
+/// Definition of the callback called when a text surface is ready. The callback takes the surface (NULL if it couldn't be drawn); it may be shared, so it must not be drawn on.
+typedef void (*CairoDockTextSurfaceReadyFunc) (cairo_surface_t *pSurface, int iWidth, int iHeight, gpointer data);
+typedef struct _CairoDockTextSurfaceRequest CairoDockTextSurfaceRequest;
+
+/** Same as \ref cairo_dock_create_surface_from_text_cached, but the text is laid out and drawn in a separate thread, and the callback is called in the main thread once the surface is ready. Identical texts requested at the same time are drawn only once.
+*@param cText the text.
+*@param pLabelDescription description of the text rendering.
+*@param fMaxScale maximum zoom of the text.
+*@param iMaxWidth maximum authorized width for the surface; it will be zoomed in to fits this limit. 0 for no limit.
+*@param pCallback function called with the surface.
+*@param data data passed to the callback.
+*@return a request that can be cancelled with \ref cairo_dock_cancel_text_surface_request until the callback is called, or NULL if the callback has already been called (the text was already available).
+*/
+CairoDockTextSurfaceRequest *cairo_dock_create_surface_from_text_async (const gchar *cText, GldiTextDescription *pLabelDescription, double fMaxScale, int iMaxWidth, CairoDockTextSurfaceReadyFunc pCallback, gpointer data);
+
+/** Cancel a request made with \ref cairo_dock_create_surface_from_text_async; the callback won't be called.
+*@param pRequest the request.
+*/
+void cairo_dock_cancel_text_surface_request (CairoDockTextSurfaceRequest *pRequest);
+
 /** Create a surface identical to another, possibly resizing it.
 *@param pSurface surface to duplicate.
 *@param fWidth the width of the surface.
@@ -28,6 +28,8 @@
 #include "cairo-dock-launcher-manager.h"
 #include "cairo-dock-stack-icon-manager.h"
 #include "cairo-dock-separator-manager.h"
+#include "cairo-dock-class-manager.h"  // cairo_dock_parse_class_desktop_file
+#include "cairo-dock-icon-manager.h"  // gldi_icons_load_images
 #define _MANAGER_DEF_
 #include "cairo-dock-user-icon-manager.h"
 
@@ -38,14 +40,20 @@ GldiObjectManager myUserIconObjectMgr;
 extern gchar *g_cCurrentLaunchersPath;
 
 // private
+#define CD_MAX_LOADING_THREADS 4
+static int s_iMaxLoadingThreads = CD_MAX_LOADING_THREADS;
+static guint s_iNbLoadedIcons = 0;  // statistics of the last loading of the launchers directory.
+static int s_iNbLoadingThreads = 0;
+static double s_fLoadingTime = 0;  // in ms
 
+typedef struct {
+	gchar *cFileName;
+	GKeyFile *pKeyFile;  // filled by a worker thread
+	} CDUserIconFile;
 
-Icon *gldi_user_icon_new (const gchar *cConfFile)
+
+static Icon *_user_icon_new (const gchar *cConfFile, GKeyFile *pKeyFile)  // takes the key-file
 {
-	gchar *cDesktopFilePath = g_strdup_printf ("%s/%s", g_cCurrentLaunchersPath, cConfFile);
-	GKeyFile* pKeyFile = cairo_dock_open_key_file (cDesktopFilePath);
-	g_return_val_if_fail (pKeyFile != NULL, NULL);
-	
 	Icon *pIcon = NULL;
 	
 	//\__________________ get the type of the icon
@@ -95,7 +103,8 @@ Icon *gldi_user_icon_new (const gchar *cConfFile)
 			pMgr = &mySeparatorIconObjectMgr;
 		break;
 		default:
-			cd_warning ("unknown user icon type for file %s", cDesktopFilePath);
+			cd_warning ("unknown user icon type for file %s/%s", g_cCurrentLaunchersPath, cConfFile);
+			g_key_file_free (pKeyFile);
 		return NULL;
 	}
 	
@@ -105,46 +114,146 @@ Icon *gldi_user_icon_new (const gchar *cConfFile)
 	attr.pKeyFile = pKeyFile;
 	pIcon = (Icon*)gldi_object_new (pMgr, &attr);
 	
-	g_free (cDesktopFilePath);
 	g_key_file_free (pKeyFile);
 	return pIcon;
 }
 
+Icon *gldi_user_icon_new (const gchar *cConfFile)
+{
+	gchar *cDesktopFilePath = g_strdup_printf ("%s/%s", g_cCurrentLaunchersPath, cConfFile);
+	GKeyFile* pKeyFile = cairo_dock_open_key_file (cDesktopFilePath);
+	g_free (cDesktopFilePath);
+	g_return_val_if_fail (pKeyFile != NULL, NULL);
+	
+	return _user_icon_new (cConfFile, pKeyFile);
+}
+
+
+static void _parse_class_desktop_file (GKeyFile *pKeyFile)  // worker thread
+{
+	// same search as the launcher manager: the origins one by one, or else the class guessed from the command.
+	gchar **pOrigins = g_key_file_get_string_list (pKeyFile, "Desktop Entry", "Origin", NULL, NULL);
+	gboolean bFound = FALSE;
+	int i;
+	for (i = 0; pOrigins != NULL && pOrigins[i] != NULL && ! bFound; i++)
+		bFound = cairo_dock_parse_class_desktop_file (pOrigins[i]);
+	g_strfreev (pOrigins);
+	if (! bFound)
+	{
+		gchar *cCommand = g_key_file_get_string (pKeyFile, "Desktop Entry", "Exec", NULL);
+		gchar *cStartupWMClass = g_key_file_get_string (pKeyFile, "Desktop Entry", "StartupWMClass", NULL);
+		gchar *cClass = cairo_dock_guess_class (cCommand, cStartupWMClass && *cStartupWMClass != '\0' ? cStartupWMClass : NULL);
+		cairo_dock_parse_class_desktop_file (cClass);
+		g_free (cClass);
+		g_free (cStartupWMClass);
+		g_free (cCommand);
+	}
+}
+
+static void _read_user_icon_file (CDUserIconFile *pFile, const gchar *cDirectory)  // worker thread
+{
+	gchar *cDesktopFilePath = g_strdup_printf ("%s/%s", cDirectory, pFile->cFileName);
+	pFile->pKeyFile = cairo_dock_open_key_file (cDesktopFilePath);
+	g_free (cDesktopFilePath);
+	
+	if (pFile->pKeyFile != NULL
+	&& (g_key_file_has_key (pFile->pKeyFile, "Desktop Entry", "Origin", NULL) || g_key_file_has_key (pFile->pKeyFile, "Desktop Entry", "Exec", NULL)))  // a launcher (or an old file), its class will be registered.
+		_parse_class_desktop_file (pFile->pKeyFile);
+}
 
 void gldi_user_icons_new_from_directory (const gchar *cDirectory)
 {
 	cd_message ("%s (%s)", __func__, cDirectory);
 	GDir *dir = g_dir_open (cDirectory, 0, NULL);
 	g_return_if_fail (dir != NULL);
+	gint64 iStartTime = g_get_monotonic_time ();
 	
-	Icon* icon;
+	//\__________________ list the launchers.
+	GArray *pFiles = g_array_new (FALSE, TRUE, sizeof (CDUserIconFile));
+	CDUserIconFile file;
 	const gchar *cFileName;
-	CairoDock *pParentDock;
-
 	while ((cFileName = g_dir_read_name (dir)) != NULL)
 	{
 		if (g_str_has_suffix (cFileName, ".desktop"))
 		{
-			icon = gldi_user_icon_new (cFileName);
-			if (icon == NULL || icon->cDesktopFileName == NULL)  // if the icon couldn't be loaded, remove it from the theme (it's useless to try and fail to load it each time).
-			{
-				if (icon)
-					gldi_object_unref (GLDI_OBJECT(icon));
-				cd_warning ("Unable to load a valid icon from '%s/%s'; the file is either unreadable, unvalid or does not correspond to any installed program, and will be deleted", g_cCurrentLaunchersPath, cFileName);
-				gchar *cDesktopFilePath = g_strdup_printf ("%s/%s", g_cCurrentLaunchersPath, cFileName);
-				cairo_dock_delete_conf_file (cDesktopFilePath);
-				g_free (cDesktopFilePath);
-				continue;
-			}
-			
+			file.cFileName = g_strdup (cFileName);
+			file.pKeyFile = NULL;
+			g_array_append_val (pFiles, file);
+		}
+	}
+	g_dir_close (dir);
+	
+	//\__________________ read and parse their files and the files of their classes in parallel; the icons and the classes are made in the main thread.
+	CDUserIconFile *pFile;
+	guint i;
+	int iNbThreads = 1;
+	#if GLIB_CHECK_VERSION (2, 36, 0)
+	iNbThreads = MAX (1, MIN (s_iMaxLoadingThreads, (int)g_get_num_processors ()));
+	#endif
+	cairo_dock_begin_parsing_class_desktop_files ();
+	GThreadPool *pPool = (iNbThreads > 1 && pFiles->len > 1 ? g_thread_pool_new ((GFunc)_read_user_icon_file, (gpointer)cDirectory, iNbThreads, TRUE, NULL) : NULL);
+	for (i = 0; i < pFiles->len; i ++)
+	{
+		pFile = &g_array_index (pFiles, CDUserIconFile, i);
+		if (pPool == NULL || ! g_thread_pool_push (pPool, pFile, NULL))
+			_read_user_icon_file (pFile, cDirectory);
+	}
+	if (pPool != NULL)
+		g_thread_pool_free (pPool, FALSE, TRUE);  // wait for all the files to be read.
+	
+	//\__________________ make the icons and insert them, in the order of the directory.
+	Icon* icon;
+	CairoDock *pParentDock;
+	GList *pIcons = NULL;
+	cairo_dock_begin_resize_transaction ();  // the docks are resized once, when all the launchers are inserted.
+	for (i = 0; i < pFiles->len; i ++)
+	{
+		pFile = &g_array_index (pFiles, CDUserIconFile, i);
+		icon = (pFile->pKeyFile != NULL ? _user_icon_new (pFile->cFileName, pFile->pKeyFile) : NULL);
+		if (icon == NULL || icon->cDesktopFileName == NULL)  // if the icon couldn't be loaded, remove it from the theme (it's useless to try and fail to load it each time).
+		{
+			if (icon)
+				gldi_object_unref (GLDI_OBJECT(icon));
+			cd_warning ("Unable to load a valid icon from '%s/%s'; the file is either unreadable, unvalid or does not correspond to any installed program, and will be deleted", g_cCurrentLaunchersPath, pFile->cFileName);
+			gchar *cDesktopFilePath = g_strdup_printf ("%s/%s", g_cCurrentLaunchersPath, pFile->cFileName);
+			cairo_dock_delete_conf_file (cDesktopFilePath);
+			g_free (cDesktopFilePath);
+		}
+		else
+		{
 			pParentDock = gldi_dock_get (icon->cParentDockName);
 			if (pParentDock != NULL)  // a priori toujours vrai.
 			{
 				gldi_icon_insert_in_container (icon, CAIRO_CONTAINER(pParentDock), ! CAIRO_DOCK_ANIMATE_ICON);
+				pIcons = g_list_prepend (pIcons, icon);
 			}
 		}
+		g_free (pFile->cFileName);
 	}
-	g_dir_close (dir);
+	cairo_dock_commit_resize_transaction ();
+	cairo_dock_end_parsing_class_desktop_files ();
+	
+	//\__________________ load their images in parallel too, now that they have their size.
+	pIcons = g_list_reverse (pIcons);
+	gldi_icons_load_images (pIcons, iNbThreads);
+	g_list_free (pIcons);
+	
+	s_iNbLoadedIcons = pFiles->len;
+	s_iNbLoadingThreads = iNbThreads;
+	s_fLoadingTime = (g_get_monotonic_time () - iStartTime) / 1e3;
+	g_array_free (pFiles, TRUE);
+}
+
+void gldi_user_icons_set_max_loading_threads (int iNbThreads)
+{
+	s_iMaxLoadingThreads = MAX (1, iNbThreads);
+}
+
+void gldi_user_icons_get_loading_stats (guint *iNbIcons, int *iNbThreads, double *fTime)
+{
+	*iNbIcons = s_iNbLoadedIcons;
+	*iNbThreads = s_iNbLoadingThreads;
+	*fTime = s_fLoadingTime;
 }
 
 
@@ -73,6 +73,18 @@ Icon *gldi_user_icon_new (const gchar *cConfFile);
 
 void gldi_user_icons_new_from_directory (const gchar *cDirectory);
 
+/** Set the maximum number of threads used to load the launchers of a directory (4 by default, and at most the number of processors).
+*@param iNbThreads number of threads, 1 to load the launchers in the main thread only.
+*/
+void gldi_user_icons_set_max_loading_threads (int iNbThreads);
+
+/** Get some statistics about the last loading of a launchers directory.
+*@param iNbIcons returns the number of launchers' files.
+*@param iNbThreads returns the number of threads that were used.
+*@param fTime returns the time it took, in ms, until the launchers were inserted in their docks with their images.
+*/
+void gldi_user_icons_get_loading_stats (guint *iNbIcons, int *iNbThreads, double *fTime);
+
 
 void gldi_register_user_icons_manager (void);
 
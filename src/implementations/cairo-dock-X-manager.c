@@ -27,6 +27,7 @@
 #define __USE_POSIX
 #include <signal.h>
 #include <sys/select.h>
+#include <sys/resource.h>  // getrusage
 
 #include <cairo.h>
 #include <gdk/gdk.h>
@@ -38,6 +39,9 @@
 #include <X11/Xutil.h>
 #include <X11/extensions/Xcomposite.h>
 #include <X11/XKBlib.h>  // we should check for XkbQueryExtension...
+#ifdef HAVE_XI2
+#include <X11/extensions/XInput2.h>  // XI_RawMotion
+#endif
 
 #include "cairo-dock-utils.h"
 #include "cairo-dock-log.h"
@@ -91,6 +95,11 @@ static int s_iNumWindow = 1;  // used to order appli icons by age (=creation dat
 static Window s_iCurrentActiveWindow = 0;
 static guint num_lock_mask=0, caps_lock_mask=0, scroll_lock_mask=0;
 static GPollFD s_poll_fd;
+static FILE *s_pRecordFile = NULL;  // where the X events are recorded, if CAIRO_DOCK_RECORD_XEVENTS is set.
+static gint64 s_iRecordStartTime = 0;
+#ifdef HAVE_XI2
+static int s_iXIOpcode = -1;
+#endif
 
 typedef enum {
 	X_DEMANDS_ATTENTION = (1<<0),
@@ -355,373 +364,843 @@ static void lookup_ignorable_modifiers (void)
 	scroll_lock_mask = XkbKeysymToModifiers (s_XDisplay, GDK_KEY_Scroll_Lock);
 }
 
-static gboolean _cairo_dock_unstack_Xevents (G_GNUC_UNUSED gpointer data)
+// process an event; return TRUE if it's a motion of the pointer, which is notified once per batch of events.
+static gboolean _cairo_dock_process_Xevent (XEvent *pEvent, Window root)
 {
-	static XEvent event;
-	
-	if (!g_pPrimaryContainer)  // peut arriver en cours de chargement d'un theme.
-		return TRUE;
-	
-	Window Xid;
-	Window root = DefaultRootWindow (s_XDisplay);
-	
-	// read the messages on the fd, and put them in the event queue
-	int i, nb_msg = XEventsQueued (s_XDisplay, QueuedAfterReading);
-	//g_print ("%d X msg\n", nb_msg);
+	Window Xid = pEvent->xany.window;
 	
-	for (i = 0; i < nb_msg; i ++)
+	// process the event
+	if (pEvent->type == ClientMessage)  // inter-client message
 	{
-		// get the next event in the queue
-		XNextEvent (s_XDisplay, &event);
-		Xid = event.xany.window;
-		//g_print (" %d) type : %d; atom : %s; window : %d\n", i, event.type, XGetAtomName (s_XDisplay, event.xproperty.atom), Xid);
+		cd_debug ("+ message: %s (%ld/%ld)", XGetAtomName (s_XDisplay, pEvent->xclient.message_type), Xid, root);
 		
-		// process the event
-		if (event.type == ClientMessage)  // inter-client message
+		// make a new message or get the existing one from previous startup events on this window
+		GString *pMsg = NULL;
+		if (pEvent->xclient.message_type == s_aNetStartupInfoBegin)
 		{
-			cd_debug ("+ message: %s (%ld/%ld)", XGetAtomName (s_XDisplay, event.xclient.message_type), Xid, root);
-			
-			// make a new message or get the existing one from previous startup events on this window
-			GString *pMsg = NULL;
-			if (event.xclient.message_type == s_aNetStartupInfoBegin)
+			if (strncmp (&pEvent->xclient.data.b[0], "remove:", 7) == 0)  // ignore 'new:' and 'change:' messages
 			{
-				if (strncmp (&event.xclient.data.b[0], "remove:", 7) == 0)  // ignore 'new:' and 'change:' messages
-				{
-					pMsg = g_string_sized_new (128);
-					
-					Window *pXid = g_new (Window, 1);
-					*pXid = Xid;
-					g_hash_table_insert (s_hXClientMessageTable, pXid, pMsg);
-				}
-			}
-			else if (event.xclient.message_type == s_aNetStartupInfo)
-			{
-				pMsg = g_hash_table_lookup (s_hXClientMessageTable, &Xid);
+				pMsg = g_string_sized_new (128);
+				
+				Window *pXid = g_new (Window, 1);
+				*pXid = Xid;
+				g_hash_table_insert (s_hXClientMessageTable, pXid, pMsg);
 			}
+		}
+		else if (pEvent->xclient.message_type == s_aNetStartupInfo)
+		{
+			pMsg = g_hash_table_lookup (s_hXClientMessageTable, &Xid);
+		}
+		
+		// if a startup message is available, take it into account
+		if (pMsg)
+		{
+			// append the new data to the message
+			g_string_append_len (pMsg, &pEvent->xclient.data.b[0], 20);
+			
+			// check if the messge is complete
+			int i = 0;
+			while (i < 20 && pEvent->xclient.data.b[i] != '\0')
+				i ++;
 			
-			// if a startup message is available, take it into account
-			if (pMsg)
+			// if it is, parse it
+			if (i < 20)  // this event is the end of the message => it's complete; we should have something like: 'remove ID="id-value"'
 			{
-				// append the new data to the message
-				g_string_append_len (pMsg, &event.xclient.data.b[0], 20);
-				
-				// check if the messge is complete
-				int i = 0;
-				while (i < 20 && event.xclient.data.b[i] != '\0')
-					i ++;
-				
-				// if it is, parse it
-				if (i < 20)  // this event is the end of the message => it's complete; we should have something like: 'remove ID="id-value"'
+				cd_debug (" => message: %s", pMsg->str);
+				// look for the ID key
+				gchar *str = NULL;
+				do  // look for "ID *="
 				{
-					cd_debug (" => message: %s", pMsg->str);
-					// look for the ID key
-					gchar *str = NULL;
-					do  // look for "ID *="
-					{
-						str = strstr (pMsg->str, "ID");
-						if (str)
-						{
-							str += 2;
-							while (*str == ' ') str++;
-							if (*str == '=')
-							{
-								str ++;
-								break;
-							}
-						}
-						str = NULL;
-					}
-					while(1);
-					
+					str = strstr (pMsg->str, "ID");
 					if (str)
 					{
-						// extract the ID value
+						str += 2;
 						while (*str == ' ') str++;
-						gboolean quoted = (*str == '"');
-						if (quoted)
-							str ++;
-						gchar *id_end = str+1;
-						// We can have: ID="gldi-atom\ shell-2", with a whitespace... yes
-						if (quoted)
+						if (*str == '=')
 						{
-							// we need to remove '\' and '"'
-							gchar *withoutChar = id_end;
-							while (*id_end != '\0' && *id_end != '"')
-							{
-								*withoutChar = *id_end;
-								if (*withoutChar != '\\')
-									withoutChar ++;
-								id_end ++;
-							}
-							/* id_end should be at the '"' char but because we
-							 * have moved all char if we found '\', the new end
-							 * is at the position of withoutChar
-							 */
-							*withoutChar = '\0';
+							str ++;
+							break;
 						}
-						else
+					}
+					str = NULL;
+				}
+				while(1);
+				
+				if (str)
+				{
+					// extract the ID value
+					while (*str == ' ') str++;
+					gboolean quoted = (*str == '"');
+					if (quoted)
+						str ++;
+					gchar *id_end = str+1;
+					// We can have: ID="gldi-atom\ shell-2", with a whitespace... yes
+					if (quoted)
+					{
+						// we need to remove '\' and '"'
+						gchar *withoutChar = id_end;
+						while (*id_end != '\0' && *id_end != '"')
 						{
-							while (*id_end != '\0' && *id_end != ' ')
-								id_end ++;
-							*id_end = '\0';
+							*withoutChar = *id_end;
+							if (*withoutChar != '\\')
+								withoutChar ++;
+							id_end ++;
 						}
-						cd_debug (" => ID: %s", str);
+						/* id_end should be at the '"' char but because we
+						 * have moved all char if we found '\', the new end
+						 * is at the position of withoutChar
+						 */
+						*withoutChar = '\0';
+					}
+					else
+					{
+						while (*id_end != '\0' && *id_end != ' ')
+							id_end ++;
+						*id_end = '\0';
+					}
+					cd_debug (" => ID: %s", str);
 
-						// extract the class if it's one of our ID
-						if (strncmp (str, "gldi-", 5) == 0)  // we built this ID => it has the class inside
-						{
-							str += 5;
-							id_end = strrchr (str, '-');
-							if (id_end)
-								*id_end = '\0';
-							cd_debug (" => class: %s", str);
-							// notify the class about the end of the launching
-							gldi_class_startup_notify_end (str);
-						}
+					// extract the class if it's one of our ID
+					if (strncmp (str, "gldi-", 5) == 0)  // we built this ID => it has the class inside
+					{
+						str += 5;
+						id_end = strrchr (str, '-');
+						if (id_end)
+							*id_end = '\0';
+						cd_debug (" => class: %s", str);
+						// notify the class about the end of the launching
+						gldi_class_startup_notify_end (str);
 					}
-					
-					// destroy this message
-					g_hash_table_remove (s_hXClientMessageTable, &Xid);
 				}
+				
+				// destroy this message
+				g_hash_table_remove (s_hXClientMessageTable, &Xid);
 			}
 		}
-		else if (event.type == MappingNotify)  // keymap changed (this event is always sent to all clients)
-		{
-			gldi_object_notify (&myDesktopMgr, NOTIFICATION_KEYMAP_CHANGED, FALSE);
-			lookup_ignorable_modifiers ();
-			gldi_object_notify (&myDesktopMgr, NOTIFICATION_KEYMAP_CHANGED, TRUE);
-		}
-		else if (Xid == root)  // event on the desktop
+	}
+	#ifdef HAVE_XI2
+	else if (pEvent->type == GenericEvent)  // its window is not defined.
+	{
+		if (pEvent->xcookie.extension == s_iXIOpcode && pEvent->xcookie.evtype == XI_RawMotion)  // we don't need the event's data.
+			return TRUE;  // the pointer sends a lot of them, only notify once.
+	}
+	#endif
+	else if (pEvent->type == MappingNotify)  // keymap changed (this event is always sent to all clients)
+	{
+		gldi_object_notify (&myDesktopMgr, NOTIFICATION_KEYMAP_CHANGED, FALSE);
+		lookup_ignorable_modifiers ();
+		gldi_object_notify (&myDesktopMgr, NOTIFICATION_KEYMAP_CHANGED, TRUE);
+	}
+	else if (Xid == root)  // event on the desktop
+	{
+		if (pEvent->type == PropertyNotify)
 		{
-			if (event.type == PropertyNotify)
+			if (pEvent->xproperty.atom == s_aNetClientList)  // the stack order has changed: it's either because a window z-order has changed, or  a window disappeared (destroyed or hidden), or a window appeared.
 			{
-				if (event.xproperty.atom == s_aNetClientList)  // the stack order has changed: it's either because a window z-order has changed, or  a window disappeared (destroyed or hidden), or a window appeared.
-				{
-					_on_update_applis_list ();
-				}
-				else if (event.xproperty.atom == s_aNetActiveWindow)
+				_on_update_applis_list ();
+			}
+			else if (pEvent->xproperty.atom == s_aNetActiveWindow)
+			{
+				Window XActiveWindow = cairo_dock_get_active_xwindow ();
+				
+				gboolean bForceKbdStateRefresh = FALSE;
+				if (XActiveWindow != s_iCurrentActiveWindow)
 				{
-					Window XActiveWindow = cairo_dock_get_active_xwindow ();
-					
-					gboolean bForceKbdStateRefresh = FALSE;
-					if (XActiveWindow != s_iCurrentActiveWindow)
+					if (s_iCurrentActiveWindow == None)
+						bForceKbdStateRefresh = TRUE;
+					s_iCurrentActiveWindow = XActiveWindow;
+					GldiXWindowActor *xactor = g_hash_table_lookup (s_hXWindowTable, &XActiveWindow);
+					gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_ACTIVATED, xactor && ! xactor->bIgnored ? xactor : NULL);
+					if (bForceKbdStateRefresh)
 					{
-						if (s_iCurrentActiveWindow == None)
-							bForceKbdStateRefresh = TRUE;
-						s_iCurrentActiveWindow = XActiveWindow;
-						GldiXWindowActor *xactor = g_hash_table_lookup (s_hXWindowTable, &XActiveWindow);
-						gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_ACTIVATED, xactor && ! xactor->bIgnored ? xactor : NULL);
-						if (bForceKbdStateRefresh)
-						{
-							// si on active une fenetre n'ayant pas de focus clavier, on n'aura pas d'evenement kbd_changed, pourtant en interne le clavier changera. du coup si apres on revient sur une fenetre qui a un focus clavier, il risque de ne pas y avoir de changement de clavier, et donc encore une fois pas d'evenement ! pour palier a ce, on considere que les fenetres avec focus clavier sont celles presentes en barre des taches. On decide de generer un evenement lorsqu'on revient sur une fenetre avec focus, a partir d'une fenetre sans focus (mettre a jour le clavier pour une fenetre sans focus n'a pas grand interet, autant le laisser inchange).
-							gldi_object_notify (&myDesktopMgr, NOTIFICATION_KBD_STATE_CHANGED, xactor);
-						}
+						// si on active une fenetre n'ayant pas de focus clavier, on n'aura pas d'evenement kbd_changed, pourtant en interne le clavier changera. du coup si apres on revient sur une fenetre qui a un focus clavier, il risque de ne pas y avoir de changement de clavier, et donc encore une fois pas d'evenement ! pour palier a ce, on considere que les fenetres avec focus clavier sont celles presentes en barre des taches. On decide de generer un evenement lorsqu'on revient sur une fenetre avec focus, a partir d'une fenetre sans focus (mettre a jour le clavier pour une fenetre sans focus n'a pas grand interet, autant le laisser inchange).
+						gldi_object_notify (&myDesktopMgr, NOTIFICATION_KBD_STATE_CHANGED, xactor);
 					}
 				}
-				else if (event.xproperty.atom == s_aNetCurrentDesktop || event.xproperty.atom == s_aNetDesktopViewport)
-				{
-					_on_change_current_desktop_viewport ();  // -> NOTIFICATION_DESKTOP_CHANGED
-				}
-				else if (event.xproperty.atom == s_aNetNbDesktops)
-				{
-					_on_change_nb_desktops ();  // -> NOTIFICATION_DESKTOP_GEOMETRY_CHANGED
-				}
-				else if (event.xproperty.atom == s_aNetDesktopGeometry || event.xproperty.atom == s_aNetWorkarea)  // check s_aNetWorkarea too, to workaround a bug in Compiz (or X?) : when down-sizing the screen, the _NET_DESKTOP_GEOMETRY atom is not received  (up-sizing is ok though, and changing the viewport makes the atom to be received); but _NET_WORKAREA is correctly sent; since it's only sent when the resolution is changed, or the dock's height (if space is reserved), it's not a big overload to check it too.
-				{
-					_on_change_desktop_geometry ();  // -> NOTIFICATION_DESKTOP_GEOMETRY_CHANGED
-				}
-				else if (event.xproperty.atom == s_aRootMapID)
-				{
-					gldi_object_notify (&myDesktopMgr, NOTIFICATION_DESKTOP_WALLPAPER_CHANGED);
-				}
-				else if (event.xproperty.atom == s_aNetShowingDesktop)
-				{
-					gldi_object_notify (&myDesktopMgr, NOTIFICATION_DESKTOP_VISIBILITY_CHANGED);
-				}
-				else if (event.xproperty.atom == s_aXKlavierState)
-				{
-					gldi_object_notify (&myDesktopMgr, NOTIFICATION_KBD_STATE_CHANGED, NULL);
-				}
-				else if (event.xproperty.atom == s_aNetDesktopNames)
-				{
-					gldi_object_notify (&myDesktopMgr, NOTIFICATION_DESKTOP_NAMES_CHANGED);
-				}
-			}  // end of PropertyNotify on root.
-			else if (event.type == KeyPress)
+			}
+			else if (pEvent->xproperty.atom == s_aNetCurrentDesktop || pEvent->xproperty.atom == s_aNetDesktopViewport)
+			{
+				_on_change_current_desktop_viewport ();  // -> NOTIFICATION_DESKTOP_CHANGED
+			}
+			else if (pEvent->xproperty.atom == s_aNetNbDesktops)
+			{
+				_on_change_nb_desktops ();  // -> NOTIFICATION_DESKTOP_GEOMETRY_CHANGED
+			}
+			else if (pEvent->xproperty.atom == s_aNetDesktopGeometry || pEvent->xproperty.atom == s_aNetWorkarea)  // check s_aNetWorkarea too, to workaround a bug in Compiz (or X?) : when down-sizing the screen, the _NET_DESKTOP_GEOMETRY atom is not received  (up-sizing is ok though, and changing the viewport makes the atom to be received); but _NET_WORKAREA is correctly sent; since it's only sent when the resolution is changed, or the dock's height (if space is reserved), it's not a big overload to check it too.
+			{
+				_on_change_desktop_geometry ();  // -> NOTIFICATION_DESKTOP_GEOMETRY_CHANGED
+			}
+			else if (pEvent->xproperty.atom == s_aRootMapID)
+			{
+				gldi_object_notify (&myDesktopMgr, NOTIFICATION_DESKTOP_WALLPAPER_CHANGED);
+			}
+			else if (pEvent->xproperty.atom == s_aNetShowingDesktop)
+			{
+				gldi_object_notify (&myDesktopMgr, NOTIFICATION_DESKTOP_VISIBILITY_CHANGED);
+			}
+			else if (pEvent->xproperty.atom == s_aXKlavierState)
 			{
-				guint event_mods = event.xkey.state & ~(num_lock_mask | caps_lock_mask | scroll_lock_mask);  // remove the lock masks
-				gldi_object_notify (&myDesktopMgr, NOTIFICATION_SHORTKEY_PRESSED, event.xkey.keycode, event_mods);
+				gldi_object_notify (&myDesktopMgr, NOTIFICATION_KBD_STATE_CHANGED, NULL);
 			}
+			else if (pEvent->xproperty.atom == s_aNetDesktopNames)
+			{
+				gldi_object_notify (&myDesktopMgr, NOTIFICATION_DESKTOP_NAMES_CHANGED);
+			}
+		}  // end of PropertyNotify on root.
+		else if (pEvent->type == KeyPress)
+		{
+			guint event_mods = pEvent->xkey.state & ~(num_lock_mask | caps_lock_mask | scroll_lock_mask);  // remove the lock masks
+			gldi_object_notify (&myDesktopMgr, NOTIFICATION_SHORTKEY_PRESSED, pEvent->xkey.keycode, event_mods);
 		}
-		else  // event on a window.
+	}
+	else  // event on a window.
+	{
+		GldiXWindowActor *xactor = g_hash_table_lookup (s_hXWindowTable, &Xid);
+		GldiWindowActor *actor = (GldiWindowActor*)xactor;
+		if (! actor)
+			return FALSE;
+		
+		if (pEvent->type == PropertyNotify)
 		{
-			GldiXWindowActor *xactor = g_hash_table_lookup (s_hXWindowTable, &Xid);
-			GldiWindowActor *actor = (GldiWindowActor*)xactor;
-			if (! actor)
-				continue;
-			
-			if (event.type == PropertyNotify)
+			if (pEvent->xproperty.atom == s_aXKlavierState)
 			{
-				if (event.xproperty.atom == s_aXKlavierState)
-				{
-					gldi_object_notify (&myDesktopMgr, NOTIFICATION_KBD_STATE_CHANGED, actor);
-				}
-				else if (event.xproperty.atom == s_aNetWmState)
-				{
-					// get current state
-					gboolean bIsFullScreen, bIsHidden, bIsMaximized, bDemandsAttention;
-					gboolean bSkipTaskbar = ! cairo_dock_xwindow_is_fullscreen_or_hidden_or_maximized (Xid, &bIsFullScreen, &bIsHidden, &bIsMaximized, &bDemandsAttention);
-					
-					// special case where a window enters/leaves the taskbar
-					if (bSkipTaskbar != xactor->bIgnored)
-					{
-						if (xactor->bIgnored)  // was ignored, simply recreate it
-						{
-							// remove it from the table, so that the XEvent loop detects it again
-							g_hash_table_remove (s_hXWindowTable, &Xid);  // remove it explicitely, because the 'unref' might not free it
-							xactor->iLastCheckTime = -1;
-							_delete_actor (xactor);  // unref it since we don't need it anymore
-						}
-						else  // is now ignored
-						{
-							xactor->bIgnored = bSkipTaskbar;
-							gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_DESTROYED, actor);
-						}
-						continue;  // actor is either freeed or ignored
-					}
-					
-					if (xactor->bIgnored)  // skip taskbar
-						continue;
-					// update the actor
-					gboolean bHiddenChanged     = (bIsHidden != actor->bIsHidden);
-					gboolean bMaximizedChanged  = (bIsMaximized != actor->bIsMaximized);
-					gboolean bFullScreenChanged = (bIsFullScreen != actor->bIsFullScreen);
-					actor->bIsHidden     = bIsHidden;
-					actor->bIsMaximized  = bIsMaximized;
-					actor->bIsFullScreen = bIsFullScreen;
-					if (bHiddenChanged && ! bIsHidden)  // the window is now mapped => BackingPixmap is available.
-						_update_backing_pixmap (xactor);
-					
-					// notify everybody
-					if (bDemandsAttention)
-						_set_demand_attention (xactor, X_DEMANDS_ATTENTION);  // -> NOTIFICATION_WINDOW_ATTENTION_CHANGED
-					else
-						_unset_demand_attention (xactor, X_DEMANDS_ATTENTION);  // -> NOTIFICATION_WINDOW_ATTENTION_CHANGED
-					gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_STATE_CHANGED, actor, bHiddenChanged, bMaximizedChanged, bFullScreenChanged);
-				}
-				else if (event.xproperty.atom == s_aNetWmDesktop)
-				{
-					if (xactor->bIgnored)  // skip taskbar
-						continue;
-					// update the actor
-					actor->iNumDesktop = cairo_dock_get_xwindow_desktop (Xid);
-					
-					// notify everybody
-					gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_DESKTOP_CHANGED, actor);
-				}
-				else if (event.xproperty.atom == s_aWmName
-				|| event.xproperty.atom == s_aNetWmName)
-				{
-					if (xactor->bIgnored)  // skip taskbar
-						continue;
-					// update the actor
-					g_free (actor->cName);
-					actor->cName = cairo_dock_get_xwindow_name (Xid, event.xproperty.atom == s_aWmName);
-					// notify everybody
-					gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_NAME_CHANGED, actor);
-				}
-				else if (event.xproperty.atom == s_aWmHints)
+				gldi_object_notify (&myDesktopMgr, NOTIFICATION_KBD_STATE_CHANGED, actor);
+			}
+			else if (pEvent->xproperty.atom == s_aNetWmState)
+			{
+				// get current state
+				gboolean bIsFullScreen, bIsHidden, bIsMaximized, bDemandsAttention;
+				gboolean bSkipTaskbar = ! cairo_dock_xwindow_is_fullscreen_or_hidden_or_maximized (Xid, &bIsFullScreen, &bIsHidden, &bIsMaximized, &bDemandsAttention);
+				
+				// special case where a window enters/leaves the taskbar
+				if (bSkipTaskbar != xactor->bIgnored)
 				{
-					if (xactor->bIgnored)  // skip taskbar
-						continue;
-					// get the hints
-					XWMHints *pWMHints = XGetWMHints (s_XDisplay, Xid);
-					if (pWMHints != NULL)
+					if (xactor->bIgnored)  // was ignored, simply recreate it
 					{
-						// notify everybody
-						if (pWMHints->flags & XUrgencyHint)  // urgency flag is set
-							_set_demand_attention (xactor, X_URGENCY_HINT);  // -> NOTIFICATION_WINDOW_ATTENTION_CHANGED
-						else
-							_unset_demand_attention (xactor, X_URGENCY_HINT);  // -> NOTIFICATION_WINDOW_ATTENTION_CHANGED
-						
-						if (event.xproperty.state == PropertyNewValue && (pWMHints->flags & (IconPixmapHint | IconMaskHint | IconWindowHint)))
-						{
-							gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_ICON_CHANGED, actor);
-						}
-						XFree (pWMHints);
+						// remove it from the table, so that the XEvent loop detects it again
+						g_hash_table_remove (s_hXWindowTable, &Xid);  // remove it explicitely, because the 'unref' might not free it
+						xactor->iLastCheckTime = -1;
+						_delete_actor (xactor);  // unref it since we don't need it anymore
 					}
-					else  // no hints set on this window, assume it unsets the urgency flag
+					else  // is now ignored
 					{
-						_unset_demand_attention (xactor, X_URGENCY_HINT);  // -> NOTIFICATION_WINDOW_ATTENTION_CHANGED
+						xactor->bIgnored = bSkipTaskbar;
+						gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_DESTROYED, actor);
 					}
+					return FALSE;  // actor is either freeed or ignored
 				}
-				else if (event.xproperty.atom == s_aNetWmIcon)
+				
+				if (xactor->bIgnored)  // skip taskbar
+					return FALSE;
+				// update the actor
+				gboolean bHiddenChanged     = (bIsHidden != actor->bIsHidden);
+				gboolean bMaximizedChanged  = (bIsMaximized != actor->bIsMaximized);
+				gboolean bFullScreenChanged = (bIsFullScreen != actor->bIsFullScreen);
+				actor->bIsHidden     = bIsHidden;
+				actor->bIsMaximized  = bIsMaximized;
+				actor->bIsFullScreen = bIsFullScreen;
+				if (bHiddenChanged && ! bIsHidden)  // the window is now mapped => BackingPixmap is available.
+					_update_backing_pixmap (xactor);
+				
+				// notify everybody
+				if (bDemandsAttention)
+					_set_demand_attention (xactor, X_DEMANDS_ATTENTION);  // -> NOTIFICATION_WINDOW_ATTENTION_CHANGED
+				else
+					_unset_demand_attention (xactor, X_DEMANDS_ATTENTION);  // -> NOTIFICATION_WINDOW_ATTENTION_CHANGED
+				gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_STATE_CHANGED, actor, bHiddenChanged, bMaximizedChanged, bFullScreenChanged);
+			}
+			else if (pEvent->xproperty.atom == s_aNetWmDesktop)
+			{
+				if (xactor->bIgnored)  // skip taskbar
+					return FALSE;
+				// update the actor
+				actor->iNumDesktop = cairo_dock_get_xwindow_desktop (Xid);
+				
+				// notify everybody
+				gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_DESKTOP_CHANGED, actor);
+			}
+			else if (pEvent->xproperty.atom == s_aWmName
+			|| pEvent->xproperty.atom == s_aNetWmName)
+			{
+				if (xactor->bIgnored)  // skip taskbar
+					return FALSE;
+				// update the actor
+				g_free (actor->cName);
+				actor->cName = cairo_dock_get_xwindow_name (Xid, pEvent->xproperty.atom == s_aWmName);
+				// notify everybody
+				gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_NAME_CHANGED, actor);
+			}
+			else if (pEvent->xproperty.atom == s_aWmHints)
+			{
+				if (xactor->bIgnored)  // skip taskbar
+					return FALSE;
+				// get the hints
+				XWMHints *pWMHints = XGetWMHints (s_XDisplay, Xid);
+				if (pWMHints != NULL)
 				{
-					if (xactor->bIgnored)  // skip taskbar
-						continue;
 					// notify everybody
-					gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_ICON_CHANGED, actor);
+					if (pWMHints->flags & XUrgencyHint)  // urgency flag is set
+						_set_demand_attention (xactor, X_URGENCY_HINT);  // -> NOTIFICATION_WINDOW_ATTENTION_CHANGED
+					else
+						_unset_demand_attention (xactor, X_URGENCY_HINT);  // -> NOTIFICATION_WINDOW_ATTENTION_CHANGED
+					
+					if (pEvent->xproperty.state == PropertyNewValue && (pWMHints->flags & (IconPixmapHint | IconMaskHint | IconWindowHint)))
+					{
+						gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_ICON_CHANGED, actor);
+					}
+					XFree (pWMHints);
 				}
-				else if (event.xproperty.atom == s_aWmClass)
+				else  // no hints set on this window, assume it unsets the urgency flag
 				{
-					if (xactor->bIgnored)  // skip taskbar
-						continue;
-					// update the actor
-					gchar *cOldClass = actor->cClass, *cOldWmClass = actor->cWmClass;
-					gchar *cWmClass = NULL;
-					gchar *cNewClass = cairo_dock_get_xwindow_class (Xid, &cWmClass);
-					if (! cNewClass || g_strcmp0 (cNewClass, cOldClass) == 0)
-						continue;
-					actor->cClass = cNewClass;
-					actor->cWmClass = cWmClass;
-					
-					// notify everybody
-					gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_CLASS_CHANGED, actor, cOldClass, cOldWmClass);
-					
-					g_free (cOldClass);
-					g_free (cOldWmClass);
+					_unset_demand_attention (xactor, X_URGENCY_HINT);  // -> NOTIFICATION_WINDOW_ATTENTION_CHANGED
 				}
 			}
-			else if (event.type == ConfigureNotify)
+			else if (pEvent->xproperty.atom == s_aNetWmIcon)
 			{
-				if (xactor->bIgnored)  // skip taskbar  /// TODO: don't skip if XTransientFor != 0 ?...
-					continue;
+				if (xactor->bIgnored)  // skip taskbar
+					return FALSE;
+				// notify everybody
+				gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_ICON_CHANGED, actor);
+			}
+			else if (pEvent->xproperty.atom == s_aWmClass)
+			{
+				if (xactor->bIgnored)  // skip taskbar
+					return FALSE;
 				// update the actor
-				int x = event.xconfigure.x, y = event.xconfigure.y;
-				int w = event.xconfigure.width, h = event.xconfigure.height;
-				cairo_dock_get_xwindow_geometry (Xid, &x, &y, &w, &h);
-				actor->windowGeometry.width = w;
-				actor->windowGeometry.height = h;
-				actor->windowGeometry.x = x;
-				actor->windowGeometry.y = y;
+				gchar *cOldClass = actor->cClass, *cOldWmClass = actor->cWmClass;
+				gchar *cWmClass = NULL;
+				gchar *cNewClass = cairo_dock_get_xwindow_class (Xid, &cWmClass);
+				if (! cNewClass || g_strcmp0 (cNewClass, cOldClass) == 0)
+					return FALSE;
+				actor->cClass = cNewClass;
+				actor->cWmClass = cWmClass;
 				
-				actor->iViewPortX = x / gldi_desktop_get_width() + g_desktopGeometry.iCurrentViewportX;
-				actor->iViewPortY = y / gldi_desktop_get_height() + g_desktopGeometry.iCurrentViewportY;
+				// notify everybody
+				gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_CLASS_CHANGED, actor, cOldClass, cOldWmClass);
 				
-				if (w != actor->windowGeometry.width || h != actor->windowGeometry.height)  // size has changed
+				g_free (cOldClass);
+				g_free (cOldWmClass);
+			}
+		}
+		else if (pEvent->type == ConfigureNotify)
+		{
+			if (xactor->bIgnored)  // skip taskbar  /// TODO: don't skip if XTransientFor != 0 ?...
+				return FALSE;
+			// update the actor
+			int x = pEvent->xconfigure.x, y = pEvent->xconfigure.y;
+			int w = pEvent->xconfigure.width, h = pEvent->xconfigure.height;
+			cairo_dock_get_xwindow_geometry (Xid, &x, &y, &w, &h);
+			actor->windowGeometry.width = w;
+			actor->windowGeometry.height = h;
+			actor->windowGeometry.x = x;
+			actor->windowGeometry.y = y;
+			
+			actor->iViewPortX = x / gldi_desktop_get_width() + g_desktopGeometry.iCurrentViewportX;
+			actor->iViewPortY = y / gldi_desktop_get_height() + g_desktopGeometry.iCurrentViewportY;
+			
+			if (w != actor->windowGeometry.width || h != actor->windowGeometry.height)  // size has changed
+			{
+				_update_backing_pixmap (xactor);
+			}
+			
+			// notify everybody
+			gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_SIZE_POSITION_CHANGED, actor);
+		}
+		/*else if (pEvent->type == g_iDamageEvent + XDamageNotify)
+		{
+			XDamageNotifyEvent *e = (XDamageNotifyEvent *) pEvent;
+			cd_debug ("window %s has been damaged (%d;%d %dx%d)", e->drawable, e->area.x, e->area.y, e->area.width, e->area.height);
+			// e->drawable is the window ID of the damaged window
+			// e->geometry is the geometry of the damaged window	
+			// e->area     is the bounding rect for the damaged area	
+			// e->damage   is the damage handle returned by XDamageCreate()
+			// Subtract all the damage, repairing the window.
+			XDamageSubtract (s_XDisplay, e->damage, None, None);
+		}
+		else
+			cd_debug ("  type : %d (%d); window : %d", pEvent->type, XDamageNotify, Xid);*/
+	}  // end of event
+	return FALSE;
+}
+
+  ///////////////////////
+ /// RECORD / REPLAY ///
+///////////////////////
+
+#define CD_XEVENTS_FILE_HEADER "GLDI-XEVENTS-2\n"
+
+// what follows the header of a record file.
+typedef struct {
+	gint iXIOpcode;  // the opcode of the XInput extension in the recorded session, to translate the GenericEvents.
+	} CDRecordedXSession;
+
+typedef enum {
+	CD_RECORD_XEVENT = 0,
+	CD_RECORD_XPROPERTY
+	} CDRecordType;
+
+// an event as it's stored in a record file. Atoms are only valid inside an X session, so the name of the atom carried by the event is stored along with it.
+typedef struct {
+	gint64 iTime;  // in us, since the beginning of the record
+	gchar cAtomName[64];
+	XEvent event;
+	} CDRecordedXEvent;
+
+// a property read while handling the events, followed by its data; the values of an atom-list are stored as a list of names.
+typedef struct {
+	Window Xid;
+	gchar cPropertyName[64];
+	gchar cTypeName[64];
+	gint iStatus;
+	gint iFormat;
+	gulong iNbItems;
+	gulong iLeftBytes;
+	guint iDataSize;  // number of bytes following this structure in the file
+	} CDRecordedXProperty;
+
+// a property as it's served during a replay.
+typedef struct {
+	gint iStatus;
+	Atom aType;
+	gint iFormat;
+	gulong iNbItems;
+	gulong iLeftBytes;
+	guint iDataSize;
+	guchar *pData;
+	} CDXPropertyReply;
+
+static gboolean s_bRecordProperties = FALSE;  // only the properties read while handling an event are recorded.
+static GHashTable *s_hReplayedProperties = NULL;  // table of ((Xid,property), queue of replies), while replaying.
+
+static Atom *_get_event_atom (XEvent *pEvent)
+{
+	if (pEvent->type == PropertyNotify)
+		return &pEvent->xproperty.atom;
+	if (pEvent->type == ClientMessage)
+		return &pEvent->xclient.message_type;
+	return NULL;
+}
+
+static const gchar *_get_atom_name (Atom atom)
+{
+	static GHashTable *s_hAtomNames = NULL;  // (atom, name), to avoid a round-trip to the server each time.
+	if (atom == None)
+		return "";
+	if (s_hAtomNames == NULL)
+		s_hAtomNames = g_hash_table_new_full (NULL, NULL, NULL, g_free);
+	gchar *cName = g_hash_table_lookup (s_hAtomNames, GSIZE_TO_POINTER (atom));
+	if (cName == NULL)
+	{
+		char *cXName = XGetAtomName (s_XDisplay, atom);
+		cName = g_strdup (cXName ? cXName : "");
+		if (cXName)
+			XFree (cXName);
+		g_hash_table_insert (s_hAtomNames, GSIZE_TO_POINTER (atom), cName);
+	}
+	return cName;
+}
+
+static void _write_record (CDRecordType iType, gconstpointer pRecord, gsize iSize, gconstpointer pData, gsize iDataSize)
+{
+	gint t = iType;
+	if (fwrite (&t, sizeof (gint), 1, s_pRecordFile) != 1
+	|| fwrite (pRecord, iSize, 1, s_pRecordFile) != 1
+	|| (iDataSize != 0 && fwrite (pData, iDataSize, 1, s_pRecordFile) != 1))
+	{
+		cd_warning ("couldn't record the X events any more");
+		fclose (s_pRecordFile);
+		s_pRecordFile = NULL;
+		cairo_dock_set_X_property_reader (NULL);
+	}
+}
+
+static void _record_Xevent (XEvent *pEvent)
+{
+	CDRecordedXEvent rec;
+	memset (&rec, 0, sizeof (CDRecordedXEvent));
+	rec.iTime = g_get_monotonic_time () - s_iRecordStartTime;
+	rec.event = *pEvent;
+	
+	Atom *pAtom = _get_event_atom (pEvent);
+	if (pAtom != NULL)
+		g_strlcpy (rec.cAtomName, _get_atom_name (*pAtom), sizeof (rec.cAtomName));
+	
+	_write_record (CD_RECORD_XEVENT, &rec, sizeof (CDRecordedXEvent), NULL, 0);
+}
+
+static int _read_and_record_property (Display *display, Window Xid, Atom property, long iOffset, long iLength, Bool bDelete, Atom aReqType, Atom *pType, int *pFormat, unsigned long *pNbItems, unsigned long *pLeftBytes, unsigned char **pData)
+{
+	int iStatus = XGetWindowProperty (display, Xid, property, iOffset, iLength, bDelete, aReqType, pType, pFormat, pNbItems, pLeftBytes, pData);
+	if (! s_bRecordProperties || s_pRecordFile == NULL)
+		return iStatus;
+	
+	CDRecordedXProperty rec;
+	memset (&rec, 0, sizeof (CDRecordedXProperty));
+	rec.Xid = Xid;
+	g_strlcpy (rec.cPropertyName, _get_atom_name (property), sizeof (rec.cPropertyName));
+	rec.iStatus = iStatus;
+	GString *sAtomNames = NULL;
+	if (iStatus == Success)
+	{
+		g_strlcpy (rec.cTypeName, _get_atom_name (*pType), sizeof (rec.cTypeName));
+		rec.iFormat = *pFormat;
+		rec.iNbItems = *pNbItems;
+		rec.iLeftBytes = *pLeftBytes;
+		if (*pData != NULL)
+		{
+			if (*pType == XA_ATOM && *pFormat == 32)
+			{
+				sAtomNames = g_string_new ("");
+				gulong i;
+				for (i = 0; i < *pNbItems; i ++)
 				{
-					_update_backing_pixmap (xactor);
+					g_string_append (sAtomNames, _get_atom_name (((Atom*)*pData)[i]));
+					g_string_append_c (sAtomNames, '\0');
 				}
-				
-				// notify everybody
-				gldi_object_notify (&myWindowObjectMgr, NOTIFICATION_WINDOW_SIZE_POSITION_CHANGED, actor);
+				rec.iDataSize = sAtomNames->len;
 			}
-			/*else if (event.type == g_iDamageEvent + XDamageNotify)
+			else  // Xlib gives the 32 bits items as longs.
+				rec.iDataSize = *pNbItems * (*pFormat == 32 ? sizeof (long) : *pFormat == 16 ? sizeof (short) : 1);
+		}
+	}
+	
+	_write_record (CD_RECORD_XPROPERTY, &rec, sizeof (CDRecordedXProperty), sAtomNames ? (gpointer)sAtomNames->str : (gpointer)*pData, rec.iDataSize);
+	if (sAtomNames)
+		g_string_free (sAtomNames, TRUE);
+	return iStatus;
+}
+
+static void _start_recording_Xevents (const gchar *cFilePath)
+{
+	s_pRecordFile = fopen (cFilePath, "wb");
+	if (s_pRecordFile == NULL)
+	{
+		cd_warning ("couldn't open '%s' to record the X events", cFilePath);
+		return;
+	}
+	fputs (CD_XEVENTS_FILE_HEADER, s_pRecordFile);
+	CDRecordedXSession session;
+	memset (&session, 0, sizeof (CDRecordedXSession));
+	#ifdef HAVE_XI2
+	session.iXIOpcode = s_iXIOpcode;
+	#else
+	session.iXIOpcode = -1;
+	#endif
+	fwrite (&session, sizeof (CDRecordedXSession), 1, s_pRecordFile);
+	s_iRecordStartTime = g_get_monotonic_time ();
+	cairo_dock_set_X_property_reader (_read_and_record_property);
+	cd_message ("recording the X events into '%s'", cFilePath);
+}
+
+static gint64 _make_property_key (Window Xid, Atom property)
+{
+	return ((gint64)Xid << 32) | (property & 0xFFFFFFFF);  // XIDs and atoms fit in 29 bits.
+}
+
+static void _free_property_reply (CDXPropertyReply *pReply)
+{
+	g_free (pReply->pData);
+	g_free (pReply);
+}
+
+static void _free_property_replies (GQueue *pReplies)
+{
+	g_queue_free_full (pReplies, (GDestroyNotify)_free_property_reply);
+}
+
+// serve the properties that were recorded, in the same order, so that the replay doesn't depend on the windows of the current session. When a window has no more recorded reply for a property, its last value is given again.
+static int _replay_property (G_GNUC_UNUSED Display *display, Window Xid, Atom property, G_GNUC_UNUSED long iOffset, G_GNUC_UNUSED long iLength, G_GNUC_UNUSED Bool bDelete, G_GNUC_UNUSED Atom aReqType, Atom *pType, int *pFormat, unsigned long *pNbItems, unsigned long *pLeftBytes, unsigned char **pData)
+{
+	gint64 iKey = _make_property_key (Xid, property);
+	GQueue *pReplies = g_hash_table_lookup (s_hReplayedProperties, &iKey);
+	CDXPropertyReply *pReply = (pReplies ? g_queue_peek_head (pReplies) : NULL);
+	if (pReply == NULL)  // not read in the recorded session: the property doesn't exist.
+	{
+		*pType = None;
+		*pFormat = 0;
+		*pNbItems = 0;
+		*pLeftBytes = 0;
+		*pData = NULL;
+		return Success;
+	}
+	if (pReply->iStatus != Success)
+		return pReply->iStatus;
+	
+	*pType = pReply->aType;
+	*pFormat = pReply->iFormat;
+	*pNbItems = pReply->iNbItems;
+	*pLeftBytes = pReply->iLeftBytes;
+	*pData = NULL;
+	if (pReply->pData != NULL)
+	{
+		*pData = malloc (pReply->iDataSize + 1);  // freed with XFree; like Xlib, add a '\0' after the data.
+		memcpy (*pData, pReply->pData, pReply->iDataSize);
+		(*pData)[pReply->iDataSize] = '\0';
+	}
+	
+	if (g_queue_get_length (pReplies) > 1)
+		_free_property_reply (g_queue_pop_head (pReplies));
+	return Success;
+}
+
+static Atom _intern_recorded_atom (GHashTable *pAtoms, GStringChunk *pNames, const gchar *cName)
+{
+	if (*cName == '\0')
+		return None;
+	gpointer atom;
+	if (! g_hash_table_lookup_extended (pAtoms, cName, NULL, &atom))
+	{
+		atom = GSIZE_TO_POINTER (XInternAtom (s_XDisplay, cName, False));
+		g_hash_table_insert (pAtoms, g_string_chunk_insert (pNames, cName), atom);
+	}
+	return GPOINTER_TO_SIZE (atom);
+}
+
+static gboolean _load_recorded_property (FILE *f, GHashTable *pAtoms, GStringChunk *pNames)
+{
+	CDRecordedXProperty rec;
+	if (fread (&rec, sizeof (CDRecordedXProperty), 1, f) != 1)
+		return FALSE;
+	rec.cPropertyName[sizeof (rec.cPropertyName) - 1] = '\0';
+	rec.cTypeName[sizeof (rec.cTypeName) - 1] = '\0';
+	
+	CDXPropertyReply *pReply = g_new0 (CDXPropertyReply, 1);
+	pReply->iStatus = rec.iStatus;
+	pReply->aType = _intern_recorded_atom (pAtoms, pNames, rec.cTypeName);
+	pReply->iFormat = rec.iFormat;
+	pReply->iNbItems = rec.iNbItems;
+	pReply->iLeftBytes = rec.iLeftBytes;
+	if (rec.iDataSize != 0)
+	{
+		gchar *pData = g_malloc (rec.iDataSize + 1);
+		if (fread (pData, rec.iDataSize, 1, f) != 1)
+		{
+			g_free (pData);
+			g_free (pReply);
+			return FALSE;
+		}
+		pData[rec.iDataSize] = '\0';
+		if (pReply->aType == XA_ATOM && pReply->iFormat == 32)  // translate the names into atoms of this session.
+		{
+			Atom *pAtomList = g_new0 (Atom, rec.iNbItems);
+			gchar *cName = pData;
+			gulong i;
+			for (i = 0; i < rec.iNbItems && cName < pData + rec.iDataSize; i ++)
 			{
-				XDamageNotifyEvent *e = (XDamageNotifyEvent *) &event;
-				cd_debug ("window %s has been damaged (%d;%d %dx%d)", e->drawable, e->area.x, e->area.y, e->area.width, e->area.height);
-				// e->drawable is the window ID of the damaged window
-				// e->geometry is the geometry of the damaged window	
-				// e->area     is the bounding rect for the damaged area	
-				// e->damage   is the damage handle returned by XDamageCreate()
-				// Subtract all the damage, repairing the window.
-				XDamageSubtract (s_XDisplay, e->damage, None, None);
+				pAtomList[i] = _intern_recorded_atom (pAtoms, pNames, cName);
+				cName += strlen (cName) + 1;
 			}
-			else
-				cd_debug ("  type : %d (%d); window : %d", event.type, XDamageNotify, Xid);*/
-		}  // end of event
+			g_free (pData);
+			pReply->pData = (guchar*)pAtomList;
+			pReply->iDataSize = rec.iNbItems * sizeof (Atom);
+		}
+		else
+		{
+			pReply->pData = (guchar*)pData;
+			pReply->iDataSize = rec.iDataSize;
+		}
+	}
+	
+	gint64 iKey = _make_property_key (rec.Xid, _intern_recorded_atom (pAtoms, pNames, rec.cPropertyName));
+	GQueue *pReplies = g_hash_table_lookup (s_hReplayedProperties, &iKey);
+	if (pReplies == NULL)
+	{
+		pReplies = g_queue_new ();
+		g_hash_table_insert (s_hReplayedProperties, g_memdup (&iKey, sizeof (gint64)), pReplies);
+	}
+	g_queue_push_tail (pReplies, pReply);
+	return TRUE;
+}
+
+static void _nop_window_action (G_GNUC_UNUSED GldiWindowActor *actor)
+{
+}
+static void _nop_window_move_to_nth_desktop (G_GNUC_UNUSED GldiWindowActor *actor, G_GNUC_UNUSED int iNumDesktop, G_GNUC_UNUSED int iDeltaViewportX, G_GNUC_UNUSED int iDeltaViewportY)
+{
+}
+static void _nop_window_set_state (G_GNUC_UNUSED GldiWindowActor *actor, G_GNUC_UNUSED gboolean bState)
+{
+}
+static void _nop_window_set_position (G_GNUC_UNUSED GldiWindowActor *actor, G_GNUC_UNUSED int x, G_GNUC_UNUSED int y)
+{
+}
+static void _nop_window_set_area (G_GNUC_UNUSED GldiWindowActor *actor, G_GNUC_UNUSED int x, G_GNUC_UNUSED int y, G_GNUC_UNUSED int w, G_GNUC_UNUSED int h)
+{
+}
+static cairo_surface_t* _nop_window_get_surface (G_GNUC_UNUSED GldiWindowActor *actor, G_GNUC_UNUSED int iWidth, G_GNUC_UNUSED int iHeight)
+{
+	return NULL;
+}
+static GLuint _nop_window_get_texture (G_GNUC_UNUSED GldiWindowActor *actor)
+{
+	return 0;
+}
+static GldiWindowActor* _nop_pick_window (void)
+{
+	return NULL;
+}
+
+// the recorded windows don't exist in this session (or are other windows), so nothing must be done on them.
+static void _register_nop_window_manager_backend (void)
+{
+	GldiWindowManagerBackend wmb;
+	memset (&wmb, 0, sizeof (GldiWindowManagerBackend));  // the getters of the X backend are kept, since they go through the replayed properties.
+	wmb.move_to_nth_desktop = _nop_window_move_to_nth_desktop;
+	wmb.show = _nop_window_action;
+	wmb.close = _nop_window_action;
+	wmb.kill = _nop_window_action;
+	wmb.minimize = _nop_window_action;
+	wmb.lower = _nop_window_action;
+	wmb.maximize = _nop_window_set_state;
+	wmb.set_fullscreen = _nop_window_set_state;
+	wmb.set_above = _nop_window_set_state;
+	wmb.set_minimize_position = _nop_window_set_position;
+	wmb.set_thumbnail_area = _nop_window_set_area;
+	wmb.set_window_border = _nop_window_set_state;
+	wmb.get_icon_surface = _nop_window_get_surface;
+	wmb.get_thumbnail_surface = _nop_window_get_surface;
+	wmb.get_texture = _nop_window_get_texture;
+	wmb.set_sticky = _nop_window_set_state;
+	wmb.pick_window = _nop_pick_window;
+	gldi_windows_manager_register_backend (&wmb);
+}
+
+// feed the events of a record to the event handler as fast as possible, then print the cost of it on stdout as a JSON line, and quit.
+static gboolean _replay_Xevents (gchar *cFilePath)
+{
+	FILE *f = fopen (cFilePath, "rb");
+	char header[sizeof (CD_XEVENTS_FILE_HEADER)] = {0};
+	CDRecordedXSession session;
+	if (f == NULL
+	|| fread (header, strlen (CD_XEVENTS_FILE_HEADER), 1, f) != 1
+	|| strcmp (header, CD_XEVENTS_FILE_HEADER) != 0
+	|| fread (&session, sizeof (CDRecordedXSession), 1, f) != 1)
+	{
+		cd_warning ("'%s' is not a record of X events", cFilePath);
+		if (f)
+			fclose (f);
+		gtk_main_quit ();
+		return FALSE;
 	}
 	
+	//\__________________ load the events and the properties, and translate their atoms into this session.
+	GArray *pEvents = g_array_new (FALSE, FALSE, sizeof (XEvent));
+	s_hReplayedProperties = g_hash_table_new_full (g_int64_hash, g_int64_equal, g_free, (GDestroyNotify)_free_property_replies);
+	GHashTable *pAtoms = g_hash_table_new (g_str_hash, g_str_equal);  // (name, atom); names belong to the string chunk.
+	GStringChunk *pNames = g_string_chunk_new (1024);
+	CDRecordedXEvent rec;
+	Atom *pAtom;
+	gint iType;
+	while (fread (&iType, sizeof (gint), 1, f) == 1)
+	{
+		if (iType == CD_RECORD_XPROPERTY)
+		{
+			if (! _load_recorded_property (f, pAtoms, pNames))
+				break;
+			continue;
+		}
+		if (iType != CD_RECORD_XEVENT || fread (&rec, sizeof (CDRecordedXEvent), 1, f) != 1)
+			break;
+		pAtom = _get_event_atom (&rec.event);
+		if (pAtom != NULL)
+		{
+			rec.cAtomName[sizeof (rec.cAtomName) - 1] = '\0';
+			*pAtom = _intern_recorded_atom (pAtoms, pNames, rec.cAtomName);
+		}
+		#ifdef HAVE_XI2
+		if (rec.event.type == GenericEvent && rec.event.xcookie.extension == session.iXIOpcode)  // extension opcodes are given by the server too.
+			rec.event.xcookie.extension = s_iXIOpcode;
+		#endif
+		rec.event.xany.display = s_XDisplay;
+		g_array_append_val (pEvents, rec.event);
+	}
+	fclose (f);
+	g_hash_table_destroy (pAtoms);
+	g_string_chunk_free (pNames);
+	
+	//\__________________ process them, without any effect on the windows of this session.
+	_register_nop_window_manager_backend ();  // no need to restore the X backend, we quit right after.
+	cairo_dock_set_X_property_reader (_replay_property);
+	Window root = DefaultRootWindow (s_XDisplay);
+	gulong iNbNotifications = g_iNbNotifications, iNbCallbacks = g_iNbNotificationCallbacks;
+	gint64 t0 = g_get_monotonic_time ();
+	gboolean bPointerMoved = FALSE;
+	guint i;
+	for (i = 0; i < pEvents->len; i ++)
+	{
+		bPointerMoved |= _cairo_dock_process_Xevent (&g_array_index (pEvents, XEvent, i), root);
+	}
+	if (bPointerMoved)
+		gldi_object_notify (&myDesktopMgr, NOTIFICATION_POINTER_MOVED);
+	XFlush (s_XDisplay);
+	double fSeconds = (g_get_monotonic_time () - t0) * 1e-6;
+	iNbNotifications = g_iNbNotifications - iNbNotifications;
+	iNbCallbacks = g_iNbNotificationCallbacks - iNbCallbacks;
+	cairo_dock_set_X_property_reader (NULL);
+	g_hash_table_destroy (s_hReplayedProperties);
+	s_hReplayedProperties = NULL;
+	
+	//\__________________ report.
+	struct rusage usage;
+	getrusage (RUSAGE_SELF, &usage);
+	g_print ("{\"events\": %u, \"seconds\": %.6f, \"events_per_s\": %.0f, \"notifications\": %lu, \"callbacks\": %lu, \"callbacks_per_event\": %.2f, \"peak_rss_kb\": %ld}\n",
+		pEvents->len,
+		fSeconds,
+		fSeconds > 0 ? pEvents->len / fSeconds : 0.,
+		iNbNotifications,
+		iNbCallbacks,
+		pEvents->len != 0 ? (double)iNbCallbacks / pEvents->len : 0.,
+		usage.ru_maxrss);
+	
+	g_array_free (pEvents, TRUE);
+	gtk_main_quit ();
+	return FALSE;
+}
+
+static gboolean _cairo_dock_unstack_Xevents (G_GNUC_UNUSED gpointer data)
+{
+	static XEvent event;
+	
+	if (!g_pPrimaryContainer)  // peut arriver en cours de chargement d'un theme.
+		return TRUE;
+	
+	Window root = DefaultRootWindow (s_XDisplay);
+	
+	#ifdef HAVE_XI2
+	gboolean bPointerMoved = FALSE;
+	#endif
+	
+	// read the messages on the fd, and put them in the event queue
+	int i, nb_msg = XEventsQueued (s_XDisplay, QueuedAfterReading);
+	//g_print ("%d X msg\n", nb_msg);
+	
+	for (i = 0; i < nb_msg; i ++)
+	{
+		// get the next event in the queue
+		XNextEvent (s_XDisplay, &event);
+		//g_print (" %d) type : %d; atom : %s; window : %d\n", i, event.type, XGetAtomName (s_XDisplay, event.xproperty.atom), event.xany.window);
+		
+		if (s_pRecordFile != NULL)
+		{
+			_record_Xevent (&event);
+			s_bRecordProperties = TRUE;  // record what is read to handle this event, to serve it again on replay.
+		}
+		
+		#ifdef HAVE_XI2
+		bPointerMoved |= _cairo_dock_process_Xevent (&event, root);
+		#else
+		_cairo_dock_process_Xevent (&event, root);
+		#endif
+		s_bRecordProperties = FALSE;
+	}
+	if (s_pRecordFile != NULL && nb_msg != 0)
+		fflush (s_pRecordFile);
+	
+	#ifdef HAVE_XI2
+	if (bPointerMoved)
+		gldi_object_notify (&myDesktopMgr, NOTIFICATION_POINTER_MOVED);
+	#endif
+	
 	XFlush (s_XDisplay);  // now that there are no more messages in the input queue, flush the output queue
 	return TRUE;
 }
@@ -843,6 +1322,23 @@ static cairo_surface_t *_get_desktop_bg_surface (void)  // attention : fonction
 }
 
 
+static gboolean _get_desktop_bg_area (cairo_surface_t *pSurface, int x, int y, int iWidth, int iHeight)
+{
+	Pixmap iRootPixmapID = cairo_dock_get_window_background_pixmap (DefaultRootWindow (s_XDisplay));
+	if (iRootPixmapID == 0)
+		return FALSE;
+	
+	// only a wallpaper that covers the whole desktop can be read by areas; patterns and plain colors are read entirely by _get_desktop_bg_surface.
+	Window root;
+	int x_, y_;
+	guint w, h, border_width, iDepth;
+	if (! XGetGeometry (s_XDisplay, iRootPixmapID, &root, &x_, &y_, &w, &h, &border_width, &iDepth)
+	|| (int)w < gldi_desktop_get_width() || (int)h < gldi_desktop_get_height())
+		return FALSE;
+	
+	return cairo_dock_copy_pixmap_area_to_surface (iRootPixmapID, x, y, iWidth, iHeight, pSurface);
+}
+
 static void _refresh (void)
 {
 	g_desktopGeometry.iNbDesktops = cairo_dock_get_nb_desktops ();
@@ -899,6 +1395,24 @@ static gboolean _grab_shortkey (guint keycode, guint modifiers, gboolean grab)
 	return (error == 0);
 }
 
+#ifdef HAVE_XI2
+static gboolean _watch_pointer_motion (gboolean bWatch)
+{
+	// raw events are sent to the root window whatever window is under the pointer (and with XI 2.1, even if it's grabbed).
+	unsigned char mask[XIMaskLen (XI_RawMotion)];
+	memset (mask, 0, sizeof (mask));
+	if (bWatch)
+		XISetMask (mask, XI_RawMotion);
+	XIEventMask eventMask;
+	eventMask.deviceid = XIAllMasterDevices;
+	eventMask.mask_len = sizeof (mask);
+	eventMask.mask = mask;
+	XISelectEvents (s_XDisplay, DefaultRootWindow (s_XDisplay), &eventMask, 1);
+	XFlush (s_XDisplay);
+	return TRUE;
+}
+#endif
+
   ///////////////////////////////
  /// WINDOWS MANAGER BACKEND ///
 ///////////////////////////////
@@ -1232,11 +1746,20 @@ static void init (void)
 	dmb.get_desktops_names     = _get_desktops_names;
 	dmb.set_desktops_names     = _set_desktops_names;
 	dmb.get_desktop_bg_surface = _get_desktop_bg_surface;
+	dmb.get_desktop_bg_area    = _get_desktop_bg_area;
 	dmb.set_current_desktop    = _set_current_desktop;
 	dmb.set_nb_desktops        = _set_nb_desktops;
 	dmb.refresh                = _refresh;
 	dmb.notify_startup         = _notify_startup;
 	dmb.grab_shortkey          = _grab_shortkey;
+	#ifdef HAVE_XI2
+	int iXIEvent, iXIError, iXIMajor = 2, iXIMinor = 1;
+	if (XQueryExtension (s_XDisplay, "XInputExtension", &s_iXIOpcode, &iXIEvent, &iXIError)
+	&& XIQueryVersion (s_XDisplay, &iXIMajor, &iXIMinor) == Success)  // else the pointer will be polled.
+		dmb.watch_pointer_motion = _watch_pointer_motion;
+	else
+		s_iXIOpcode = -1;
+	#endif
 	gldi_desktop_manager_register_backend (&dmb);
 	
 	GldiWindowManagerBackend wmb;
@@ -1278,6 +1801,14 @@ static void init (void)
 	gldi_register_glx_backend ();  // actually one of them is a nop
 	gldi_register_egl_backend ();
 	
+	//\__________________ record/replay the X events, to measure their handling outside of a live session (once the XInput opcode is known).
+	const gchar *cRecordFile = g_getenv ("CAIRO_DOCK_RECORD_XEVENTS");
+	if (cRecordFile != NULL && *cRecordFile != '\0')
+		_start_recording_Xevents (cRecordFile);
+	const gchar *cReplayFile = g_getenv ("CAIRO_DOCK_REPLAY_XEVENTS");
+	if (cReplayFile != NULL && *cReplayFile != '\0')
+		g_idle_add_full (G_PRIORITY_LOW, (GSourceFunc)_replay_Xevents, g_strdup (cReplayFile), g_free);  // once the dock is loaded.
+	
 	//\__________________ get modifiers we want to filter
 	lookup_ignorable_modifiers ();
 }
@@ -31,6 +31,11 @@
 #endif
 #include <X11/extensions/Xrandr.h>
 #endif
+#ifdef HAVE_XSHM
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <X11/extensions/XShm.h>
+#endif
 
 #include "cairo-dock-log.h"
 #include "cairo-dock-utils.h"  // cairo_dock_remove_version_from_string, cairo_dock_check_xrandr
@@ -88,6 +93,7 @@ static Atom s_aWmName;
 static Atom s_aUtf8String;
 static Atom s_aString;
 static unsigned char error_code = Success;
+static CairoDockXPropertyReader s_pGetWindowProperty = XGetWindowProperty;  // all the properties are read through it, so that they can be recorded and replayed.
 
 static GtkAllocation *_get_screens_geometry (int *pNbScreens);
 
@@ -185,6 +191,11 @@ unsigned char cairo_dock_get_X_error_code (void)
 	return error_code;
 }
 
+void cairo_dock_set_X_property_reader (CairoDockXPropertyReader pReader)
+{
+	s_pGetWindowProperty = (pReader ? pReader : XGetWindowProperty);
+}
+
 static GtkAllocation *_get_screens_geometry (int *pNbScreens)
 {
 	GtkAllocation *pScreens = NULL;
@@ -300,7 +311,7 @@ static GtkAllocation *_get_screens_geometry (int *pNbScreens)
 	int aReturnedFormat = 0;
 	unsigned long iLeftBytes, iBufferNbElements = 0;
 	gulong *pXWorkArea = NULL;
-	XGetWindowProperty (s_XDisplay, root, aNetWorkArea, 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXWorkArea);
+	s_pGetWindowProperty (s_XDisplay, root, aNetWorkArea, 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXWorkArea);
 	int i;
 	for (i = 0; i < iBufferNbElements/4; i ++)
 	{
@@ -369,7 +380,7 @@ gchar **cairo_dock_get_desktops_names (void)
 	int aReturnedFormat = 0;
 	unsigned long iLeftBytes, iBufferNbElements = 0;
 	gchar *names = NULL;
-	XGetWindowProperty (s_XDisplay, root, s_aNetDesktopNames, 0, G_MAXULONG, False, s_aUtf8String, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&names);
+	s_pGetWindowProperty (s_XDisplay, root, s_aNetDesktopNames, 0, G_MAXULONG, False, s_aUtf8String, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&names);
 	
 	if (iBufferNbElements > 0)
 	{
@@ -429,7 +440,7 @@ int cairo_dock_get_current_desktop (void)
 	int aReturnedFormat = 0;
 	unsigned long iLeftBytes, iBufferNbElements = 0;
 	gulong *pXDesktopNumberBuffer = NULL;
-	XGetWindowProperty (s_XDisplay, root, s_aNetCurrentDesktop, 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXDesktopNumberBuffer);
+	s_pGetWindowProperty (s_XDisplay, root, s_aNetCurrentDesktop, 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXDesktopNumberBuffer);
 
 	int iDesktopNumber;
 	if (iBufferNbElements > 0)
@@ -460,7 +471,7 @@ void cairo_dock_get_current_viewport (int *iCurrentViewPortX, int *iCurrentViewP
 	int aReturnedFormat = 0;
 	unsigned long iLeftBytes, iBufferNbElements = 0;
 	gulong *pViewportsXY = NULL;
-	XGetWindowProperty (s_XDisplay, root, s_aNetDesktopViewport, 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pViewportsXY);
+	s_pGetWindowProperty (s_XDisplay, root, s_aNetDesktopViewport, 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pViewportsXY);
 	if (iBufferNbElements > 0)
 	{
 		*iCurrentViewPortX = pViewportsXY[0];
@@ -477,7 +488,7 @@ int cairo_dock_get_nb_desktops (void)
 	int aReturnedFormat = 0;
 	unsigned long iLeftBytes, iBufferNbElements = 0;
 	gulong *pXDesktopNumberBuffer = NULL;
-	XGetWindowProperty (s_XDisplay, root, s_aNetNbDesktops, 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXDesktopNumberBuffer);
+	s_pGetWindowProperty (s_XDisplay, root, s_aNetNbDesktops, 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXDesktopNumberBuffer);
 	
 	int iNumberOfDesktops;
 	if (iBufferNbElements > 0)
@@ -495,7 +506,7 @@ void cairo_dock_get_nb_viewports (int *iNbViewportX, int *iNbViewportY)
 	int aReturnedFormat = 0;
 	unsigned long iLeftBytes, iBufferNbElements = 0;
 	gulong *pVirtualScreenSizeBuffer = NULL;
-	XGetWindowProperty (s_XDisplay, root, s_aNetDesktopGeometry, 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pVirtualScreenSizeBuffer);
+	s_pGetWindowProperty (s_XDisplay, root, s_aNetDesktopGeometry, 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pVirtualScreenSizeBuffer);
 	if (iBufferNbElements > 0)
 	{
 		cd_debug ("pVirtualScreenSizeBuffer : %dx%d ; screen : %dx%d", pVirtualScreenSizeBuffer[0], pVirtualScreenSizeBuffer[1], gldi_desktop_get_width(), gldi_desktop_get_height());
@@ -515,7 +526,7 @@ gboolean cairo_dock_desktop_is_visible (void)
 	int aReturnedFormat = 0;
 	gulong *pXBuffer = NULL;
 	Window root = DefaultRootWindow (s_XDisplay);
-	XGetWindowProperty (s_XDisplay, root, aNetShowingDesktop, 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXBuffer);
+	s_pGetWindowProperty (s_XDisplay, root, aNetShowingDesktop, 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXBuffer);
 
 	gboolean bDesktopIsShown = (iBufferNbElements > 0 && pXBuffer != NULL ? *pXBuffer : FALSE);
 	XFree (pXBuffer);
@@ -615,7 +626,7 @@ Pixmap cairo_dock_get_window_background_pixmap (Window Xid)
 	unsigned long iLeftBytes, iBufferNbElements;
 	Pixmap *pPixmapIdBuffer = NULL;
 	Pixmap iBgPixmapID = 0;
-	XGetWindowProperty (s_XDisplay, Xid, s_aRootMapID, 0, G_MAXULONG, False, XA_PIXMAP, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pPixmapIdBuffer);
+	s_pGetWindowProperty (s_XDisplay, Xid, s_aRootMapID, 0, G_MAXULONG, False, XA_PIXMAP, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pPixmapIdBuffer);
 	if (iBufferNbElements != 0)
 	{
 		iBgPixmapID = *pPixmapIdBuffer;
@@ -666,6 +677,165 @@ GdkPixbuf *cairo_dock_get_pixbuf_from_pixmap (int XPixmapID, gboolean bAddAlpha)
 }
 
 
+#ifdef HAVE_XSHM
+typedef struct {
+	XImage *pImage;  // kept between calls, its segment is re-used as long as it's big enough.
+	XShmSegmentInfo info;
+	gsize iSize;
+	} CDShmImage;
+static CDShmImage s_ShmImages[2];  // one per depth (24 and 32), so that reading the desktop background and an ARGB window alternately doesn't re-create the segment each time.
+static gboolean s_bUseShm = TRUE;  // until the server refuses it (remote display).
+
+static void _destroy_shm_image (CDShmImage *pShm)
+{
+	XShmDetach (s_XDisplay, &pShm->info);
+	shmdt (pShm->info.shmaddr);
+	pShm->pImage->data = NULL;  // not allocated by Xlib
+	XDestroyImage (pShm->pImage);
+	pShm->pImage = NULL;
+	pShm->iSize = 0;
+}
+
+static XImage *_get_shm_image (Visual *pVisual, int iDepth, int iWidth, int iHeight)
+{
+	CDShmImage *pShm = &s_ShmImages[iDepth == 32 ? 1 : 0];
+	gsize iSize = (gsize)iWidth * iHeight * 4;
+	if (pShm->pImage != NULL && iSize > pShm->iSize)
+		_destroy_shm_image (pShm);
+	if (pShm->pImage == NULL)
+	{
+		pShm->pImage = XShmCreateImage (s_XDisplay, pVisual, iDepth, ZPixmap, NULL, &pShm->info, iWidth, iHeight);
+		if (pShm->pImage == NULL)
+			return NULL;
+		pShm->iSize = (gsize)pShm->pImage->bytes_per_line * iHeight;
+		pShm->info.shmid = shmget (IPC_PRIVATE, pShm->iSize, IPC_CREAT | 0600);
+		pShm->info.shmaddr = (pShm->info.shmid != -1 ? shmat (pShm->info.shmid, NULL, 0) : (char*)-1);
+		if (pShm->info.shmaddr == (char*)-1)
+		{
+			if (pShm->info.shmid != -1)
+				shmctl (pShm->info.shmid, IPC_RMID, NULL);
+			XDestroyImage (pShm->pImage);
+			pShm->pImage = NULL;
+			s_bUseShm = FALSE;
+			return NULL;
+		}
+		pShm->pImage->data = pShm->info.shmaddr;
+		pShm->info.readOnly = False;
+		
+		cairo_dock_reset_X_error_code ();
+		Status bAttached = XShmAttach (s_XDisplay, &pShm->info);
+		XSync (s_XDisplay, False);
+		shmctl (pShm->info.shmid, IPC_RMID, NULL);  // it will be destroyed once detached by both sides.
+		if (! bAttached || cairo_dock_get_X_error_code () != Success)
+		{
+			cd_debug ("MIT-SHM is not usable, the pixmaps will be read through the socket");
+			shmdt (pShm->info.shmaddr);
+			pShm->pImage->data = NULL;
+			XDestroyImage (pShm->pImage);
+			pShm->pImage = NULL;
+			s_bUseShm = FALSE;
+			return NULL;
+		}
+	}
+	// the segment can hold a smaller image.
+	pShm->pImage->width = iWidth;
+	pShm->pImage->height = iHeight;
+	pShm->pImage->bytes_per_line = iWidth * 4;
+	return pShm->pImage;
+}
+#endif
+
+static XImage *_get_pixmap_image (Pixmap XPixmapID, Visual *pVisual, int iDepth, int x, int y, int iWidth, int iHeight)
+{
+	#ifdef HAVE_XSHM
+	XImage *pShmImage;
+	if (s_bUseShm && XShmQueryExtension (s_XDisplay)
+	&& (pShmImage = _get_shm_image (pVisual, iDepth, iWidth, iHeight)) != NULL)
+	{
+		cairo_dock_reset_X_error_code ();
+		if (XShmGetImage (s_XDisplay, XPixmapID, pShmImage, x, y, AllPlanes) && cairo_dock_get_X_error_code () == Success)
+			return pShmImage;
+	}
+	#endif
+	XImage *pImage = XGetImage (s_XDisplay, XPixmapID, x, y, iWidth, iHeight, AllPlanes, ZPixmap);
+	if (pImage != NULL && pImage->bits_per_pixel != 32)
+	{
+		XDestroyImage (pImage);
+		pImage = NULL;
+	}
+	return pImage;
+}
+
+static void _release_pixmap_image (XImage *pImage)
+{
+	#ifdef HAVE_XSHM
+	if (pImage == s_ShmImages[0].pImage || pImage == s_ShmImages[1].pImage)  // the segment is kept for the next call.
+		return;
+	#endif
+	XDestroyImage (pImage);
+}
+
+// the pixels of a pixmap can be used as is by cairo if they are 32 bits 0xAARRGGBB words in the native order.
+static Visual *_get_cairo_compatible_visual (Pixmap XPixmapID, guint *iWidth, guint *iHeight, guint *iDepth)
+{
+	Window root;  // inutile.
+	int x_, y_;  // inutile.
+	guint border_width;  // inutile.
+	if (! XGetGeometry (s_XDisplay, XPixmapID, &root, &x_, &y_, iWidth, iHeight, &border_width, iDepth))
+		return NULL;
+	Visual *pVisual = DefaultVisual (s_XDisplay, DefaultScreen (s_XDisplay));
+	if ((*iDepth != 24 && *iDepth != 32)
+	|| pVisual->red_mask != 0xff0000 || pVisual->green_mask != 0xff00 || pVisual->blue_mask != 0xff
+	|| ImageByteOrder (s_XDisplay) != (G_BYTE_ORDER == G_LITTLE_ENDIAN ? LSBFirst : MSBFirst))
+		return NULL;
+	return pVisual;
+}
+
+static cairo_surface_t *_create_surface_for_ximage (XImage *pImage, gboolean bWithAlpha)
+{
+	return cairo_image_surface_create_for_data ((unsigned char *)pImage->data,
+		bWithAlpha ? CAIRO_FORMAT_ARGB32 : CAIRO_FORMAT_RGB24,
+		pImage->width,
+		pImage->height,
+		pImage->bytes_per_line);
+}
+
+static void _paint_ximage_on_surface (XImage *pImage, int x, int y, cairo_surface_t *pSurface)
+{
+	cairo_surface_t *pImageSurface = _create_surface_for_ximage (pImage, FALSE);
+	cairo_t *pCairoContext = cairo_create (pSurface);
+	cairo_set_operator (pCairoContext, CAIRO_OPERATOR_SOURCE);
+	cairo_set_source_surface (pCairoContext, pImageSurface, x, y);
+	cairo_rectangle (pCairoContext, x, y, pImage->width, pImage->height);
+	cairo_fill (pCairoContext);
+	cairo_destroy (pCairoContext);
+	cairo_surface_destroy (pImageSurface);  // doesn't free the data.
+}
+
+gboolean cairo_dock_copy_pixmap_area_to_surface (Pixmap XPixmapID, int x, int y, int iWidth, int iHeight, cairo_surface_t *pSurface)
+{
+	g_return_val_if_fail (XPixmapID != 0 && pSurface != NULL, FALSE);
+	if (iWidth <= 0 || iHeight <= 0)
+		return TRUE;
+	
+	//\__________________ the pixels are used as is, so they have to be in the cairo format.
+	guint w, h, iDepth;
+	Visual *pVisual = _get_cairo_compatible_visual (XPixmapID, &w, &h, &iDepth);
+	if (pVisual == NULL)
+		return FALSE;
+	if (x < 0 || y < 0 || x + iWidth > (int)w || y + iHeight > (int)h)
+		return FALSE;
+	
+	//\__________________ read the area, without copying it through the socket if possible.
+	XImage *pImage = _get_pixmap_image (XPixmapID, pVisual, iDepth, x, y, iWidth, iHeight);
+	if (pImage == NULL)
+		return FALSE;
+	_paint_ximage_on_surface (pImage, 0, 0, pSurface);
+	_release_pixmap_image (pImage);
+	return TRUE;
+}
+
+
 void cairo_dock_set_nb_viewports (int iNbViewportX, int iNbViewportY)
 {
 	XEvent xClientMessage;
@@ -1079,7 +1249,7 @@ gulong cairo_dock_get_xwindow_timestamp (Window Xid)
 	Atom aReturnedType = 0;
 	int aReturnedFormat = 0;
 	gulong *pTimeBuffer = NULL;
-	XGetWindowProperty (s_XDisplay, Xid, aNetWmUserTime, 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pTimeBuffer);
+	s_pGetWindowProperty (s_XDisplay, Xid, aNetWmUserTime, 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pTimeBuffer);
 	gulong iTimeStamp = 0;
 	if (iBufferNbElements > 0)
 		iTimeStamp = *pTimeBuffer;
@@ -1093,9 +1263,9 @@ gchar *cairo_dock_get_xwindow_name (Window Xid, gboolean bSearchWmName)
 	int aReturnedFormat = 0;
 	unsigned long iLeftBytes, iBufferNbElements=0;
 	guchar *pNameBuffer = NULL;
-	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmName, 0, G_MAXULONG, False, s_aUtf8String, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, &pNameBuffer);  // on cherche en priorite le nom en UTF8, car on est notifie des 2, mais il vaut mieux eviter le WM_NAME qui, ne l'etant pas, contient des caracteres bizarres qu'on ne peut pas convertir avec g_locale_to_utf8, puisque notre locale _est_ UTF8.
+	s_pGetWindowProperty (s_XDisplay, Xid, s_aNetWmName, 0, G_MAXULONG, False, s_aUtf8String, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, &pNameBuffer);  // on cherche en priorite le nom en UTF8, car on est notifie des 2, mais il vaut mieux eviter le WM_NAME qui, ne l'etant pas, contient des caracteres bizarres qu'on ne peut pas convertir avec g_locale_to_utf8, puisque notre locale _est_ UTF8.
 	if (iBufferNbElements == 0 && bSearchWmName)
-		XGetWindowProperty (s_XDisplay, Xid, s_aWmName, 0, G_MAXULONG, False, s_aString, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, &pNameBuffer);
+		s_pGetWindowProperty (s_XDisplay, Xid, s_aWmName, 0, G_MAXULONG, False, s_aString, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, &pNameBuffer);
 	
 	gchar *cName = NULL;
 	if (iBufferNbElements > 0)
@@ -1189,7 +1359,7 @@ gboolean cairo_dock_xwindow_is_maximized (Window Xid)
 	int aReturnedFormat = 0;
 	unsigned long iLeftBytes, iBufferNbElements = 0;
 	gulong *pXStateBuffer = NULL;
-	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmState, 0, G_MAXULONG, False, XA_ATOM, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXStateBuffer);
+	s_pGetWindowProperty (s_XDisplay, Xid, s_aNetWmState, 0, G_MAXULONG, False, XA_ATOM, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXStateBuffer);
 	int iIsMaximized = 0;
 	if (iBufferNbElements > 0)
 	{
@@ -1214,7 +1384,7 @@ static gboolean _cairo_dock_window_is_in_state (Window Xid, Atom iState)
 	int aReturnedFormat = 0;
 	unsigned long iLeftBytes, iBufferNbElements = 0;
 	gulong *pXStateBuffer = NULL;
-	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmState, 0, G_MAXULONG, False, XA_ATOM, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXStateBuffer);
+	s_pGetWindowProperty (s_XDisplay, Xid, s_aNetWmState, 0, G_MAXULONG, False, XA_ATOM, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXStateBuffer);
 
 	gboolean bIsInState = FALSE;
 	if (iBufferNbElements > 0)
@@ -1256,7 +1426,7 @@ void cairo_dock_xwindow_is_above_or_below (Window Xid, gboolean *bIsAbove, gbool
 	int aReturnedFormat = 0;
 	unsigned long iLeftBytes, iBufferNbElements = 0;
 	gulong *pXStateBuffer = NULL;
-	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmState, 0, G_MAXULONG, False, XA_ATOM, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXStateBuffer);
+	s_pGetWindowProperty (s_XDisplay, Xid, s_aNetWmState, 0, G_MAXULONG, False, XA_ATOM, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXStateBuffer);
 
 	if (iBufferNbElements > 0)
 	{
@@ -1291,7 +1461,7 @@ gboolean cairo_dock_xwindow_is_fullscreen_or_hidden_or_maximized (Window Xid, gb
 	int aReturnedFormat = 0;
 	unsigned long iLeftBytes, iBufferNbElements = 0;
 	gulong *pXStateBuffer = NULL;
-	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmState, 0, G_MAXULONG, False, XA_ATOM, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXStateBuffer);
+	s_pGetWindowProperty (s_XDisplay, Xid, s_aNetWmState, 0, G_MAXULONG, False, XA_ATOM, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXStateBuffer);
 	
 	gboolean bValid = TRUE;
 	*bIsFullScreen = FALSE;
@@ -1351,7 +1521,7 @@ void cairo_dock_xwindow_can_minimize_maximized_close (Window Xid, gboolean *bCan
 	unsigned long iLeftBytes, iBufferNbElements = 0;
 	gulong *pXStateBuffer = NULL;
 	
-	XGetWindowProperty (s_XDisplay,
+	s_pGetWindowProperty (s_XDisplay,
 		Xid, s_aNetWMAllowedActions, 0, G_MAXULONG, False, XA_ATOM,
 		&aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXStateBuffer);
 
@@ -1390,7 +1560,7 @@ int cairo_dock_get_xwindow_desktop (Window Xid)
 	Atom aReturnedType = 0;
 	int aReturnedFormat = 0;
 	gulong *pBuffer = NULL;
-	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmDesktop, 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pBuffer);
+	s_pGetWindowProperty (s_XDisplay, Xid, s_aNetWmDesktop, 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pBuffer);
 	if (iBufferNbElements > 0)
 		iDesktopNumber = *pBuffer;
 	else
@@ -1430,7 +1600,7 @@ void cairo_dock_get_xwindow_geometry (Window Xid, int *iLocalPositionX, int *iLo
 	Atom aReturnedType = 0;
 	int aReturnedFormat = 0;
 	gulong *pBuffer = NULL;
-	XGetWindowProperty (s_XDisplay, Xid, XInternAtom (s_XDisplay, "_NET_FRAME_EXTENTS", False), 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pBuffer);
+	s_pGetWindowProperty (s_XDisplay, Xid, XInternAtom (s_XDisplay, "_NET_FRAME_EXTENTS", False), 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pBuffer);
 	if (iBufferNbElements > 3)
 	{
 		left=pBuffer[0], right=pBuffer[1], top=pBuffer[2], bottom=pBuffer[3];
@@ -1453,7 +1623,7 @@ Window *cairo_dock_get_windows_list (gulong *iNbWindows, gboolean bStackOrder)
 
 	Window root = DefaultRootWindow (s_XDisplay);
 	gulong iLeftBytes;
-	XGetWindowProperty (s_XDisplay, root, (bStackOrder ? s_aNetClientListStacking : s_aNetClientList), 0, G_MAXLONG, False, XA_WINDOW, &aReturnedType, &aReturnedFormat, iNbWindows, &iLeftBytes, (guchar **)&XidList);
+	s_pGetWindowProperty (s_XDisplay, root, (bStackOrder ? s_aNetClientListStacking : s_aNetClientList), 0, G_MAXLONG, False, XA_WINDOW, &aReturnedType, &aReturnedFormat, iNbWindows, &iLeftBytes, (guchar **)&XidList);
 	return XidList;
 }
 
@@ -1464,7 +1634,7 @@ Window cairo_dock_get_active_xwindow (void)
 	unsigned long iLeftBytes, iBufferNbElements = 0;
 	Window *pXBuffer = NULL;
 	Window root = DefaultRootWindow (s_XDisplay);
-	XGetWindowProperty (s_XDisplay, root, s_aNetActiveWindow, 0, G_MAXULONG, False, XA_WINDOW, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXBuffer);
+	s_pGetWindowProperty (s_XDisplay, root, s_aNetActiveWindow, 0, G_MAXULONG, False, XA_WINDOW, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXBuffer);
 
 	Window xActiveWindow = (iBufferNbElements > 0 && pXBuffer != NULL ? pXBuffer[0] : 0);
 	XFree (pXBuffer);
@@ -1479,7 +1649,7 @@ cairo_surface_t *cairo_dock_create_surface_from_xwindow (Window Xid, int iWidth,
 	int aReturnedFormat = 0;
 	unsigned long iLeftBytes, iBufferNbElements = 0;
 	gulong *pXIconBuffer = NULL;
-	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmIcon, 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXIconBuffer);
+	s_pGetWindowProperty (s_XDisplay, Xid, s_aNetWmIcon, 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pXIconBuffer);
 
 	if (iBufferNbElements > 2)
 	{
@@ -1568,9 +1738,42 @@ cairo_surface_t *cairo_dock_create_surface_from_xwindow (Window Xid, int iWidth,
 	}
 }
 
+static cairo_surface_t *_create_scaled_surface_from_pixmap (Pixmap Xid, int iWidth, int iHeight)
+{
+	guint w, h, iDepth;
+	Visual *pVisual = _get_cairo_compatible_visual (Xid, &w, &h, &iDepth);
+	if (pVisual == NULL || w == 0 || h == 0)
+		return NULL;
+	XImage *pImage = _get_pixmap_image (Xid, pVisual, iDepth, 0, 0, w, h);
+	if (pImage == NULL)
+		return NULL;
+	cd_debug ("window pixmap : %ux%ux%u", w, h, iDepth);
+	
+	//\__________________ the window keeps its ratio, and is centered in the usual size of the appli icons (like CAIRO_DOCK_KEEP_RATIO | CAIRO_DOCK_FILL_SPACE).
+	double fZoom = MIN ((double)iWidth / w, (double)iHeight / h);
+	cairo_surface_t *pImageSurface = _create_surface_for_ximage (pImage, iDepth == 32);  // ARGB windows have premultiplied pixels, like cairo.
+	cairo_surface_t *pSurface = cairo_dock_create_blank_surface (iWidth, iHeight);
+	cairo_t *pCairoContext = cairo_create (pSurface);
+	cairo_translate (pCairoContext, (iWidth - w * fZoom) / 2, (iHeight - h * fZoom) / 2);
+	cairo_scale (pCairoContext, fZoom, fZoom);
+	cairo_set_source_surface (pCairoContext, pImageSurface, 0, 0);
+	cairo_pattern_set_filter (cairo_get_source (pCairoContext), CAIRO_FILTER_GOOD);  // box-filtered by pixman when shrinking.
+	cairo_paint (pCairoContext);
+	cairo_destroy (pCairoContext);
+	cairo_surface_destroy (pImageSurface);
+	_release_pixmap_image (pImage);
+	return pSurface;
+}
+
+// one-shot snapshot of a window (taken when it gets minimized, so it won't change until it's restored); there is no live preview to refresh on damage.
 cairo_surface_t *cairo_dock_create_surface_from_xpixmap (Pixmap Xid, int iWidth, int iHeight)
 {
 	g_return_val_if_fail (Xid > 0, NULL);
+	//\__________________ read the pixmap directly and let cairo shrink it, rather than going through a pixbuf and converting each pixel.
+	cairo_surface_t *pSurface = _create_scaled_surface_from_pixmap (Xid, iWidth, iHeight);
+	if (pSurface != NULL)
+		return pSurface;
+	
 	GdkPixbuf *pPixbuf = cairo_dock_get_pixbuf_from_pixmap (Xid, TRUE);
 	if (pPixbuf == NULL)
 	{
@@ -1580,7 +1783,7 @@ cairo_surface_t *cairo_dock_create_surface_from_xpixmap (Pixmap Xid, int iWidth,
 	
 	cd_debug ("window pixmap : %dx%d", gdk_pixbuf_get_width (pPixbuf), gdk_pixbuf_get_height (pPixbuf));
 	double fWidth, fHeight;
-	cairo_surface_t *pSurface = cairo_dock_create_surface_from_pixbuf (pPixbuf,
+	pSurface = cairo_dock_create_surface_from_pixbuf (pPixbuf,
 		1.,
 		iWidth, iHeight,
 		CAIRO_DOCK_KEEP_RATIO | CAIRO_DOCK_FILL_SPACE,  // on conserve le ratio de la fenetre, tout en gardant la taille habituelle des icones d'appli.
@@ -1725,7 +1928,7 @@ GLuint cairo_dock_texture_from_pixmap (Window Xid, Pixmap iBackingPixmap)
 	int aReturnedFormat = 0;
 	unsigned long iLeftBytes, iBufferNbElements = 0;
 	gulong *pPidBuffer = NULL;
-	XGetWindowProperty (s_XDisplay, Xid, XInternAtom (s_XDisplay, "_NET_WM_PID", False), 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pPidBuffer);
+	s_pGetWindowProperty (s_XDisplay, Xid, XInternAtom (s_XDisplay, "_NET_WM_PID", False), 0, G_MAXULONG, False, XA_CARDINAL, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pPidBuffer);
 	
 	gchar *cCommand = NULL;
 	if (iBufferNbElements > 0)
@@ -1752,7 +1955,7 @@ gboolean cairo_dock_get_xwindow_type (Window Xid, Window *pTransientFor)
 	int aReturnedFormat = 0;
 	unsigned long iLeftBytes, iBufferNbElements;
 	gulong *pTypeBuffer = NULL;
-	XGetWindowProperty (s_XDisplay, Xid, s_aNetWmWindowType, 0, G_MAXULONG, False, XA_ATOM, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pTypeBuffer);
+	s_pGetWindowProperty (s_XDisplay, Xid, s_aNetWmWindowType, 0, G_MAXULONG, False, XA_ATOM, &aReturnedType, &aReturnedFormat, &iBufferNbElements, &iLeftBytes, (guchar **)&pTypeBuffer);
 	if (iBufferNbElements != 0)
 	{
 		guint i;
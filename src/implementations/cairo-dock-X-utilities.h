@@ -41,6 +41,14 @@ Display *cairo_dock_get_X_display (void);
 void cairo_dock_reset_X_error_code (void);
 unsigned char cairo_dock_get_X_error_code (void);
 
+/* Same prototype as XGetWindowProperty; the data it returns must be freed with XFree.
+ */
+typedef int (*CairoDockXPropertyReader) (Display *display, Window w, Atom property, long long_offset, long long_length, Bool delete, Atom req_type, Atom *actual_type_return, int *actual_format_return, unsigned long *nitems_return, unsigned long *bytes_after_return, unsigned char **prop_return);
+
+/* Set the function used to read the properties of the windows (XGetWindowProperty by default), to record or replay them. NULL restores the default one.
+ */
+void cairo_dock_set_X_property_reader (CairoDockXPropertyReader pReader);
+
   /////////////
  // DESKTOP //
 /////////////
@@ -66,6 +74,9 @@ Pixmap cairo_dock_get_window_background_pixmap (Window Xid);
 
 GdkPixbuf *cairo_dock_get_pixbuf_from_pixmap (int XPixmapID, gboolean bAddAlpha);
 
+// copy an area of a pixmap at the top-left corner of a surface (through MIT-SHM if possible); FALSE if its pixels are not in the cairo format.
+gboolean cairo_dock_copy_pixmap_area_to_surface (Pixmap XPixmapID, int x, int y, int iWidth, int iHeight, cairo_surface_t *pSurface);
+
 void cairo_dock_set_nb_viewports (int iNbViewportX, int iNbViewportY);
 void cairo_dock_set_nb_desktops (gulong iNbDesktops);
 
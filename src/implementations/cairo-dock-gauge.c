@@ -824,10 +824,9 @@ static void cairo_dock_draw_one_gauge_opengl (Gauge *pGauge, int iDataOffset)
 	}
 	
 	//\________________ On affiche les overlays.
-	for (i = iDataOffset, pIndicatorElement = pGauge->pIndicatorList; i < pData->iNbValues && pIndicatorElement != NULL; i++, pIndicatorElement = pIndicatorElement->next)
-	{
-		cairo_dock_render_overlays_to_texture (pRenderer, i);
-	}
+	int iNbOverlays = MIN (pData->iNbValues - iDataOffset, (int) g_list_length (pGauge->pIndicatorList));
+	if (iNbOverlays > 0)
+		cairo_dock_render_all_overlays_to_texture (pRenderer, iDataOffset, iNbOverlays);
 }
 static void render_opengl (Gauge *pGauge)
 {
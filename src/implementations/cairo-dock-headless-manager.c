@@ -0,0 +1,157 @@
+/**
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>  // memset
+
+#include <gdk/gdk.h>
+#ifdef GDK_WINDOWING_BROADWAY
+#include <gdk/gdkbroadway.h>
+#endif
+
+#include "cairo-dock-struct.h"
+#include "cairo-dock-log.h"
+#include "cairo-dock-desktop-manager.h"
+#include "cairo-dock-container.h"  // GldiContainerManagerBackend
+#define _MANAGER_DEF_
+#include "cairo-dock-headless-manager.h"
+
+// public (manager, config, data)
+GldiManager myHeadlessMgr;
+
+#ifdef GDK_WINDOWING_BROADWAY
+
+// Broadway is the GDK backend that draws the windows into memory and sends them to a browser, if any; it doesn't need a display nor a GPU.
+// There is no window manager: the containers are simply placed where we ask, and there are no other windows.
+
+static void _update_screen_geometry (void)
+{
+	GdkScreen *pScreen = gdk_screen_get_default ();
+	g_desktopGeometry.Xscreen.x = 0;
+	g_desktopGeometry.Xscreen.y = 0;
+	g_desktopGeometry.Xscreen.width = gdk_screen_get_width (pScreen);
+	g_desktopGeometry.Xscreen.height = gdk_screen_get_height (pScreen);
+	
+	g_desktopGeometry.iNbScreens = 1;
+	g_free (g_desktopGeometry.pScreens);
+	g_desktopGeometry.pScreens = g_new0 (GtkAllocation, 1);
+	g_desktopGeometry.pScreens[0] = g_desktopGeometry.Xscreen;
+	cd_debug ("headless screen: %dx%d", g_desktopGeometry.Xscreen.width, g_desktopGeometry.Xscreen.height);
+}
+
+static void _on_screen_size_changed (G_GNUC_UNUSED GdkScreen *pScreen, G_GNUC_UNUSED gpointer data)  // when a browser is connected, the screen takes its size.
+{
+	_update_screen_geometry ();
+	gldi_object_notify (&myDesktopMgr, NOTIFICATION_DESKTOP_GEOMETRY_CHANGED, TRUE);  // TRUE <=> resolution has changed
+}
+
+static void _refresh (void)
+{
+	_update_screen_geometry ();
+}
+
+static int _get_current_desktop_index (G_GNUC_UNUSED GldiContainer *pContainer)
+{
+	return 0;  // a single desktop, with a single viewport.
+}
+
+static void _move (GldiContainer *pContainer, G_GNUC_UNUSED int iNumDesktop, int iAbsolutePositionX, int iAbsolutePositionY)
+{
+	gtk_window_move (GTK_WINDOW (pContainer->pWidget), iAbsolutePositionX, iAbsolutePositionY);
+}
+
+static gboolean _is_active (GldiContainer *pContainer)
+{
+	return gtk_window_is_active (GTK_WINDOW (pContainer->pWidget));
+}
+
+static void _present (GldiContainer *pContainer)
+{
+	gtk_window_present (GTK_WINDOW (pContainer->pWidget));  // no focus steal prevention here.
+}
+
+
+  ////////////
+ /// INIT ///
+////////////
+
+static void init (void)
+{
+	//\__________________ a fixed desktop, the size of the Broadway screen.
+	g_desktopGeometry.iNbDesktops = g_desktopGeometry.iNbViewportX = g_desktopGeometry.iNbViewportY = 1;
+	g_desktopGeometry.iCurrentDesktop = g_desktopGeometry.iCurrentViewportX = g_desktopGeometry.iCurrentViewportY = 0;
+	_update_screen_geometry ();
+	g_signal_connect (gdk_screen_get_default (), "size-changed", G_CALLBACK (_on_screen_size_changed), NULL);
+	
+	//\__________________ Register backends
+	GldiDesktopManagerBackend dmb;
+	memset (&dmb, 0, sizeof (GldiDesktopManagerBackend));
+	dmb.refresh = _refresh;
+	gldi_desktop_manager_register_backend (&dmb);
+	
+	GldiContainerManagerBackend cmb;
+	memset (&cmb, 0, sizeof (GldiContainerManagerBackend));
+	cmb.get_current_desktop_index = _get_current_desktop_index;
+	cmb.move = _move;
+	cmb.is_active = _is_active;
+	cmb.present = _present;
+	gldi_container_manager_register_backend (&cmb);
+	
+	// no window manager backend: there are no other windows.
+	// no OpenGL backend: Broadway only transports images, so the dock is drawn with cairo.
+}
+
+
+  ///////////////
+ /// MANAGER ///
+///////////////
+
+void gldi_register_headless_manager (void)
+{
+	GdkDisplay *dsp = gdk_display_get_default ();  // GDK has been told to use Broadway or not at startup (see the '--headless' option).
+	if (! GDK_IS_BROADWAY_DISPLAY (dsp))
+	{
+		cd_message ("Not a headless session");
+		return;
+	}
+	
+	// Manager
+	memset (&myHeadlessMgr, 0, sizeof (GldiManager));
+	myHeadlessMgr.cModuleName   = "Headless";
+	myHeadlessMgr.init          = init;
+	myHeadlessMgr.load          = NULL;
+	myHeadlessMgr.unload        = NULL;
+	myHeadlessMgr.reload        = (GldiManagerReloadFunc)NULL;
+	myHeadlessMgr.get_config    = (GldiManagerGetConfigFunc)NULL;
+	myHeadlessMgr.reset_config  = (GldiManagerResetConfigFunc)NULL;
+	// Config
+	myHeadlessMgr.pConfig = (GldiManagerConfigPtr)NULL;
+	myHeadlessMgr.iSizeOfConfig = 0;
+	// data
+	myHeadlessMgr.iSizeOfData = 0;
+	myHeadlessMgr.pData = (GldiManagerDataPtr)NULL;
+	// register
+	gldi_object_init (GLDI_OBJECT(&myHeadlessMgr), &myManagerObjectMgr, NULL);
+}
+
+#else
+void gldi_register_headless_manager (void)
+{
+	cd_message ("GTK was not built with the Broadway backend, the headless mode is not available");
+}
+#endif
@@ -0,0 +1,38 @@
+/*
+* This file is a part of the Cairo-Dock project
+*
+* Copyright : (C) see the 'copyright' file.
+* E-mail    : see the 'copyright' file.
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 3
+* of the License, or (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __CAIRO_DOCK_HEADLESS_MANAGER__
+#define  __CAIRO_DOCK_HEADLESS_MANAGER__
+
+#include "cairo-dock-struct.h"
+G_BEGIN_DECLS
+
+/*
+*@file cairo-dock-headless-manager.h This class manages a session without display, for the tests and the benchmarks.
+* GDK draws the windows into memory with its Broadway backend, so neither an X server nor a GPU is needed. The Headless manager provides the geometry of the desktop and places the containers, since there is no window manager.
+*/
+
+#ifndef _MANAGER_DEF_
+extern GldiManager myHeadlessMgr;
+#endif
+
+void gldi_register_headless_manager (void);
+
+G_END_DECLS
+#endif
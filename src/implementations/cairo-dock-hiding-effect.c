@@ -98,6 +98,7 @@ static void _post_render_move_down_opengl (CairoDock *pDock, double fOffset)
 		GL_TEXTURE_2D,
 		0,
 		0);  // on detache la texture (precaution).
+	pDock->bRedirectedImageIsValid = TRUE;  // the texture holds the dock now, it will be reused until the dock changes.
 	// dessin dans notre fenetre.
 	_cairo_dock_enable_texture ();
 	///_cairo_dock_set_blend_alpha ();
@@ -235,6 +236,7 @@ static void _post_render_fade_out_opengl (CairoDock *pDock, double fOffset)
 			GL_TEXTURE_2D,
 			0,
 			0);  // on detache la texture (precaution).
+		pDock->bRedirectedImageIsValid = TRUE;
 		// dessin dans notre fenetre.
 		_cairo_dock_enable_texture ();
 		_cairo_dock_set_blend_alpha ();  // le moins pire des 3.
@@ -296,6 +298,7 @@ static void _post_render_semi_transparent_opengl (CairoDock *pDock, double fOffs
 			GL_TEXTURE_2D,
 			0,
 			0);  // on detache la texture (precaution).
+		pDock->bRedirectedImageIsValid = TRUE;
 		// dessin dans notre fenetre.
 		_cairo_dock_enable_texture ();
 		_cairo_dock_set_blend_source ();
@@ -386,6 +389,7 @@ static void _post_render_zoom_opengl (CairoDock *pDock, double fOffset)
 		GL_TEXTURE_2D,
 		0,
 		0);  // on detache la texture (precaution).
+	pDock->bRedirectedImageIsValid = TRUE;  // the texture holds the dock now, it will be reused until the dock changes.
 	// dessin dans notre fenetre.
 	_cairo_dock_enable_texture ();
 	_cairo_dock_set_blend_source ();
@@ -476,6 +480,7 @@ static void _post_render_folding_opengl (CairoDock *pDock, double fOffset)
 		GL_TEXTURE_2D,
 		0,
 		0);  // on detache la texture (precaution).
+	pDock->bRedirectedImageIsValid = TRUE;  // the texture holds the dock now, it will be reused until the dock changes.
 	// dessin dans notre fenetre.
 	_cairo_dock_enable_texture ();
 	_cairo_dock_set_blend_alpha ();
@@ -0,0 +1,150 @@
+#!/usr/bin/env python
+#
+# Test of the cache of D-Bus properties of libgldi (cairo_dock_dbus_cache_properties).
+# It doesn't need a running dock, but a private session bus, so that it can't disturb the real one:
+#   dbus-run-session -- python TestDBusPropertiesCache.py [path to libgldi.so]
+#
+# A fake service exposes one property; the test checks that the cache serves it without a call
+# on the bus, follows its 'PropertiesChanged' signal, and is refreshed when the service restarts.
+
+import sys  # argv, executable
+import os  # environ
+import subprocess
+from time import sleep, time
+import ctypes
+
+SERVICE = 'org.cairodock.TestProperties'
+OBJECT = '/org/cairodock/TestProperties'
+INTERFACE = 'org.cairodock.TestProperties'
+
+# Fake service
+def run_service(value):
+	import dbus
+	import dbus.service
+	from dbus.mainloop.glib import DBusGMainLoop
+	from gi.repository import GLib
+
+	class Service(dbus.service.Object):
+		def __init__(self, bus):
+			self.value = value
+			dbus.service.Object.__init__(self, bus, OBJECT)
+
+		@dbus.service.method(dbus.PROPERTIES_IFACE, in_signature='ss', out_signature='v')
+		def Get(self, interface, prop):
+			return dbus.Int32(self.value)
+
+		@dbus.service.method(dbus.PROPERTIES_IFACE, in_signature='s', out_signature='a{sv}')
+		def GetAll(self, interface):
+			return {'Value': dbus.Int32(self.value)}
+
+		@dbus.service.method(dbus.PROPERTIES_IFACE, in_signature='ssv')
+		def Set(self, interface, prop, value):
+			self.value = int(value)
+			self.PropertiesChanged(INTERFACE, {'Value': dbus.Int32(self.value)}, [])
+
+		@dbus.service.signal(dbus.PROPERTIES_IFACE, signature='sa{sv}as')
+		def PropertiesChanged(self, interface, changed, invalidated):
+			pass
+
+	DBusGMainLoop(set_as_default=True)
+	bus = dbus.SessionBus()
+	name = dbus.service.BusName(SERVICE, bus)
+	service = Service(bus)
+	GLib.MainLoop().run()
+
+def start_service(value):
+	p = subprocess.Popen([sys.executable, __file__, '--service', str(value)])
+	sleep(1)  # let it own its name
+	return p
+
+# Test
+class TestDBusPropertiesCache:
+	def __init__(self, lib_path):
+		self.name = "Test D-Bus properties cache"
+		self.error = 0
+		self.gldi = ctypes.CDLL(lib_path)
+		self.glib = ctypes.CDLL('libglib-2.0.so.0')
+		self.gldi.cairo_dock_create_new_session_proxy.restype = ctypes.c_void_p
+		self.gldi.cairo_dock_create_new_session_proxy.argtypes = [ctypes.c_char_p, ctypes.c_char_p, ctypes.c_char_p]
+		self.gldi.cairo_dock_dbus_cache_properties.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
+		self.gldi.cairo_dock_dbus_uncache_properties.argtypes = [ctypes.c_void_p, ctypes.c_char_p]
+		self.gldi.cairo_dock_dbus_get_property_as_int_with_timeout.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.c_char_p, ctypes.c_int]
+		self.glib.g_main_context_iteration.argtypes = [ctypes.c_void_p, ctypes.c_int]
+
+	def end(self):
+		if self.error == 0:
+			print('['+self.name+'] \033[32msuccess\033[m')
+		else:
+			print('['+self.name+'] \033[31merror\033[m')
+
+	def print_error(self,err):
+		print('['+self.name+'] '+err)
+		self.error = 1
+
+	def iterate(self, dt):  # let libgldi receive its replies and signals.
+		t = time() + dt
+		while time() < t:
+			while self.glib.g_main_context_iteration(None, 0):
+				pass
+			sleep(.01)
+
+	def get_value(self):
+		return self.gldi.cairo_dock_dbus_get_property_as_int_with_timeout(self.proxy, INTERFACE.encode(), b'Value', -1)
+
+	def get_stats(self):
+		cached = ctypes.c_uint(0)
+		uncached = ctypes.c_uint(0)
+		self.gldi.cairo_dock_dbus_get_properties_cache_stats(ctypes.byref(cached), ctypes.byref(uncached))
+		return cached.value, uncached.value
+
+	def set_value(self, value):  # from another client, like any other program would do.
+		import dbus
+		obj = dbus.SessionBus().get_object(SERVICE, OBJECT)
+		obj.Set(INTERFACE, 'Value', dbus.Int32(value), dbus_interface=dbus.PROPERTIES_IFACE)
+
+	def run(self):
+		if os.environ.get('DBUS_SESSION_BUS_ADDRESS') is None:
+			print('['+self.name+'] must be run under dbus-run-session')
+			return
+		service = start_service(1)
+
+		# cache the properties, and check that they are served without a call on the bus
+		self.proxy = self.gldi.cairo_dock_create_new_session_proxy(SERVICE.encode(), OBJECT.encode(), b'org.freedesktop.DBus.Properties')
+		self.gldi.cairo_dock_dbus_cache_properties(self.proxy, INTERFACE.encode())
+		self.iterate(.5)  # the properties are fetched asynchronously
+		cached, uncached = self.get_stats()
+		if self.get_value() != 1:
+			self.print_error ("Wrong cached value")
+		cached2, uncached2 = self.get_stats()
+		if cached2 != cached + 1 or uncached2 != uncached:
+			self.print_error ("The property was not read from the cache (%d/%d)" % (cached2 - cached, uncached2 - uncached))
+
+		# change the property from another client, and check that the cache follows it
+		self.set_value(2)
+		self.iterate(.5)
+		if self.get_value() != 2:
+			self.print_error ("The cache didn't follow the 'PropertiesChanged' signal")
+
+		# restart the service with another value, and check that the old value is not served any more
+		service.terminate()
+		service.wait()
+		self.iterate(.5)
+		service = start_service(3)
+		self.iterate(.5)
+		if self.get_value() != 3:
+			self.print_error ("The cache was not refreshed when the service restarted")
+		cached3, uncached3 = self.get_stats()
+		if uncached3 != uncached2:
+			self.print_error ("The refreshed property was not read from the cache")
+
+		self.gldi.cairo_dock_dbus_uncache_properties(self.proxy, INTERFACE.encode())
+		service.terminate()
+		service.wait()
+		self.end()
+
+
+if __name__ == '__main__':
+	if len(sys.argv) > 2 and sys.argv[1] == '--service':
+		run_service(int(sys.argv[2]))
+	else:
+		TestDBusPropertiesCache(sys.argv[1] if len(sys.argv) > 1 else 'libgldi.so.3').run()
@@ -0,0 +1,61 @@
+#!/usr/bin/env python
+#
+# Test of the picking of the icons of an OpenGL desklet (gldi_desklets_check_picking).
+# It doesn't need a running dock, it launches its own one in OpenGL mode on a temporary directory:
+#   python TestDeskletPicking.py [path to cairo-dock]
+#
+# The dock compares the analytic picking with the GL_SELECT one on a test desklet, for a set of
+# rotations, zooms and surface offsets, prints the result as a JSON object and quits.
+
+import sys  # argv
+import subprocess
+import tempfile
+import shutil
+import json
+
+# Test
+class TestDeskletPicking:
+	def __init__(self, cairo_dock):
+		self.name = "Test desklet picking"
+		self.error = 0
+		self.cairo_dock = cairo_dock
+
+	def end(self):
+		if self.error == 0:
+			print('['+self.name+'] \033[32msuccess\033[m')
+		else:
+			print('['+self.name+'] \033[31merror\033[m')
+
+	def print_error(self,err):
+		print('['+self.name+'] '+err)
+		self.error = 1
+
+	def run(self):
+		tmp_dir = tempfile.mkdtemp()
+		try:
+			p = subprocess.Popen([self.cairo_dock, '-o', '-T', '-d', tmp_dir, '--check-picking'], stdout=subprocess.PIPE, universal_newlines=True)
+			out, err = p.communicate()
+		finally:
+			shutil.rmtree(tmp_dir)
+
+		result = None
+		for line in out.splitlines():
+			if line.startswith('{"cases"'):
+				result = json.loads(line)
+		if result is None:
+			self.print_error ("No result (is OpenGL available ?)")
+		else:
+			if result['cases'] == 0 or result['points'] == 0:
+				self.print_error ("Nothing was tested")
+			if result['mismatches'] != 0:
+				self.print_error ("The pickers disagree on %d points out of %d" % (result['mismatches'], result['points']))
+			if result['boundary'] * 20 > result['points']:  # a few pixels on the edges of the icons at most
+				self.print_error ("Too many differences on the edges of the icons (%d)" % result['boundary'])
+		if p.returncode != (0 if result is not None and result['mismatches'] == 0 else 1):
+			self.print_error ("Wrong exit status (%d)" % p.returncode)
+
+		self.end()
+
+
+if __name__ == '__main__':
+	TestDeskletPicking(sys.argv[1] if len(sys.argv) > 1 else 'cairo-dock').run()
@@ -0,0 +1,89 @@
+#!/usr/bin/env python
+#
+# Test of the headless mode (--headless): the dock runs without X nor Wayland, on a Broadway server (broadwayd, from GTK).
+# It doesn't need a running dock nor a display, it launches its own Broadway server and docks on a temporary directory:
+#   python TestHeadless.py [path to cairo-dock]
+#
+# The dock takes a snapshot of the main dock, then benchmarks its views, as it would on a CI machine.
+
+import sys  # argv
+import os  # environ, path
+import subprocess
+import tempfile
+import shutil
+import struct
+import json
+from time import sleep
+
+BROADWAY_DISPLAY = ':7'  # arbitrary, so that it doesn't collide with an existing server.
+
+# Test
+class TestHeadless:
+	def __init__(self, cairo_dock):
+		self.name = "Test headless"
+		self.error = 0
+		self.cairo_dock = cairo_dock
+
+	def end(self):
+		if self.error == 0:
+			print('['+self.name+'] \033[32msuccess\033[m')
+		else:
+			print('['+self.name+'] \033[31merror\033[m')
+
+	def print_error(self,err):
+		print('['+self.name+'] '+err)
+		self.error = 1
+
+	def run_dock(self, tmp_dir, args):
+		env = dict(os.environ)
+		env.pop('DISPLAY', None)  # make sure neither X nor Wayland can be used.
+		env.pop('WAYLAND_DISPLAY', None)
+		env['BROADWAY_DISPLAY'] = BROADWAY_DISPLAY
+		p = subprocess.Popen([self.cairo_dock, '-H', '-T', '-d', tmp_dir] + args, stdout=subprocess.PIPE, universal_newlines=True, env=env)
+		out, err = p.communicate()
+		return p.returncode, out
+
+	def run(self):
+		tmp_dir = tempfile.mkdtemp()
+		try:
+			broadwayd = subprocess.Popen(['broadwayd', BROADWAY_DISPLAY])
+		except OSError:
+			self.print_error ("broadwayd is not installed")
+			self.end()
+			return
+		sleep(1)  # let it create its socket
+		try:
+			# snapshot of the main dock
+			png = os.path.join(tmp_dir, 'dock.png')
+			status, out = self.run_dock(tmp_dir, ['--snapshot', png])
+			if status != 0:
+				self.print_error ("The dock failed to run headless (%d)" % status)
+			elif not os.path.exists(png):
+				self.print_error ("No snapshot was taken")
+			else:
+				with open(png, 'rb') as f:
+					header = f.read(24)
+				width, height = struct.unpack('>II', header[16:24])  # IHDR chunk
+				print('[%s] snapshot: %dx%d' % (self.name, width, height))
+				if width == 0 or height == 0:
+					self.print_error ("The snapshot is empty")
+
+			# benchmark of the views, with cairo only
+			status, out = self.run_dock(tmp_dir, ['--benchmark-views', '20'])
+			frames = [json.loads(line) for line in out.splitlines() if line.startswith('{"renderer"')]
+			if len(frames) == 0:
+				self.print_error ("No view was benchmarked")
+			else:
+				print('[%s] %d frames benchmarked' % (self.name, len(frames)))
+				if any(frame['opengl'] is not None for frame in frames):
+					self.print_error ("OpenGL was used without display")
+		finally:
+			broadwayd.terminate()
+			broadwayd.wait()
+			shutil.rmtree(tmp_dir)
+
+		self.end()
+
+
+if __name__ == '__main__':
+	TestHeadless(sys.argv[1] if len(sys.argv) > 1 else 'cairo-dock').run()
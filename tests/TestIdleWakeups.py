@@ -0,0 +1,54 @@
+from time import sleep
+import os  # system, listdir
+import subprocess
+from Test import Test, key, set_param
+from CairoDock import CairoDock
+
+# test that an auto-hidden dock doesn't wake up when the pointer doesn't move
+class TestIdleWakeups(Test):
+	def __init__(self, dock):
+		self.mgr = 'Docks'
+		self.dt = 10  # duration of the measure, in s
+		self.polling_rate = 1000. / 150  # wake-ups per second of the screen-edge polling (MOUSE_POLLING_DT)
+		Test.__init__(self, "Test idle wake-ups", dock)
+
+	def count_wakeups(self, pid):  # sum of the voluntary context switches of all the threads, i.e. the times they went back to sleep.
+		n = 0
+		for tid in os.listdir('/proc/%d/task' % pid):
+			with open('/proc/%d/task/%s/status' % (pid, tid)) as f:
+				for line in f:
+					if line.startswith('voluntary_ctxt_switches'):
+						n += int(line.split()[1])
+		return n
+
+	def run(self):
+
+		pid = int(subprocess.check_output(['pidof', '-s', 'cairo-dock']))
+
+		# auto-hide the main dock, and leave the pointer in the middle of the screen
+		set_param (self.get_conf_file(), "Accessibility", "visibility", "5")  # from 'hide on overlap any' to 'auto-hide'
+		self.d.Reload('type=Manager & name='+self.mgr)
+		os.system ("xdotool mousemove --polar 0 0")  # center of the screen
+		sleep(3)  # let the dock hide, and the polling stop
+		height_hidden = self.d.GetProperties('type=Dock')[0]['height']
+
+		# count the wake-ups while nothing happens
+		n0 = self.count_wakeups(pid)
+		sleep(self.dt)
+		rate = float(self.count_wakeups(pid) - n0) / self.dt
+		print ('[%s] %.1f wake-ups/s while idle (the polling alone does %.1f/s)' % (self.name, rate, self.polling_rate))
+		if rate > self.polling_rate / 2:
+			self.print_error ('The dock keeps waking up while the pointer is idle (is XInput2 available ?)')
+
+		# move the pointer to the bottom edge, and check that the dock still appears
+		os.system ("xdotool mousemove --polar 180 10000")  # bottom of the screen
+		sleep(2)  # the unhide delay
+		props = self.d.GetProperties('type=Dock')
+		if props[0]['height'] <= height_hidden:
+			self.print_error ('The dock did not appear when the pointer reached the edge')
+		os.system ("xdotool mousemove --polar 0 0")
+
+		set_param (self.get_conf_file(), "Accessibility", "visibility", "4")  # back to normal
+		self.d.Reload('type=Manager & name='+self.mgr)
+
+		self.end()
@@ -0,0 +1,71 @@
+#!/usr/bin/env python
+#
+# Measure of the time to the first frame of the main dock, with the launchers loaded serially and in parallel.
+# It doesn't need a running dock, it launches its own ones on a temporary directory (with the default theme):
+#   python TestTimeToFirstFrame.py [path to cairo-dock]
+#
+# Each dock prints the number of launchers, the time it took to load them and the time from its launch
+# to its first frame as a JSON object, and quits.
+
+import sys  # argv
+import subprocess
+import tempfile
+import shutil
+import json
+
+RUNS = 5  # the best time of several runs is kept, the first one also fills the disk cache.
+
+# Test
+class TestTimeToFirstFrame:
+	def __init__(self, cairo_dock):
+		self.name = "Test time to first frame"
+		self.error = 0
+		self.cairo_dock = cairo_dock
+
+	def end(self):
+		if self.error == 0:
+			print('['+self.name+'] \033[32msuccess\033[m')
+		else:
+			print('['+self.name+'] \033[31merror\033[m')
+
+	def print_error(self,err):
+		print('['+self.name+'] '+err)
+		self.error = 1
+
+	def measure(self, tmp_dir, threads):
+		best = None
+		for i in range(RUNS):
+			p = subprocess.Popen([self.cairo_dock, '-T', '-d', tmp_dir, '--time-to-first-frame', str(threads)], stdout=subprocess.PIPE, universal_newlines=True)
+			out, err = p.communicate()
+			for line in out.splitlines():
+				if line.startswith('{"launchers"'):
+					result = json.loads(line)
+					if best is None or result['first_frame_ms'] < best['first_frame_ms']:
+						best = result
+		return best
+
+	def run(self):
+		tmp_dir = tempfile.mkdtemp()
+		try:
+			serial = self.measure(tmp_dir, 1)
+			parallel = self.measure(tmp_dir, 4)
+		finally:
+			shutil.rmtree(tmp_dir)
+
+		if serial is None or parallel is None:
+			self.print_error ("No result")
+		else:
+			for result in (serial, parallel):
+				print('[%s] %d launchers, %d thread(s): launchers loaded in %.1fms, first frame after %.1fms' % (self.name, result['launchers'], result['threads'], result['launchers_ms'], result['first_frame_ms']))
+			if serial['launchers'] == 0:
+				self.print_error ("No launcher was loaded")
+			if serial['launchers'] != parallel['launchers']:
+				self.print_error ("The launchers are not the same (%d / %d)" % (serial['launchers'], parallel['launchers']))
+			if parallel['threads'] > 1 and parallel['launchers_ms'] > serial['launchers_ms'] * 1.2:  # some margin for the noise
+				self.print_error ("Loading the launchers in parallel is slower")
+
+		self.end()
+
+
+if __name__ == '__main__':
+	TestTimeToFirstFrame(sys.argv[1] if len(sys.argv) > 1 else 'cairo-dock').run()
@@ -6,9 +6,13 @@
 #   unset DESKTOP_SESSION
 #   cairo-dock -T -d ~/test
 #
-# They also require 'xdotool'
+# They also require 'xdotool' (and 'pidof' for TestIdleWakeups)
 #
 # Usage: ./main.y [name of a test]
+# (TestDBusPropertiesCache.py doesn't need a running dock and is run on its own, under dbus-run-session)
+# (TestDeskletPicking.py launches its own dock in OpenGL mode, and is run on its own too)
+# (TestTimeToFirstFrame.py launches its own docks too, and is run on its own)
+# (TestHeadless.py launches its own Broadway server and docks, without display, and is run on its own)
 # In 'config.py', you can adjust some variables to fit your environment
 
 import sys  # argv
@@ -23,6 +27,7 @@ from TestStackIcon import TestStackIcon
 from TestTaskbar import TestTaskbar, TestTaskbar2
 from TestIconManager import TestIconManager
 from TestDesklet import TestDesklet
+from TestIdleWakeups import TestIdleWakeups
 
 from CairoDock import CairoDock
 dock = CairoDock()
@@ -54,6 +59,8 @@ if __name__ == '__main__':
 			TestIconManager(dock).run()
 		elif sys.argv[1] == "TestDesklet":
 			TestDesklet(dock).run()
+		elif sys.argv[1] == "TestIdleWakeups":
+			TestIdleWakeups(dock).run()
 		else:
 			print ("Unknown test")
 	else:  # run them all
@@ -69,4 +76,5 @@ if __name__ == '__main__':
 		TestDockManager(dock).run()
 		TestIconManager(dock).run()
 		TestDesklet(dock).run()
+		TestIdleWakeups(dock).run()
 	